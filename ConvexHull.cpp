@@ -1,26 +1,44 @@
 #include "ConvexHull.hpp"
 
-#include <algorithm>
-#include <queue>
 #include <chrono>
 
 #include "CustomVertex.hpp"
 
-ConvexHull::ConvexHull(IDirect3DVertexBuffer9* vertexBuffer)
-    : origineVertices(), faces()
+ConvexHull::ConvexHull(IDirect3DVertexBuffer9* vertexBuffer, hull::HullCache* cache_)
+    : origineVertices(), hull()
     , line(std::make_unique<LineSegment>())
     , point(std::make_unique<Point>())
-    , createTask()
+    , createJob()
+    , createStart()
     , isCompleted(false)
+    , cache(cache_)
+    , cacheKey()
 {
     this->GetVerticesFromBuffer(vertexBuffer);
-    std::thread thread(&ConvexHull::CreateConvexHull, this);
-    this->createTask.swap(thread);
+
+    // point passes on every core, give up after 10s
+    hull::BuildOptions options;
+    options.threadCount = 0;
+
+    this->createStart = std::chrono::steady_clock::now();
+    if (this->cache)
+    {
+        this->cacheKey = hull::HashHullInput(this->origineVertices, options);
+        if (this->cache->Load(this->cacheKey, this->hull))
+        {
+            this->isCompleted = true;
+            OutputDebugFormat("\n  face num :  {} (cached)", this->hull.FaceCount());
+            return;
+        }
+    }
+
+    this->createJob = hull::HullJob(this->origineVertices, options, this->createStart + std::chrono::seconds(10));
 }
 
 ConvexHull::~ConvexHull()
 {
-    this->createTask.join();
+    // a running build is cancelled, its pool task finishes on its own
+    this->createJob.Cancel();
     OUTPUT_DEBUG_FUNCNAME;
 }
 
@@ -53,21 +71,10 @@ bool ConvexHull::GetVerticesFromBuffer(IDirect3DVertexBuffer9* pInVertexBuffer)
     unsigned vertexNum = verticesSize / vertexSize;
 
     void* ppbdata;
-    if (SUCCEEDED(pInVertexBuffer->Lock(0, verticesSize, &ppbdata, 0)))
+    if (SUCCEEDED(pInVertexBuffer->Lock(0, verticesSize, &ppbdata, D3DLOCK_READONLY)))
     {
-        this->origineVertices.reserve(vertexNum);
-
-        D3DXVECTOR3 tempVertex;
-
-        BYTE* ppb = reinterpret_cast<BYTE*>(ppbdata);
-
-        for (int i = 0; i < vertexNum; ++i)
-        {
-            memcpy(&tempVertex, ((ppb)+offset), sizeof(tempVertex));
-            this->origineVertices.push_back(tempVertex);
-
-            ppb += vertexSize;
-        }
+        // positions straight from the locked buffer (the build job needs its own copy, the lock is released here)
+        hull::PointsView(ppbdata, vertexNum, vertexSize, offset).CopyTo(this->origineVertices);
 
         pInVertexBuffer->Unlock();
     }
@@ -78,285 +85,64 @@ bool ConvexHull::GetVerticesFromBuffer(IDirect3DVertexBuffer9* pInVertexBuffer)
     return true;
 }
 
-bool ConvexHull::CreateConvexHull()
+bool ConvexHull::FetchHull()
 {
-    if (this->origineVertices.size() < 4) return false;
-
-    auto start = std::chrono::system_clock::now();
-
-    std::vector<D3DXVECTOR3> vertices(this->origineVertices);
-
-    ///////////////////////////////////////////////////////////
-    // function objects
-
-    // signed volume of tetraahedron
-    auto CalcSignedTetrahedronVolume = [](const D3DXVECTOR3& a, const D3DXVECTOR3& b, const D3DXVECTOR3& c, const D3DXVECTOR3& d)
-    {
-        D3DXVECTOR3 ab = b - a;
-        D3DXVECTOR3 ac = c - a;
-        D3DXVECTOR3 ad = d - a;
-        D3DXVECTOR3 cross(0, 0, 0);
-        D3DXVec3Cross(&cross, &ab, &ac);
-
-        return (/*abs*/(D3DXVec3Dot(&cross, &ad)) / 6.0f);
-    };
-
-    // remove points in tetrahedron
-    auto RemovePointInsideTetrahedron = [&CalcSignedTetrahedronVolume](const std::vector<D3DXVECTOR3>& points, const D3DXVECTOR3& a, const D3DXVECTOR3& b, const D3DXVECTOR3& c, const D3DXVECTOR3& d)
-    {
-        std::vector<D3DXVECTOR3> newPoints;
-        for (auto& point : points)
-        {
-            if (point == a || point == b || point == c || point == d) continue;
-            float v  = abs( CalcSignedTetrahedronVolume(a, b, c, d) );
-            float v1 = abs( CalcSignedTetrahedronVolume(a, b, c, point) );
-            float v2 = abs( CalcSignedTetrahedronVolume(d, b, a, point) );
-            float v3 = abs( CalcSignedTetrahedronVolume(d, c, b, point) );
-            float v4 = abs( CalcSignedTetrahedronVolume(d, a, c, point) );
-
-            if ((v1 + v2 + v3 + v4) - v > 0)
-            {
-                newPoints.push_back(point);
-            }
-        }
-        return newPoints;
-    };
-
-    // find furthest point above triangler face
-    // return : furthest point (if not found return { FLT_MAX, FLT_MAX, FLT_MAX } )
-    auto CalcFurthestPoint = [&CalcSignedTetrahedronVolume](const std::vector<D3DXVECTOR3>& points, const Face& face)
-    {
-        //OutputDebugFormat("\n pointnum : {}", points.size());
-        float maxSignedVolume = -FLT_EPSILON;
-        D3DXVECTOR3 farPoint(0, 0, 0);
-        for (auto& point : points)
-        {
-            if (point == face.a || point == face.b || point == face.c) continue;
-            float signedVolume = CalcSignedTetrahedronVolume(face.a, face.b, face.c, point);
-
-            if (signedVolume > maxSignedVolume)
-            {
-                maxSignedVolume = signedVolume;
-                farPoint = point;
-            }
-        }
-
-        if (maxSignedVolume < 0)
-        {
-            farPoint = { FLT_MAX, FLT_MAX, FLT_MAX };
-        }
-
-        return farPoint;
-    };
-
-    // remove points under face
-    auto RemovePointsUnderFace = [&CalcSignedTetrahedronVolume](const std::vector<D3DXVECTOR3>& points, const Face& face)
-    {
-        std::vector<D3DXVECTOR3> newPoints;
-        for (auto& point : points)
-        {
-            if (point == face.a || point == face.b || point == face.c) continue;
-
-            if (0 <= CalcSignedTetrahedronVolume(face.a, face.b, face.c, point))
-                newPoints.push_back(point);
-        }
-
-        return newPoints;
-    };
-
-
-    ///////////////////////////////////////////////////////////
-    // first tetrahedron
-
-    // Find min and max point
-    D3DXVECTOR3 min = vertices.front();
-    D3DXVECTOR3 max = min;
-
-    for (size_t i = 1; i < vertices.size(); ++i)
-    {
-        bool minConditions =
-            vertices[i].x < min.x
-            || ((vertices[i].x == min.x)
-                && ((vertices[i].y < min.y)
-                    || (vertices[i].y == min.y && vertices[i].z < min.z)));
-        if (minConditions)
-        {
-            min = vertices[i];
-        }
-
-        bool maxConditions =
-            vertices[i].x > max.x
-            || ((vertices[i].x == max.x)
-                && ((vertices[i].y > max.y)
-                    || (vertices[i].y == max.y && vertices[i].z > max.z)));
+    if (this->isCompleted) return true;
+    if (!this->createJob.IsDone()) return false;
 
-        if (maxConditions)
-        {
-            max = vertices[i];
-        }
-    }
-
-    // Find furthest point from segment(min, max)
-    float maxLenSq = FLT_MIN;
-    D3DXVECTOR3 far1(0, 0, 0);
-    for (auto& vertex : vertices)
-    {
-        D3DXVECTOR3 vec1 = min - max;
-        D3DXVec3Normalize(&vec1, &vec1);
-        D3DXVECTOR3 vec2 = vertex - max;
-        float vec1Len = D3DXVec3Dot(&vec1, &vec2);
-        float vec2LenSq = D3DXVec3LengthSq(&vec2);
-        float lenSq = vec2LenSq - vec1Len * vec1Len;
-        if (lenSq > maxLenSq)
-        {
-            maxLenSq = lenSq;
-            far1 = vertex;
-        }
-    }
-
-    // Find furthest point from Triangle(min, max, far1)
-    float maxSignedVolume = 0;
-    D3DXVECTOR3 far2(1,0,0);
-    for (auto& vertex : vertices)
-    {
-        float signedVolume = CalcSignedTetrahedronVolume(min, max, far1, vertex);
-        if (abs(signedVolume) >= abs(maxSignedVolume))
-        {
-            maxSignedVolume = signedVolume;
-            far2 = vertex;
-        }
-    }
-    if (maxSignedVolume > 0)
-    {
-        std::swap(min, max);
-    }
+    hull::HullJobResult result = this->createJob.Result().get();
+    this->isCompleted = true;
 
-    // pending
-    D3DXVECTOR3 overlapCheck[4] = { min, max, far1, far2 };
-    for (int i = 0; i < 4; ++i)
+    if (!result.succeeded)
     {
-        for (int j = 0; j < 4; ++j)
-        {
-            if (i == j)continue;
-            if (overlapCheck[i] == overlapCheck[j])
-            {
-                OutputDebugFormat("\n\n ***************ERROR*************** \n\n");
-                return false;
-            }
-        }
+        OutputDebugFormat("\n\n **********************ERROR ({})*******************\n\n", hull::ToString(result.stats.status));
+        return true;
     }
 
-    OutputDebugFormat("\n     min : {:.2f}, {:.2f}, {:.2f}", min.x, min.y, min.z);
-    OutputDebugFormat("\n     max : {:.2f}, {:.2f}, {:.2f}", max.x, max.y, max.z);
-    OutputDebugFormat("\n     far1 : {:.2f}, {:.2f}, {:.2f}", far1.x, far1.y, far1.z);
-    OutputDebugFormat("\n     far2 : {:.2f}, {:.2f}, {:.2f}", far2.x, far2.y, far2.z);
+    this->hull = std::move(result.hull);
+    if (this->cache) this->cache->Store(this->cacheKey, this->hull);
 
-    // Remove points in tetrahedron
-    vertices = RemovePointInsideTetrahedron(vertices, min, max, far1, far2);
+    OutputDebugFormat("\n  face num :  {}", this->hull.FaceCount());
 
-    this->faces.push_back({ min, max, far1 } );
-    this->faces.push_back({ max, min, far2 } );
-    this->faces.push_back({ far1, max, far2 });
-    this->faces.push_back({ far1, far2, min });
+    OutputDebugFormat("\n\n elapsed : {} ms.\n\n", std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - this->createStart).count());
 
-    std::queue<Face> face_queue;
-    face_queue.push({ min, max, far1 } );
-    face_queue.push({ max, min, far2 } );
-    face_queue.push({ far1, max, far2 });
-    face_queue.push({ far1, far2, min });
+    return true;
+}
 
-    ///////////////////////////////////////////////////////////
-    // loop
 
-    while (!vertices.empty() && !face_queue.empty())
-    {
-        // 10s elapsed
-        if (10000 < std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start).count())
-        {
-            OutputDebugFormat("\n\n **********************ERROR*******************\n\n");
-            return false;
-        }
+const hull::SupportMap* ConvexHull::GetSupportMap()
+{
+    if (!this->FetchHull() || this->hull.vertices.empty()) return nullptr;
 
-        Face face = face_queue.front();
-        face_queue.pop();
+    if (this->supportMap.VertexCount() == 0) this->supportMap.Build(this->hull);
+    return &this->supportMap;
+}
 
-        std::vector<D3DXVECTOR3> upperSidePoints = RemovePointsUnderFace(vertices, face);
-        auto furthest = CalcFurthestPoint(upperSidePoints, face);
-        if (furthest == D3DXVECTOR3(FLT_MAX, FLT_MAX, FLT_MAX)) continue;
 
-        std::vector<Face> invisibleFaces;
-        std::vector<Face> visibleFaces;
+const hull::PlaneSet* ConvexHull::GetPlaneSet()
+{
+    if (!this->FetchHull() || this->hull.FaceCount() == 0) return nullptr;
 
-        for (auto& face : this->faces)
-        {
-            // 10s elapsed
-            if (10000 < std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start).count())
-            {
-                OutputDebugFormat("\n\n **********************ERROR*******************\n\n");
-                return false;
-            }
-
-            float signedVolume = CalcSignedTetrahedronVolume(face.a, face.b, face.c, furthest);
-            if (signedVolume <= 0)
-            {
-                invisibleFaces.push_back(face);
-            }
-            else
-            {
-                visibleFaces.push_back(face);
-            }
-        }
+    if (this->planeSet.PlaneCount() == 0) this->planeSet.Build(this->hull);
+    return &this->planeSet;
+}
 
-        this->faces = invisibleFaces;
 
-        for (auto& visibleFace : visibleFaces)
-        {
-            // 10s elapsed
-            if (10000 < std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start).count())
-            {
-                OutputDebugFormat("\n\n **********************ERROR*******************\n\n");
-                return false;
-            }
-
-            // remove inner points
-            vertices = RemovePointInsideTetrahedron(vertices, visibleFace.a, visibleFace.b, visibleFace.c, furthest);
-
-            // create new faces
-            for (auto& invisibleFace : invisibleFaces)
-            {
-                // 10s elapsed
-                if (10000 < std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start).count())
-                {
-                    OutputDebugFormat("\n\n **********************ERROR*******************\n\n");
-                    return false;
-                }
-
-                auto [isSharing, shareP1, shareP2] = visibleFace.IsShareEdge(invisibleFace, true);
-                if (isSharing)
-                {
-                    D3DXVECTOR3 v1 = furthest - shareP1;
-                    D3DXVECTOR3 v2 = furthest - shareP2;
-
-                    D3DXVec3Normalize(&v1, &v1);
-                    D3DXVec3Normalize(&v2, &v2);
-
-                    if (1 - abs(D3DXVec3Dot(&v1, &v2)) <= FLT_EPSILON) continue;
-
-                    Face newFace = { shareP1, shareP2, furthest };
-                    this->faces.push_back(newFace);
-                    face_queue.push(newFace);
-                }
-            }
-        }
-    }
+const hull::DistanceMap* ConvexHull::GetDistanceMap()
+{
+    if (!this->FetchHull() || this->hull.FaceCount() == 0) return nullptr;
 
-    OutputDebugFormat("\n  face num :  {}", faces.size());
+    if (this->distanceMap.FaceCount() == 0) this->distanceMap.Build(this->hull);
+    return &this->distanceMap;
+}
 
-    OutputDebugFormat("\n\n elapsed : {} ms.\n\n", std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start).count());
 
-    this->isCompleted = true;
+const hull::MassProperties* ConvexHull::GetMassProperties()
+{
+    if (!this->FetchHull() || this->hull.FaceCount() == 0) return nullptr;
 
-    return true;
+    if (this->massProperties.volume == 0 && !hull::ComputeMassProperties(this->hull, this->massProperties)) return nullptr;
+    return &this->massProperties;
 }
 
 
@@ -373,28 +159,36 @@ void ConvexHull::Render()
 #endif
 
 
-    if (!this->isCompleted) return;
+    if (!this->FetchHull()) return;
+
+    const hull::PlaneSet* planes = this->GetPlaneSet();
 
 #if 1
-    for (size_t i = 0; i < this->faces.size(); ++i)
+    for (size_t i = 0; i < this->hull.FaceCount(); ++i)
     {
-        Face face = this->faces[i];
-
-        this->line->SetStartEnd(&face.a, &face.b);
+        const hull::Vec3& va = this->hull.vertices[this->hull.indices[i * 3 + 0]];
+        const hull::Vec3& vb = this->hull.vertices[this->hull.indices[i * 3 + 1]];
+        const hull::Vec3& vc = this->hull.vertices[this->hull.indices[i * 3 + 2]];
+        D3DXVECTOR3 a(va.x, va.y, va.z);
+        D3DXVECTOR3 b(vb.x, vb.y, vb.z);
+        D3DXVECTOR3 c(vc.x, vc.y, vc.z);
+
+        this->line->SetStartEnd(&a, &b);
         this->line->Render();
-        this->line->SetStartEnd(&face.b, &face.c);
+        this->line->SetStartEnd(&b, &c);
         this->line->Render();
-        this->line->SetStartEnd(&face.c, &face.a);
+        this->line->SetStartEnd(&c, &a);
         this->line->Render();
 
         // render normal
-        if (GetKeyState('N') < 0)
+        if (planes && GetKeyState('N') < 0)
         {
-            D3DXVECTOR3 center = (face.a + face.b + face.c) / 3.0f;
-            D3DXVECTOR3 end = center + face.CalcNormal() * 0.05f;
+            hull::Vec3 normal = planes->GetPlane(i).normal;
+            D3DXVECTOR3 center = (a + b + c) / 3.0f;
+            D3DXVECTOR3 end = center + D3DXVECTOR3(normal.x, normal.y, normal.z) * 0.05f;
             this->line->SetStartEnd(&center, &end);
             this->line->Render();
-            D3DXVECTOR3 ab = face.b - face.a;
+            D3DXVECTOR3 ab = b - a;
             D3DXVec3Normalize(&ab, &ab);
             ab *= 0.01f;
             ab += end;
@@ -1,19 +1,24 @@
 #pragma once
 
-#include <compare>
+#include <chrono>
 #include <vector>
-#include <thread>
+#include "DistanceMap.hpp"
 #include "DX9.hpp"
+#include "HullCache.hpp"
+#include "HullCore.hpp"
+#include "HullJob.hpp"
 #include "LineSegment.hpp"
+#include "MassProperties.hpp"
+#include "PlaneSet.hpp"
 #include "Point.hpp"
-
-struct Face;
+#include "SupportMap.hpp"
 
 class ConvexHull
 {
 public:
 
-	ConvexHull(IDirect3DVertexBuffer9* vertexBuffer);
+	// cache (optional) must outlive the ConvexHull
+	ConvexHull(IDirect3DVertexBuffer9* vertexBuffer, hull::HullCache* cache = nullptr);
 	~ConvexHull();
 
 
@@ -22,96 +27,61 @@ private:
 	// fetch vertices from vertexBuffer
 	bool GetVerticesFromBuffer(IDirect3DVertexBuffer9* vertexBuffer);
 
-	// create convex hull from vertices
-	bool CreateConvexHull();
+	// take the job result once it is done (render thread only)
+	// return : true if the hull is available
+	bool FetchHull();
 
 
 public:
 	void Render();
 
+	// support queries on the hull (built on first use, render thread only)
+	// return : null until the hull is available
+	const hull::SupportMap* GetSupportMap();
+
+	// face planes of the hull for point-in-hull queries (plane i : face i, built on first use, render thread only)
+	// return : null until the hull is available
+	const hull::PlaneSet* GetPlaneSet();
+
+	// closest point queries on the hull (built on first use, render thread only)
+	// return : null until the hull is available
+	const hull::DistanceMap* GetDistanceMap();
+
+	// volume, centroid and inertia tensor of the hull at unit density (computed on first use, render thread only)
+	// return : null until the hull is available, or if it encloses no volume
+	const hull::MassProperties* GetMassProperties();
+
 private:
 
 	//
-	std::vector<D3DXVECTOR3> origineVertices;
-	std::vector<Face> faces;
+	std::vector<hull::Vec3> origineVertices;
+	hull::Hull hull;
+
+	// built from hull by GetSupportMap
+	hull::SupportMap supportMap;
+
+	// built from hull by GetPlaneSet
+	hull::PlaneSet planeSet;
+
+	// built from hull by GetDistanceMap
+	hull::DistanceMap distanceMap;
+
+	// computed from hull by GetMassProperties (volume 0 : not yet)
+	hull::MassProperties massProperties;
 
 	// use draw
 	std::unique_ptr<LineSegment> line;
 	std::unique_ptr<Point> point;
 
-	std::thread createTask;
+	// asynchronous build of hull (task of the shared hull pool)
+	hull::HullJob createJob;
+	std::chrono::steady_clock::time_point createStart;
 
-	// creation completed?
+	// hull taken from createJob or the cache? (render thread only)
 	bool isCompleted;
 
-};
+	// a built hull is stored under cacheKey
+	hull::HullCache* cache;
+	hull::HullKey cacheKey;
 
-// tri
-struct Face
-{
-	// a -> b -> c : clockwise
-	D3DXVECTOR3 a, b, c;
-
-	// @
-	D3DXVECTOR3 CalcNormal()
-	{
-		D3DXVECTOR3 ab = b - a;
-		D3DXVECTOR3 ac = c - a;
-		D3DXVECTOR3 cross(0,0,0);
-		D3DXVec3Cross(&cross, &ab, &ac);
-		D3DXVec3Normalize(&cross, &cross);
-		return cross;
-	}
-
-	//std::strong_ordering operator <=> (const Face&) const = default;
-
-	bool operator == (const Face& face_) const
-	{
-		if (this->a == face_.a && this->b == face_.b && this->c == face_.c) return true;
-		if (this->a == face_.b && this->b == face_.c && this->c == face_.a) return true;
-		if (this->a == face_.c && this->b == face_.a && this->c == face_.b) return true;
-		return false;
-	}
-
-	bool operator != (const Face& face_) const
-	{
-		return !(*this == face_);
-	}
-
-	// return :
-	// 1. sharing?
-	// 2. sharing point 1
-	// 3. sharing point 2
-	std::tuple<bool, D3DXVECTOR3, D3DXVECTOR3> IsShareEdge(const Face& face, bool temp) const
-	{
-		if (this->a == face.a)
-		{
-			if (this->b == face.b) return {true, this->a, this->b };
-			else if (this->b == face.c) return {true, this->a, this->b };
-			else if (this->c == face.b) return {true, this->c, this->a };
-			else if (this->c == face.c) return {true, this->c, this->a };
-		}
-		else if (this->a == face.b)
-		{
-			if (this->b == face.a) return {true, this->a, this->b };
-			else if (this->b == face.c) return {true, this->a, this->b };
-			else if (this->c == face.a) return {true, this->c, this->a };
-			else if (this->c == face.c) return {true, this->c, this->a };
-		}
-		else if (this->a == face.c)
-		{
-			if (this->b == face.b) return {true, this->a, this->b };
-			else if (this->b == face.a) return {true, this->a, this->b };
-			else if (this->c == face.b) return {true, this->c, this->a };
-			else if (this->c == face.a) return {true, this->c, this->a };
-		}
-		else if(this->c == face.a || this->c == face.b || this->c == face.c)
-		{
-			if (this->b == face.a)      return {true, this->b, this->c };
-			else if (this->b == face.b) return {true, this->b, this->c };
-			else if (this->b == face.c) return {true, this->b, this->c };
-		}
-
-		return { false, {0,0,0}, {0,0,0} };
-	}
 };
\ No newline at end of file
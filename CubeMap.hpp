@@ -0,0 +1,48 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "Vec3.hpp"
+
+namespace hull
+{
+	// direction cells : 6 cube sides of resolution^2 cells each
+
+	// return : cell of direction d (0 for zero or nan directions)
+	// selects instead of branches : random directions would mispredict the side
+	inline size_t CubeMapCell(const Vec3& d, int resolution)
+	{
+		float ax = std::abs(d.x), ay = std::abs(d.y), az = std::abs(d.z);
+		bool xMajor = ax >= ay && ax >= az;
+		bool yMajor = !xMajor && ay >= az;
+		float major = xMajor ? ax : yMajor ? ay : az;
+		float axis = xMajor ? d.x : yMajor ? d.y : d.z;
+		float u = xMajor ? d.y : yMajor ? d.z : d.x;
+		float v = xMajor ? d.z : yMajor ? d.x : d.y;
+		int side = (xMajor ? 0 : yMajor ? 2 : 4) + (axis >= 0 ? 0 : 1);
+		if (!(major > 0)) return 0;
+
+		float scale = 0.5f * resolution / major;
+		float half = 0.5f * resolution;
+		int cu = std::clamp(static_cast<int>(u * scale + half), 0, resolution - 1);
+		int cv = std::clamp(static_cast<int>(v * scale + half), 0, resolution - 1);
+		return (size_t(side) * resolution + cu) * resolution + cv;
+	}
+
+	// return : direction through the center of cell (not normalized)
+	inline Vec3 CubeMapDirection(size_t cell, int resolution)
+	{
+		int side = static_cast<int>(cell / (size_t(resolution) * resolution));
+		float u = (static_cast<float>(cell / resolution % resolution) + 0.5f) * 2.0f / resolution - 1.0f;
+		float v = (static_cast<float>(cell % resolution) + 0.5f) * 2.0f / resolution - 1.0f;
+		float major = side % 2 == 0 ? 1.0f : -1.0f;
+		switch (side / 2)
+		{
+		case 0:  return { major, u, v };
+		case 1:  return { v, major, u };
+		default: return { u, v, major };
+		}
+	}
+}
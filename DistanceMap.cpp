@@ -0,0 +1,188 @@
+#include "DistanceMap.hpp"
+
+#include <cmath>
+
+#include "HalfEdgeMesh.hpp"
+
+namespace hull
+{
+
+void DistanceMap::Build(const Hull& hull)
+{
+    this->Clear();
+
+    this->vertices = hull.vertices;
+    this->indices = hull.indices;
+
+    size_t faceCount = hull.FaceCount();
+    for (std::vector<float>* values : { &this->nx, &this->ny, &this->nz, &this->offset, &this->ax, &this->ay, &this->az, &this->abx, &this->aby, &this->abz,
+        &this->acx, &this->acy, &this->acz, &this->abab, &this->abac, &this->acac })
+    {
+        values->resize(faceCount);
+    }
+
+    for (size_t face = 0; face < faceCount; ++face)
+    {
+        Plane plane = hull.FacePlane(face);
+        this->nx[face] = plane.normal.x;
+        this->ny[face] = plane.normal.y;
+        this->nz[face] = plane.normal.z;
+        this->offset[face] = plane.offset;
+
+        const Vec3& a = hull.vertices[hull.indices[3 * face]];
+        Vec3 ab = hull.vertices[hull.indices[3 * face + 1]] - a;
+        Vec3 ac = hull.vertices[hull.indices[3 * face + 2]] - a;
+        this->ax[face] = a.x;
+        this->ay[face] = a.y;
+        this->az[face] = a.z;
+        this->abx[face] = ab.x;
+        this->aby[face] = ab.y;
+        this->abz[face] = ab.z;
+        this->acx[face] = ac.x;
+        this->acy[face] = ac.y;
+        this->acz[face] = ac.z;
+        this->abab[face] = Dot(ab, ab);
+        this->abac[face] = Dot(ab, ac);
+        this->acac[face] = Dot(ac, ac);
+    }
+
+    // walks need a closed mesh
+    if (!BuildTwins(hull, this->twins)) this->twins.clear();
+}
+
+void DistanceMap::Clear()
+{
+    this->vertices.clear();
+    this->indices.clear();
+    this->twins.clear();
+    for (std::vector<float>* values : { &this->nx, &this->ny, &this->nz, &this->offset, &this->ax, &this->ay, &this->az, &this->abx, &this->aby, &this->abz,
+        &this->acx, &this->acy, &this->acz, &this->abab, &this->abac, &this->acac })
+    {
+        values->clear();
+    }
+}
+
+Vec3 DistanceMap::ClosestOnFace(uint32_t face, const Vec3& point, unsigned& corners) const
+{
+    const uint32_t* corner = &this->indices[3 * size_t(face)];
+    return ClosestPointOnTriangle(point, this->vertices[corner[0]], this->vertices[corner[1]], this->vertices[corner[2]], corners);
+}
+
+SurfacePoint DistanceMap::Closest(const Vec3& point) const
+{
+    if (this->offset.empty()) return { point, INFINITY, NO_START };
+
+    // inside every plane : the nearest plane holds the closest point (its projection lies in that face)
+    PlanesSoA planes = { this->nx.data(), this->ny.data(), this->nz.data(), this->offset.data(), this->FaceCount() };
+    float maxDistance;
+    uint32_t face = static_cast<uint32_t>(ArgMaxPlaneDistance(planes, point, &maxDistance));
+    if (!(maxDistance > 0))
+    {
+        Vec3 normal = { this->nx[face], this->ny[face], this->nz[face] };
+        return { point - normal * maxDistance, maxDistance, face };
+    }
+
+    TrianglesSoA triangles = { this->ax.data(), this->ay.data(), this->az.data(), this->abx.data(), this->aby.data(), this->abz.data(),
+        this->acx.data(), this->acy.data(), this->acz.data(), this->abab.data(), this->abac.data(), this->acac.data(), this->FaceCount() };
+    float distanceSq;
+    face = static_cast<uint32_t>(NearestTriangle(triangles, point, &distanceSq));
+
+    unsigned corners;
+    Vec3 closest = this->ClosestOnFace(face, point, corners);
+    return { closest, Length(closest - point), face };
+}
+
+// outside the hull the faces point is in front of form one patch, and over it the distance to point has no local minimum but the
+// closest point (every sublevel set is seen from point through a convex cone) : climb onto the patch, then descend across the
+// edge or around the vertex the closest point of the current face lies on
+SurfacePoint DistanceMap::Closest(const Vec3& point, uint32_t& start) const
+{
+    if (start >= this->FaceCount() || this->twins.empty())
+    {
+        SurfacePoint result = this->Closest(point);
+        start = result.face;
+        return result;
+    }
+
+    // steepest ascent of the plane distance until point is in front of the face
+    uint32_t face = start;
+    float distance = this->PlaneDistance(face, point);
+    while (!(distance > 0))
+    {
+        uint32_t next = face;
+        for (uint32_t edge = 3 * face; edge < 3 * face + 3; ++edge)
+        {
+            uint32_t neighbour = this->twins[edge] / 3;
+            float neighbourDistance = this->PlaneDistance(neighbour, point);
+            if (neighbourDistance > distance)
+            {
+                distance = neighbourDistance;
+                next = neighbour;
+            }
+        }
+
+        // inside, or a local maximum behind every neighbour
+        if (next == face)
+        {
+            SurfacePoint result = this->Closest(point);
+            start = result.face;
+            return result;
+        }
+        face = next;
+    }
+
+    unsigned corners;
+    Vec3 closest = this->ClosestOnFace(face, point, corners);
+    float distanceSq = LengthSq(closest - point);
+    for (;;)
+    {
+        uint32_t next = face;
+        unsigned nextCorners = corners;
+        Vec3 nextClosest = closest;
+        float nextDistanceSq = distanceSq;
+        auto Visit = [&](uint32_t candidate)
+        {
+            if (!(this->PlaneDistance(candidate, point) > 0)) return;
+
+            unsigned candidateCorners;
+            Vec3 candidateClosest = this->ClosestOnFace(candidate, point, candidateCorners);
+            float candidateDistanceSq = LengthSq(candidateClosest - point);
+            if (candidateDistanceSq < nextDistanceSq)
+            {
+                next = candidate;
+                nextCorners = candidateCorners;
+                nextClosest = candidateClosest;
+                nextDistanceSq = candidateDistanceSq;
+            }
+        };
+
+        if (corners == 1 || corners == 2 || corners == 4)
+        {
+            // faces around the vertex : the twin of the edge into the vertex leaves it in the next face
+            uint32_t first = 3 * face + (corners == 1 ? 0 : corners == 2 ? 1 : 2);
+            for (uint32_t edge = this->twins[HalfEdgeMesh::Prev(first)]; edge != first; edge = this->twins[HalfEdgeMesh::Prev(edge)]) Visit(edge / 3);
+        }
+        else if (corners != 7)
+        {
+            // edge i runs from corner i to corner i + 1
+            uint32_t edge = 3 * face + (corners == 3 ? 0 : corners == 6 ? 1 : 2);
+            Visit(this->twins[edge] / 3);
+        }
+
+        if (next == face) break;
+        face = next;
+        corners = nextCorners;
+        closest = nextClosest;
+        distanceSq = nextDistanceSq;
+    }
+
+    start = face;
+    return { closest, std::sqrt(distanceSq), face };
+}
+
+void DistanceMap::Closest(const Vec3* points, size_t count, SurfacePoint* results, uint32_t& start) const
+{
+    for (size_t i = 0; i < count; ++i) results[i] = this->Closest(points[i], start);
+}
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "HullCore.hpp"
+#include "PlaneKernels.hpp"
+#include "Vec3.hpp"
+
+namespace hull
+{
+	// closest point of the hull surface to a query point
+	struct SurfacePoint
+	{
+		Vec3 point;
+		float distance;		// signed : < 0 inside the hull (minus the distance to the nearest face plane)
+		uint32_t face;		// face point lies on
+	};
+
+	// closest point and signed distance queries on a built hull (ai agents, proximity)
+	class DistanceMap
+	{
+	public:
+		// start value of a query cache : no previous result
+		static constexpr uint32_t NO_START = ~0u;
+
+		DistanceMap() = default;
+		explicit DistanceMap(const Hull& hull) { this->Build(hull); }
+
+		// copy the faces of hull into soa planes and triangles, and link the twin of each face edge
+		void Build(const Hull& hull);
+
+		void Clear();
+
+		size_t FaceCount() const { return this->offset.size(); }
+
+		// return : closest surface point, from the simd kernels over every face (face NO_START and distance inf if empty)
+		// inside points project onto their nearest face plane, outside points take the nearest triangle
+		SurfacePoint Closest(const Vec3& point) const;
+
+		// return : Closest(point), walking the face adjacency from the face in start (NO_START : brute force), start receives the result face,
+		// keep one start per caller and hull so coherent queries (agents polling every frame) visit few faces
+		// (inside points, and outside points whose walk meets no face they are in front of, fall back to the brute force)
+		SurfacePoint Closest(const Vec3& point, uint32_t& start) const;
+
+		// results[i] = Closest(points[i], start), each query starts from the previous result
+		void Closest(const Vec3* points, size_t count, SurfacePoint* results, uint32_t& start) const;
+
+	private:
+		float PlaneDistance(uint32_t face, const Vec3& point) const
+		{
+			return Plane{ { this->nx[face], this->ny[face], this->nz[face] }, this->offset[face] }.Distance(point);
+		}
+
+		Vec3 ClosestOnFace(uint32_t face, const Vec3& point, unsigned& corners) const;
+
+		std::vector<Vec3> vertices;
+		std::vector<uint32_t> indices;
+
+		// twin half-edge of each face edge (empty when the mesh is not closed : queries take the brute force)
+		std::vector<uint32_t> twins;
+
+		// face planes in soa form
+		std::vector<float> nx, ny, nz, offset;
+
+		// face triangles in soa form (see TrianglesSoA)
+		std::vector<float> ax, ay, az, abx, aby, abz, acx, acy, acz, abab, abac, acac;
+	};
+}
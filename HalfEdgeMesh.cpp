@@ -0,0 +1,84 @@
+#include "HalfEdgeMesh.hpp"
+
+#include <unordered_map>
+
+#include "HullCore.hpp"
+
+namespace hull
+{
+
+HalfEdgeMesh::HalfEdgeMesh()
+    : twins(), faces(), alive(), freeFaces(), faceCount(0)
+{}
+
+void HalfEdgeMesh::Clear()
+{
+    this->twins.clear();
+    this->faces.clear();
+    this->alive.clear();
+    this->freeFaces.clear();
+    this->faceCount = 0;
+}
+
+uint32_t HalfEdgeMesh::AddFace(uint32_t v0, uint32_t v1, uint32_t v2)
+{
+    uint32_t face;
+    if (!this->freeFaces.empty())
+    {
+        face = this->freeFaces.back();
+        this->freeFaces.pop_back();
+        this->alive[face] = true;
+    }
+    else
+    {
+        face = this->FaceCapacity();
+        this->twins.resize(this->twins.size() + 3);
+        this->faces.emplace_back();
+        this->alive.push_back(true);
+    }
+
+    this->faces[face] = { { v0, v1, v2 }, {} };
+
+    uint32_t edge = EdgeOf(face, 0);
+    this->twins[edge + 0] = INVALID;
+    this->twins[edge + 1] = INVALID;
+    this->twins[edge + 2] = INVALID;
+
+    ++this->faceCount;
+
+    return face;
+}
+
+void HalfEdgeMesh::RemoveFace(uint32_t face)
+{
+    this->alive[face] = false;
+    this->freeFaces.push_back(face);
+    --this->faceCount;
+}
+
+bool BuildTwins(const Hull& hull, std::vector<uint32_t>& twins)
+{
+    twins.assign(hull.indices.size(), HalfEdgeMesh::INVALID);
+
+    std::unordered_map<uint64_t, uint32_t> edges;
+    edges.reserve(hull.indices.size());
+    for (uint32_t edge = 0; edge < hull.indices.size(); ++edge)
+    {
+        uint64_t from = hull.indices[edge];
+        uint64_t to = hull.indices[HalfEdgeMesh::Next(edge)];
+        edges.emplace((from << 32) | to, edge);
+    }
+
+    bool closed = true;
+    for (uint32_t edge = 0; edge < hull.indices.size(); ++edge)
+    {
+        uint64_t from = hull.indices[edge];
+        uint64_t to = hull.indices[HalfEdgeMesh::Next(edge)];
+        auto it = edges.find((to << 32) | from);
+        if (it != edges.end()) twins[edge] = it->second;
+        else closed = false;
+    }
+    return closed;
+}
+
+}
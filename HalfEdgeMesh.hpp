@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Vec3.hpp"
+
+namespace hull
+{
+	struct Hull;
+
+	// hull face : indices into the shared point array + cached plane (28 bytes)
+	struct Face
+	{
+		// v[0] -> v[1] -> v[2] : clockwise
+		uint32_t v[3];
+		Plane plane;
+	};
+
+	// half-edge mesh of triangles
+	//
+	// face f owns half-edges 3f, 3f+1, 3f+2.
+	// half-edge 3f+i runs from vertex i to vertex i+1 of face f,
+	// so next / prev / face are implicit and only twins are stored.
+	// deleted face slots are reused by AddFace, ids stay stable while a face is alive.
+	class HalfEdgeMesh
+	{
+	public:
+		static constexpr uint32_t INVALID = ~0u;
+
+		static uint32_t FaceOf(uint32_t edge) { return edge / 3; }
+		static uint32_t Next(uint32_t edge) { return edge % 3 == 2 ? edge - 2 : edge + 1; }
+		static uint32_t Prev(uint32_t edge) { return edge % 3 == 0 ? edge + 2 : edge - 1; }
+		static uint32_t EdgeOf(uint32_t face, int i) { return face * 3 + i; }
+
+	public:
+		HalfEdgeMesh();
+
+		void Clear();
+
+		// return : face id (edges are left unlinked, plane is left to the caller)
+		uint32_t AddFace(uint32_t v0, uint32_t v1, uint32_t v2);
+		void RemoveFace(uint32_t face);
+
+		// make e1 and e2 twins
+		void Link(uint32_t e1, uint32_t e2)
+		{
+			this->twins[e1] = e2;
+			this->twins[e2] = e1;
+		}
+
+		uint32_t Twin(uint32_t edge) const { return this->twins[edge]; }
+		uint32_t Origin(uint32_t edge) const { return this->faces[edge / 3].v[edge % 3]; }
+		uint32_t Destination(uint32_t edge) const { return this->Origin(Next(edge)); }
+		uint32_t Vertex(uint32_t face, int i) const { return this->faces[face].v[i]; }
+
+		Face& GetFace(uint32_t face) { return this->faces[face]; }
+		const Face& GetFace(uint32_t face) const { return this->faces[face]; }
+
+		bool IsAlive(uint32_t face) const { return this->alive[face]; }
+
+		// number of face slots (alive or not), valid ids are [0, FaceCapacity)
+		uint32_t FaceCapacity() const { return static_cast<uint32_t>(this->alive.size()); }
+		uint32_t FaceCount() const { return this->faceCount; }
+
+	private:
+		// per half-edge
+		std::vector<uint32_t> twins;
+
+		// per face
+		std::vector<Face> faces;
+		std::vector<bool> alive;
+		std::vector<uint32_t> freeFaces;
+
+		uint32_t faceCount;
+	};
+
+	// twin of every half-edge of an indexed hull (half-edge e of face e / 3 runs from indices[e] to indices[Next(e)], a -> b is matched with b -> a)
+	// twins[e] is HalfEdgeMesh::INVALID on an open edge
+	// return : true if every edge has a twin
+	bool BuildTwins(const Hull& hull, std::vector<uint32_t>& twins);
+}
@@ -0,0 +1,79 @@
+#include "HullBatch.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <numeric>
+
+namespace hull
+{
+
+namespace
+{
+    void BuildMesh(const PointsView& mesh, const BuildOptions& options, HullCache* cache, HullJobResult& result)
+    {
+        // the mesh is read in place
+        result.succeeded = cache
+            ? cache->GetOrCreate(mesh, result.hull, options, &result.stats)
+            : CreateConvexHull(mesh, result.hull, options, &result.stats);
+    }
+}
+
+BatchStats CreateConvexHulls(const std::vector<PointsView>& meshes, std::vector<HullJobResult>& results, const BatchOptions& options, ThreadPool& pool)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    results.clear();
+    results.resize(meshes.size());
+
+    BatchStats stats;
+    stats.meshCount = meshes.size();
+    for (const PointsView& mesh : meshes) stats.pointCount += mesh.count;
+
+    // largest first : big meshes start early, small ones fill the gaps at the end
+    std::vector<uint32_t> order(meshes.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return meshes[a].count > meshes[b].count; });
+
+    // split meshes use every worker plus the thread waiting on them, the rest are serial
+    BuildOptions split = options.build;
+    split.threadCount = pool.ThreadCount() + 1;
+
+    BuildOptions serial = options.build;
+    serial.threadCount = 1;
+
+    TaskGroup group(pool);
+    size_t next = 0;
+    while (next < order.size() && meshes[order[next]].count >= options.splitPoints)
+    {
+        uint32_t mesh = order[next++];
+        group.Run([&, mesh]() { BuildMesh(meshes[mesh], split, options.cache, results[mesh]); });
+    }
+
+    while (next < order.size())
+    {
+        // one mesh, or a run of small meshes up to inlinePoints
+        size_t first = next;
+        size_t points = meshes[order[next++]].count;
+        while (next < order.size() && meshes[order[next]].count < options.inlinePoints && points + meshes[order[next]].count <= options.inlinePoints)
+        {
+            points += meshes[order[next++]].count;
+        }
+
+        group.Run([&, first, last = next]()
+        {
+            for (size_t i = first; i < last; ++i) BuildMesh(meshes[order[i]], serial, options.cache, results[order[i]]);
+        });
+    }
+    group.Wait();
+
+    for (const HullJobResult& result : results)
+    {
+        if (!result.succeeded) ++stats.failedCount;
+    }
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
+
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "HullCache.hpp"
+#include "HullCore.hpp"
+#include "HullJob.hpp"
+#include "PointsView.hpp"
+#include "ThreadPool.hpp"
+
+namespace hull
+{
+	// batch build settings
+	struct BatchOptions
+	{
+		// per mesh settings (threadCount is ignored, it is chosen per mesh from the pool size)
+		BuildOptions build;
+
+		// meshes below this many points are built back to back in one task, up to this many points per task
+		size_t inlinePoints = 16384;
+
+		// meshes with at least this many points split their point passes across the pool
+		size_t splitPoints = 131072;
+
+		// hulls are looked up here first and stored on a miss (null : no cache)
+		HullCache* cache = nullptr;
+	};
+
+	// batch report
+	struct BatchStats
+	{
+		size_t meshCount = 0;
+		size_t pointCount = 0;
+
+		// meshes without a hull (degenerate)
+		size_t failedCount = 0;
+
+		double seconds = 0;
+
+		double MeshesPerSecond() const { return this->seconds > 0 ? this->meshCount / this->seconds : 0; }
+		double PointsPerSecond() const { return this->seconds > 0 ? this->pointCount / this->seconds : 0; }
+	};
+
+	// build the hulls of many meshes on a pool, results[i] belongs to meshes[i]
+	// largest meshes are scheduled first, the calling thread helps until every mesh is done.
+	// each hull is the same as a single CreateConvexHull of the mesh with options.build.
+	BatchStats CreateConvexHulls(const std::vector<PointsView>& meshes, std::vector<HullJobResult>& results, const BatchOptions& options = {}, ThreadPool& pool = SharedHullPool());
+}
@@ -0,0 +1,323 @@
+#include "HullCache.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+#include "HullFile.hpp"
+
+namespace hull
+{
+
+namespace
+{
+    // bump when the hull algorithm output changes (old files then miss)
+    constexpr uint32_t CACHE_VERSION = 4;
+
+    // temporary files older than this are left over from a crashed writer
+    constexpr auto STALE_TEMP_AGE = std::chrono::hours(1);
+
+    constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ull;
+    constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4Full;
+    constexpr uint64_t PRIME3 = 0x165667B19E3779F9ull;
+    constexpr uint64_t PRIME4 = 0x85EBCA77C2B2AE63ull;
+
+    inline uint64_t Rotl(uint64_t x, int r)
+    {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    // final avalanche (murmur3 fmix64)
+    inline uint64_t Avalanche(uint64_t h)
+    {
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+    // two independent 64 bit lanes over 8 byte words
+    class Hasher
+    {
+    public:
+        Hasher() : high(PRIME3), low(PRIME4), length(0) {}
+
+        void Update(const void* data, size_t size)
+        {
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8)
+            {
+                uint64_t word;
+                std::memcpy(&word, bytes + i, 8);
+                this->Word(word);
+            }
+            if (i < size)
+            {
+                uint64_t word = 0;
+                std::memcpy(&word, bytes + i, size - i);
+                this->Word(word);
+            }
+            this->length += size;
+        }
+
+        template <typename T>
+        void Value(const T& value)
+        {
+            this->Update(&value, sizeof(T));
+        }
+
+        HullKey Finish() const
+        {
+            uint64_t high = Avalanche(this->high ^ this->length);
+            uint64_t low = Avalanche(this->low + Rotl(this->length, 32));
+            return { Avalanche(high + low), Avalanche(low ^ Rotl(high, 17)) };
+        }
+
+    private:
+        void Word(uint64_t word)
+        {
+            this->high = Rotl(this->high ^ (word * PRIME2), 31) * PRIME1;
+            this->low = Rotl(this->low + (Rotl(word, 23) * PRIME4), 27) * PRIME3;
+        }
+
+        uint64_t high;
+        uint64_t low;
+        uint64_t length;
+    };
+
+    // per cache object, keeps temporary names of concurrent writers (threads or processes) apart
+    uint64_t RandomPrefix()
+    {
+        std::random_device random;
+        return (uint64_t(random()) << 32) | random();
+    }
+
+    // return : false if the file is missing, malformed or of another key
+    bool ReadCacheFile(const std::filesystem::path& path, const HullKey& key, Hull& hull, uint64_t& size)
+    {
+        MappedHullFile file;
+        if (!file.Open(path)) return false;
+        if (file.HullCount() != 1 || file.TagHigh() != key.high || file.TagLow() != key.low) return false;
+        if (!file.Verify()) return false;
+
+        file.GetHull(0).CopyTo(hull);
+        size = file.Size();
+        return true;
+    }
+}
+
+std::string HullKey::ToString() const
+{
+    char text[33];
+    std::snprintf(text, sizeof(text), "%016llx%016llx", static_cast<unsigned long long>(this->high), static_cast<unsigned long long>(this->low));
+    return text;
+}
+
+HullKey HashHullInput(const PointsView& points, const BuildOptions& options)
+{
+    Hasher hasher;
+    hasher.Value(CACHE_VERSION);
+    hasher.Value(options.slabCount);
+    hasher.Value(options.extremeDirections);
+    hasher.Value(options.weld ? options.weldTolerance : -1.0f);
+    hasher.Value(options.maxVertices);
+    hasher.Value(options.maxError);
+    hasher.Value(options.inflate);
+    hasher.Value(static_cast<uint64_t>(points.count));
+
+    if (points.stride == sizeof(Vec3))
+    {
+        hasher.Update(static_cast<const unsigned char*>(points.data) + points.offset, points.count * sizeof(Vec3));
+        return hasher.Finish();
+    }
+
+    // strided : packed a block at a time (blocks are a multiple of 8 bytes, so the hash is the same as packed)
+    constexpr size_t BLOCK_POINTS = 1024;
+    Vec3 block[BLOCK_POINTS];
+    for (size_t begin = 0; begin < points.count; begin += BLOCK_POINTS)
+    {
+        size_t count = std::min(BLOCK_POINTS, points.count - begin);
+        for (size_t i = 0; i < count; ++i) block[i] = points[begin + i];
+        hasher.Update(block, count * sizeof(Vec3));
+    }
+    return hasher.Finish();
+}
+
+///////////////////////////////////////////////////////////
+
+HullCache::HullCache(std::filesystem::path directory_, uint64_t maxBytes_)
+    : directory(std::move(directory_)), maxBytes(maxBytes_), valid(false), tempPrefix(RandomPrefix()), tempCount(0), mutex(), order(), entries(), totalBytes(0), hitCount(0), missCount(0), evictionCount(0)
+{
+    std::error_code error;
+    std::filesystem::create_directories(this->directory, error);
+    if (!std::filesystem::is_directory(this->directory, error)) return;
+
+    // existing hulls, most recently used (written or hit) first
+    struct Found
+    {
+        std::string name;
+        uint64_t size;
+        std::filesystem::file_time_type time;
+    };
+    std::vector<Found> found;
+
+    auto now = std::filesystem::file_time_type::clock::now();
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(this->directory, error))
+    {
+        if (!entry.is_regular_file(error)) continue;
+
+        const std::filesystem::path& path = entry.path();
+        std::filesystem::file_time_type time = entry.last_write_time(error);
+        if (path.extension() == ".tmp")
+        {
+            if (!error && now - time > STALE_TEMP_AGE) std::filesystem::remove(path, error);
+        }
+        else if (path.extension() == ".hull")
+        {
+            found.push_back({ path.stem().string(), entry.file_size(error), time });
+        }
+    }
+
+    std::sort(found.begin(), found.end(), [](const Found& a, const Found& b) { return a.time > b.time; });
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (auto it = found.rbegin(); it != found.rend(); ++it) this->Insert(it->name, it->size);
+
+    this->valid = true;
+}
+
+bool HullCache::Load(const HullKey& key, Hull& hull)
+{
+    hull.Clear();
+    if (!this->valid)
+    {
+        ++this->missCount;
+        return false;
+    }
+
+    std::string name = key.ToString();
+    std::filesystem::path path = this->PathOf(name);
+    std::error_code error;
+
+    uint64_t size = 0;
+    if (!ReadCacheFile(path, key, hull, size))
+    {
+        hull.Clear();
+        ++this->missCount;
+
+        // unreadable leftovers (other version, truncated) are dropped
+        if (std::filesystem::exists(path, error))
+        {
+            std::filesystem::remove(path, error);
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->Remove(name);
+        }
+        return false;
+    }
+
+    ++this->hitCount;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->entries.count(name)) this->Touch(name);
+    else this->Insert(name, size);
+    return true;
+}
+
+bool HullCache::Store(const HullKey& key, const Hull& hull)
+{
+    if (!this->valid) return false;
+
+    std::string name = key.ToString();
+
+    char suffix[48];
+    std::snprintf(suffix, sizeof(suffix), ".%016llx-%llu.tmp", static_cast<unsigned long long>(this->tempPrefix), static_cast<unsigned long long>(this->tempCount.fetch_add(1)));
+    std::filesystem::path temp = this->directory / (name + suffix);
+
+    HullFileOptions options;
+    options.adjacency = false;
+    options.tag[0] = key.high;
+    options.tag[1] = key.low;
+
+    std::error_code error;
+    if (!WriteHullFile(temp, { &hull, 1 }, options))
+    {
+        std::filesystem::remove(temp, error);
+        return false;
+    }
+
+    uint64_t size = std::filesystem::file_size(temp, error);
+    std::filesystem::rename(temp, this->PathOf(name), error);
+    if (error)
+    {
+        std::filesystem::remove(temp, error);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->Insert(name, size);
+    return true;
+}
+
+bool HullCache::GetOrCreate(const PointsView& points, Hull& hull, const BuildOptions& options, BuildStats* stats, const BuildControl* control)
+{
+    HullKey key = HashHullInput(points, options);
+    if (this->Load(key, hull))
+    {
+        if (stats) *stats = {};
+        return true;
+    }
+
+    if (!CreateConvexHull(points, hull, options, stats, control)) return false;
+
+    this->Store(key, hull);
+    return true;
+}
+
+uint64_t HullCache::Size() const
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->totalBytes;
+}
+
+void HullCache::Touch(const std::string& name)
+{
+    Entry& entry = this->entries.at(name);
+    this->order.splice(this->order.begin(), this->order, entry.position);
+}
+
+void HullCache::Insert(const std::string& name, uint64_t size)
+{
+    this->Remove(name);
+
+    this->order.push_front(name);
+    this->entries[name] = { size, this->order.begin() };
+    this->totalBytes += size;
+
+    // the newest hull is kept even if it is larger than maxBytes on its own
+    while (this->totalBytes > this->maxBytes && this->order.size() > 1)
+    {
+        std::string victim = this->order.back();
+        std::error_code error;
+        std::filesystem::remove(this->PathOf(victim), error);
+        this->Remove(victim);
+        ++this->evictionCount;
+    }
+}
+
+void HullCache::Remove(const std::string& name)
+{
+    auto it = this->entries.find(name);
+    if (it == this->entries.end()) return;
+
+    this->totalBytes -= it->second.size;
+    this->order.erase(it->second.position);
+    this->entries.erase(it);
+}
+
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "HullCore.hpp"
+
+namespace hull
+{
+	// content hash of a hull build input (positions + options that change the result)
+	struct HullKey
+	{
+		uint64_t high = 0;
+		uint64_t low = 0;
+
+		bool operator==(const HullKey&) const = default;
+
+		// 32 hex digits
+		std::string ToString() const;
+	};
+
+	// return : key of CreateConvexHull(points, ..., options)
+	// hashes the position bytes (the same for any stride / offset), slabCount, extremeDirections, weldTolerance (when weld is on),
+	// maxVertices, maxError and inflate (threadCount does not change the hull).
+	// 128 bit multiply / rotate hash : fast, not cryptographic.
+	HullKey HashHullInput(const PointsView& points, const BuildOptions& options);
+
+	// on-disk hull cache, one file per key in a directory
+	//
+	// a store writes a temporary file and renames it over the final name, so readers (other threads or processes)
+	// never see a partial hull. files are hull files (HullFile.hpp) tagged with their key and are checked on load, bad files count as misses
+	// and are removed. the directory is kept under maxBytes by evicting the least recently used hulls
+	// (a hit refreshes the file time, so the order survives restarts). thread-safe.
+	class HullCache
+	{
+	public:
+		static constexpr uint64_t DEFAULT_MAX_BYTES = 512ull << 20;
+
+		// directory is created if needed
+		explicit HullCache(std::filesystem::path directory, uint64_t maxBytes = DEFAULT_MAX_BYTES);
+
+		HullCache(const HullCache&) = delete;
+		HullCache& operator=(const HullCache&) = delete;
+
+		// directory is usable
+		bool IsValid() const { return this->valid; }
+
+		// return : false on a miss (hull is then left empty)
+		bool Load(const HullKey& key, Hull& hull);
+
+		// return : false if the hull could not be written
+		bool Store(const HullKey& key, const Hull& hull);
+
+		// hull from the cache, or CreateConvexHull + Store on a miss (failed builds are not stored)
+		// on a hit stats->status is Succeeded and culledCount is 0
+		bool GetOrCreate(const PointsView& points, Hull& hull, const BuildOptions& options = {}, BuildStats* stats = nullptr, const BuildControl* control = nullptr);
+
+		size_t HitCount() const { return this->hitCount.load(); }
+		size_t MissCount() const { return this->missCount.load(); }
+		size_t EvictionCount() const { return this->evictionCount.load(); }
+
+		// bytes of the cached hulls
+		uint64_t Size() const;
+
+	private:
+		struct Entry
+		{
+			uint64_t size;
+			std::list<std::string>::iterator position;
+		};
+
+		std::filesystem::path PathOf(const std::string& name) const { return this->directory / (name + ".hull"); }
+
+		// move name to the front of the lru order
+		void Touch(const std::string& name);
+
+		// add or replace an entry, evict beyond maxBytes (mutex held)
+		void Insert(const std::string& name, uint64_t size);
+		void Remove(const std::string& name);
+
+	private:
+		std::filesystem::path directory;
+		const uint64_t maxBytes;
+		bool valid;
+
+		// unique part of temporary file names
+		const uint64_t tempPrefix;
+		std::atomic<uint64_t> tempCount;
+
+		mutable std::mutex mutex;
+
+		// most recently used first
+		std::list<std::string> order;
+		std::unordered_map<std::string, Entry> entries;
+		uint64_t totalBytes;
+
+		std::atomic<size_t> hitCount;
+		std::atomic<size_t> missCount;
+		std::atomic<size_t> evictionCount;
+	};
+}
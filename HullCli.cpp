@@ -0,0 +1,1199 @@
+// hull_cli : headless convex hull builder
+//
+// usage : hull_cli [options] <points> [hull.obj]
+//         hull_cli [options] --synthetic <sphere|ball|cube|gauss> <count> [hull.obj]
+//   points     : .txt / .xyz one "x y z" per line ('#' starts a comment line), .ply, .obj, anything else raw float3
+//                (memory mapped, raw and binary float ply are used in place, text is parsed on --threads threads)
+//   hull.obj   : wavefront obj (stdout when omitted), binary hull file when it ends in .hull
+//   hulls.hull : binary hull file as input : map it and write its first hull
+//   synthetic  : reproducible random cloud (fixed seed) for regression and profiling
+//   --batch n  : build n meshes (synthetic clouds with seeds 0..n-1, or n times the input) and report throughput,
+//                the hulls are written as one hull file when an output is given
+//   --incremental n : insert the points into an IncrementalHull n at a time
+//   --stream n : read the input file n points at a time (memory : 2 chunks + hull), .txt / .xyz text, else raw float3
+//   --cache dir : reuse hulls stored in dir by earlier runs (same points and options), store new ones
+//   --merge d  : merge coplanar faces (within distance d) and write the hull as convex polygons (obj only)
+//   --support n : time n support queries on the built hull (random and slowly turning directions)
+//   --contains n : time point-in-hull tests of n random points around the built hull (merged planes with --merge)
+//   --distance n : time n closest point queries around the built hull (brute force, and warm started along a coherent path)
+//   --overlap n : time sat overlap tests of n randomly posed pairs of the built hull over 10 slowly moving frames
+//   --rays n   : time n ray clips against the built hull (random rays through its bounds, merged planes with --merge)
+//   --mass d   : print volume, mass, centroid and inertia tensor of the built hull filled with density d
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "DistanceMap.hpp"
+#include "HullBatch.hpp"
+#include "HullCache.hpp"
+#include "HullFile.hpp"
+#include "HullCore.hpp"
+#include "HullJob.hpp"
+#include "HullOverlap.hpp"
+#include "HullStream.hpp"
+#include "MassProperties.hpp"
+#include "Parallel.hpp"
+#include "PlaneKernels.hpp"
+#include "PlaneSet.hpp"
+#include "PointLoader.hpp"
+#include "PolygonHull.hpp"
+#include "Predicates.hpp"
+#include "SupportMap.hpp"
+
+namespace
+{
+    // sphere : on unit sphere, ball : inside unit sphere, cube : inside [-1,1]^3, gauss : normal distribution
+    bool GeneratePoints(std::string_view kind, size_t count, std::vector<hull::Vec3>& points, unsigned seed = std::mt19937::default_seed)
+    {
+        std::mt19937 engine(seed);
+        std::normal_distribution<float> normal(0.0f, 1.0f);
+        std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+
+        points.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            hull::Vec3 point = {};
+            if (kind == "sphere" || kind == "ball")
+            {
+                do { point = { normal(engine), normal(engine), normal(engine) }; } while (hull::LengthSq(point) == 0);
+                point = hull::Normalize(point);
+                if (kind == "ball") point *= std::cbrt(0.5f * (uniform(engine) + 1.0f));
+            }
+            else if (kind == "cube")
+            {
+                point = { uniform(engine), uniform(engine), uniform(engine) };
+            }
+            else if (kind == "gauss")
+            {
+                point = { normal(engine), normal(engine), normal(engine) };
+            }
+            else return false;
+
+            points.push_back(point);
+        }
+        return true;
+    }
+
+    struct Options
+    {
+        std::string input;
+        std::string output;
+
+        // synthetic cloud instead of input
+        std::string synthetic;
+        size_t syntheticCount = 0;
+
+        // scalar | sse4.1 | avx2 (empty : detect)
+        std::string simd;
+
+        // hull build settings (--threads, --slabs, --prefilter, --weld, --max-vertices, --max-error, --inflate)
+        hull::BuildOptions build;
+
+        // stop the build after this many ms (0 : no deadline)
+        long long deadline = 0;
+
+        // print remaining points / faces while building
+        bool progress = false;
+
+        // number of meshes of a batch build (0 : single build)
+        size_t batch = 0;
+
+        // points per insert of an incremental build (0 : single build)
+        size_t incremental = 0;
+
+        // hull cache directory (empty : no cache)
+        std::string cache;
+
+        // points per chunk of a streaming build (0 : read the whole file)
+        size_t stream = 0;
+
+        // largest distance of a merged polygon corner from its plane (< 0 : write triangles)
+        float mergeTolerance = -1;
+
+        // largest angle between the normals of merged faces, in degrees
+        float mergeAngle = 1;
+
+        // support queries to time on the built hull (0 : none)
+        size_t support = 0;
+
+        // points to test against the built hull (0 : none)
+        size_t contains = 0;
+
+        // closest point queries to time on the built hull (0 : none)
+        size_t distance = 0;
+
+        // hull pairs to test for overlap (0 : none)
+        size_t overlap = 0;
+
+        // rays to clip against the built hull (0 : none)
+        size_t rays = 0;
+
+        // density of the built hull for its mass properties (0 : not printed)
+        float density = 0;
+    };
+
+    void PrintUsage(const char* name)
+    {
+        std::fprintf(stderr, "usage : %s [options] <points.txt|.xyz|.ply|.obj|raw> [hull.obj|hull.hull]\n", name);
+        std::fprintf(stderr, "        %s <hulls.hull> [hull.obj|hull.hull]\n", name);
+        std::fprintf(stderr, "        %s [options] --synthetic <sphere|ball|cube|gauss> <count> [hull.obj]\n", name);
+        std::fprintf(stderr, "options :\n");
+        std::fprintf(stderr, "  --simd <scalar|sse4.1|avx2>  force kernel instruction set\n");
+        std::fprintf(stderr, "  --threads <n>                worker threads for the point passes (0 : all cores, default 1)\n");
+        std::fprintf(stderr, "  --slabs <n>                  divide and conquer over n slabs (0 : automatic, default 1 : off)\n");
+        std::fprintf(stderr, "  --prefilter <n>              cull interior points with the extreme points along n directions (26, 62, ...)\n");
+        std::fprintf(stderr, "  --weld <tolerance>           merge points within tolerance of an earlier point (0 : exact duplicates)\n");
+        std::fprintf(stderr, "  --max-vertices <n>           simplified hull of at most n vertices, furthest first\n");
+        std::fprintf(stderr, "  --max-error <distance>       simplified hull, stop once no point is further out than distance\n");
+        std::fprintf(stderr, "  --inflate                    push the simplified hull out until it contains every point\n");
+        std::fprintf(stderr, "  --deadline <ms>              give up after ms milliseconds\n");
+        std::fprintf(stderr, "  --progress                   print remaining points and faces while building\n");
+        std::fprintf(stderr, "  --batch <n>                  build n meshes on the pool and print the throughput\n");
+        std::fprintf(stderr, "  --incremental <n>            insert the points n at a time into an incremental hull\n");
+        std::fprintf(stderr, "  --cache <dir>                look hulls up in (and store them to) a cache directory\n");
+        std::fprintf(stderr, "  --stream <n>                 read the input n points at a time (.txt / .xyz text, otherwise raw float3)\n");
+        std::fprintf(stderr, "  --merge <distance>           merge coplanar faces into convex polygons (obj output)\n");
+        std::fprintf(stderr, "  --merge-angle <degrees>      largest normal deviation of merged faces (default 1)\n");
+        std::fprintf(stderr, "  --support <n>                time n support queries on the built hull\n");
+        std::fprintf(stderr, "  --contains <n>               time point-in-hull tests of n random points around the built hull\n");
+        std::fprintf(stderr, "  --distance <n>               time n closest point queries around the built hull\n");
+        std::fprintf(stderr, "  --overlap <n>                time overlap tests of n posed pairs of the built hull\n");
+        std::fprintf(stderr, "  --rays <n>                   time n ray clips against the built hull\n");
+        std::fprintf(stderr, "  --mass <density>             print the mass properties of the built hull\n");
+        std::fprintf(stderr, "the query timings, --incremental, --stream and --weld check their results, the exit status is 1 if one is wrong\n");
+    }
+
+    bool ParseArguments(int argc, char** argv, Options& options)
+    {
+        std::vector<std::string_view> positionals;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string_view arg = argv[i];
+            if (arg == "--synthetic" && i + 2 < argc)
+            {
+                options.synthetic = argv[++i];
+                options.syntheticCount = std::strtoull(argv[++i], nullptr, 10);
+            }
+            else if (arg == "--simd" && i + 1 < argc)
+            {
+                options.simd = argv[++i];
+                if (options.simd != "scalar" && options.simd != "sse4.1" && options.simd != "avx2") return false;
+            }
+            else if (arg == "--threads" && i + 1 < argc)
+            {
+                options.build.threadCount = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+            }
+            else if (arg == "--slabs" && i + 1 < argc)
+            {
+                options.build.slabCount = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+            }
+            else if (arg == "--prefilter" && i + 1 < argc)
+            {
+                options.build.extremeDirections = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+            }
+            else if (arg == "--weld" && i + 1 < argc)
+            {
+                options.build.weld = true;
+                options.build.weldTolerance = std::strtof(argv[++i], nullptr);
+            }
+            else if (arg == "--max-vertices" && i + 1 < argc)
+            {
+                options.build.maxVertices = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+            }
+            else if (arg == "--max-error" && i + 1 < argc)
+            {
+                options.build.maxError = std::strtof(argv[++i], nullptr);
+            }
+            else if (arg == "--inflate")
+            {
+                options.build.inflate = true;
+            }
+            else if (arg == "--deadline" && i + 1 < argc)
+            {
+                options.deadline = std::strtoll(argv[++i], nullptr, 10);
+            }
+            else if (arg == "--progress")
+            {
+                options.progress = true;
+            }
+            else if (arg == "--batch" && i + 1 < argc)
+            {
+                options.batch = std::strtoull(argv[++i], nullptr, 10);
+            }
+            else if (arg == "--stream" && i + 1 < argc)
+            {
+                options.stream = std::strtoull(argv[++i], nullptr, 10);
+                if (options.stream == 0) return false;
+            }
+            else if (arg == "--cache" && i + 1 < argc)
+            {
+                options.cache = argv[++i];
+            }
+            else if (arg == "--merge" && i + 1 < argc)
+            {
+                options.mergeTolerance = std::strtof(argv[++i], nullptr);
+                if (!(options.mergeTolerance >= 0)) return false;
+            }
+            else if (arg == "--merge-angle" && i + 1 < argc)
+            {
+                options.mergeAngle = std::strtof(argv[++i], nullptr);
+            }
+            else if (arg == "--support" && i + 1 < argc)
+            {
+                options.support = std::strtoull(argv[++i], nullptr, 10);
+            }
+            else if (arg == "--contains" && i + 1 < argc)
+            {
+                options.contains = std::strtoull(argv[++i], nullptr, 10);
+            }
+            else if (arg == "--distance" && i + 1 < argc)
+            {
+                options.distance = std::strtoull(argv[++i], nullptr, 10);
+            }
+            else if (arg == "--overlap" && i + 1 < argc)
+            {
+                options.overlap = std::strtoull(argv[++i], nullptr, 10);
+            }
+            else if (arg == "--rays" && i + 1 < argc)
+            {
+                options.rays = std::strtoull(argv[++i], nullptr, 10);
+            }
+            else if (arg == "--mass" && i + 1 < argc)
+            {
+                options.density = std::strtof(argv[++i], nullptr);
+                if (!(options.density > 0)) return false;
+            }
+            else if (arg == "--incremental" && i + 1 < argc)
+            {
+                options.incremental = std::strtoull(argv[++i], nullptr, 10);
+                if (options.incremental == 0) return false;
+            }
+            else if (arg.starts_with("--"))
+            {
+                return false;
+            }
+            else
+            {
+                positionals.push_back(arg);
+            }
+        }
+
+        size_t next = 0;
+        if (options.stream > 0 && !options.synthetic.empty()) return false;
+        if (options.synthetic.empty())
+        {
+            if (positionals.empty()) return false;
+            options.input = positionals[next++];
+        }
+        if (next < positionals.size()) options.output = positionals[next++];
+
+        return next == positionals.size();
+    }
+
+    void WriteObj(std::ostream& out, const hull::Hull& hull)
+    {
+        for (auto& vertex : hull.vertices)
+        {
+            out << "v " << vertex.x << ' ' << vertex.y << ' ' << vertex.z << '\n';
+        }
+        for (size_t i = 0; i < hull.indices.size(); i += 3)
+        {
+            out << "f " << hull.indices[i] + 1 << ' ' << hull.indices[i + 1] + 1 << ' ' << hull.indices[i + 2] + 1 << '\n';
+        }
+    }
+
+    void WriteObj(std::ostream& out, const hull::PolygonHull& polygons)
+    {
+        for (auto& vertex : polygons.vertices)
+        {
+            out << "v " << vertex.x << ' ' << vertex.y << ' ' << vertex.z << '\n';
+        }
+        for (size_t polygon = 0; polygon < polygons.PolygonCount(); ++polygon)
+        {
+            out << 'f';
+            for (uint32_t i = polygons.polygonStarts[polygon]; i < polygons.polygonStarts[polygon + 1]; ++i) out << ' ' << polygons.polygonIndices[i] + 1;
+            out << '\n';
+        }
+    }
+
+    bool IsHullFile(const std::string& path)
+    {
+        return std::filesystem::path(path).extension() == ".hull";
+    }
+
+    // write hull to path (stdout when null), obj unless the path ends in .hull
+    // return : false if the file can not be written
+    bool WriteOutput(const char* path, const hull::Hull& hull)
+    {
+        if (!path)
+        {
+            WriteObj(std::cout, hull);
+            return true;
+        }
+
+        if (IsHullFile(path))
+        {
+            if (hull::WriteHullFile(path, { &hull, 1 })) return true;
+            std::fprintf(stderr, "cannot write %s\n", path);
+            return false;
+        }
+
+        std::ofstream out(path);
+        if (!out)
+        {
+            std::fprintf(stderr, "cannot write %s\n", path);
+            return false;
+        }
+        WriteObj(out, hull);
+        return true;
+    }
+
+    // return : false if the hull is not closed
+    bool MergeFaces(const hull::Hull& hull, const Options& options, hull::PolygonHull& polygons)
+    {
+        if (!hull::MergeCoplanarFaces(hull, options.mergeTolerance, options.mergeAngle * 3.14159265f / 180, polygons))
+        {
+            std::fprintf(stderr, "cannot merge faces of an open hull\n");
+            return false;
+        }
+        std::fprintf(stderr, "polygons : %zu\n", polygons.PolygonCount());
+        return true;
+    }
+
+    // write polygons to path (stdout when null) as obj
+    // return : false if the file can not be written
+    bool WritePolygons(const char* path, const hull::PolygonHull& polygons)
+    {
+        if (!path)
+        {
+            WriteObj(std::cout, polygons);
+            return true;
+        }
+
+        std::ofstream out(path);
+        if (!out)
+        {
+            std::fprintf(stderr, "cannot write %s\n", path);
+            return false;
+        }
+        WriteObj(out, polygons);
+        return true;
+    }
+
+    // time support queries on hull : random directions from a cold start, then a slowly turning direction (gjk-like coherence)
+    // the first 10000 results are checked against the brute force maximum
+    // return : checked results that were wrong
+    size_t RunSupport(const hull::Hull& hull, size_t count)
+    {
+        hull::SupportMap map(hull);
+        if (map.VertexCount() == 0) return 0;
+
+        std::mt19937 engine(std::mt19937::default_seed);
+        std::normal_distribution<float> normal(0.0f, 1.0f);
+        std::vector<hull::Vec3> random(count), turning(count);
+        for (auto& direction : random) direction = { normal(engine), normal(engine), normal(engine) };
+        for (size_t i = 0; i < count; ++i)
+        {
+            float angle = 0.01f * static_cast<float>(i);
+            turning[i] = { std::cos(angle), std::sin(angle), std::sin(0.37f * angle) };
+        }
+
+        std::vector<uint32_t> results(count);
+        auto time = [&](const std::vector<hull::Vec3>& directions, bool coherent)
+        {
+            auto start = std::chrono::steady_clock::now();
+            uint32_t cache = hull::SupportMap::NO_START;
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (!coherent) cache = hull::SupportMap::NO_START;
+                results[i] = map.Support(directions[i], cache);
+            }
+            double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+
+            size_t wrong = 0;
+            for (size_t i = 0; i < std::min<size_t>(count, 10000); ++i)
+            {
+                float best = -INFINITY;
+                for (const hull::Vec3& vertex : hull.vertices) best = std::max(best, hull::Dot(directions[i], vertex));
+                float found = hull::Dot(directions[i], map.Vertex(results[i]));
+                if (found < best - 1e-5f * (std::abs(best) + 1)) ++wrong;
+            }
+            return std::pair(ns, wrong);
+        };
+
+        auto [randomNs, randomWrong] = time(random, false);
+        auto [turningNs, turningWrong] = time(turning, true);
+        std::fprintf(stderr, "support : %.1f ns random, %.1f ns coherent (%zu queries, %zu / %zu checked off the maximum)\n", randomNs, turningNs, count, randomWrong, turningWrong);
+        return randomWrong + turningWrong;
+    }
+
+    // time point-in-hull tests and signed distances of random points in the bounds of hull grown by 20%
+    // containment is checked against the face planes one point at a time (merged planes may differ within the merge tolerance)
+    // return : checked results that were wrong
+    size_t RunContains(const hull::Hull& hull, const hull::PolygonHull* polygons, const Options& options)
+    {
+        if (hull.vertices.empty()) return 0;
+
+        hull::PlaneSet planes;
+        if (polygons) planes.Build(*polygons);
+        else planes.Build(hull);
+
+        hull::Vec3 lower = hull.vertices[0], upper = hull.vertices[0];
+        for (const hull::Vec3& v : hull.vertices)
+        {
+            lower = { std::min(lower.x, v.x), std::min(lower.y, v.y), std::min(lower.z, v.z) };
+            upper = { std::max(upper.x, v.x), std::max(upper.y, v.y), std::max(upper.z, v.z) };
+        }
+        hull::Vec3 margin = (upper - lower) * 0.1f;
+        lower -= margin;
+        upper += margin;
+
+        std::mt19937 engine(std::mt19937::default_seed);
+        std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+        std::vector<hull::Vec3> points(options.contains);
+        for (auto& p : points) p = { lower.x + (upper.x - lower.x) * uniform(engine), lower.y + (upper.y - lower.y) * uniform(engine), lower.z + (upper.z - lower.z) * uniform(engine) };
+
+        std::vector<uint8_t> inside(points.size());
+        std::vector<float> distances(points.size());
+        auto start = std::chrono::steady_clock::now();
+        planes.Contains(points, 0, options.build.threadCount, inside.data());
+        auto contained = std::chrono::steady_clock::now();
+        planes.SignedDistances(points, options.build.threadCount, distances.data());
+        auto measured = std::chrono::steady_clock::now();
+
+        size_t insideCount = 0, mismatches = 0;
+        for (size_t i = 0; i < points.size(); ++i)
+        {
+            insideCount += inside[i];
+            if (polygons) continue;
+
+            bool expected = true;
+            for (size_t face = 0; face < hull.FaceCount() && expected; ++face) expected = hull.FacePlane(face).Distance(points[i]) <= 0;
+            if (expected != (inside[i] != 0) || expected != (distances[i] <= 0)) ++mismatches;
+        }
+
+        double n = static_cast<double>(points.size());
+        std::fprintf(stderr, "contains : %zu planes, %zu / %zu inside, %.1f ns/point (signed distance %.1f ns/point), %zu mismatches\n", planes.PlaneCount(), insideCount, points.size(),
+            std::chrono::duration<double, std::nano>(contained - start).count() / n, std::chrono::duration<double, std::nano>(measured - contained).count() / n, mismatches);
+        return mismatches;
+    }
+
+    // time closest point queries : random points in the bounds of hull grown by 20% by brute force, then a point circling
+    // through the hull warm started from the previous face (and the random points warm started from each other)
+    // the first 10000 results are checked against the closest point over every face (the sign from every plane)
+    // return : checked results that were wrong
+    size_t RunDistance(const hull::Hull& hull, size_t count)
+    {
+        hull::DistanceMap map(hull);
+        if (map.FaceCount() == 0) return 0;
+
+        hull::Vec3 lower = hull.vertices[0], upper = hull.vertices[0];
+        for (const hull::Vec3& v : hull.vertices)
+        {
+            lower = { std::min(lower.x, v.x), std::min(lower.y, v.y), std::min(lower.z, v.z) };
+            upper = { std::max(upper.x, v.x), std::max(upper.y, v.y), std::max(upper.z, v.z) };
+        }
+        hull::Vec3 center = (lower + upper) * 0.5f;
+        hull::Vec3 extent = (upper - lower) * 0.6f;
+
+        std::mt19937 engine(std::mt19937::default_seed);
+        std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+        std::vector<hull::Vec3> random(count), path(count);
+        for (auto& p : random) p = { center.x + extent.x * uniform(engine), center.y + extent.y * uniform(engine), center.z + extent.z * uniform(engine) };
+        for (size_t i = 0; i < count; ++i)
+        {
+            float angle = 0.001f * static_cast<float>(i);
+            path[i] = { center.x + extent.x * std::cos(angle), center.y + extent.y * std::sin(1.3f * angle), center.z + extent.z * std::sin(0.7f * angle) };
+        }
+
+        std::vector<hull::SurfacePoint> results(count);
+        auto check = [&](const std::vector<hull::Vec3>& points)
+        {
+            size_t wrong = 0;
+            for (size_t i = 0; i < std::min<size_t>(count, 10000); ++i)
+            {
+                float best = INFINITY, maxDistance = -INFINITY;
+                for (size_t face = 0; face < hull.FaceCount(); ++face)
+                {
+                    const uint32_t* corner = &hull.indices[3 * face];
+                    hull::Vec3 q = hull::ClosestPointOnTriangle(points[i], hull.vertices[corner[0]], hull.vertices[corner[1]], hull.vertices[corner[2]]);
+                    best = std::min(best, hull::Length(q - points[i]));
+                    maxDistance = std::max(maxDistance, hull.FacePlane(face).Distance(points[i]));
+                }
+                float expected = maxDistance > 0 ? best : maxDistance;
+                float found = hull::Length(results[i].point - points[i]);
+                float tolerance = 1e-4f * (hull::Length(extent) + 1);
+                if (std::abs(results[i].distance - expected) > tolerance || std::abs(found - std::abs(expected)) > tolerance) ++wrong;
+            }
+            return wrong;
+        };
+        auto time = [&](const std::vector<hull::Vec3>& points, bool warm)
+        {
+            auto start = std::chrono::steady_clock::now();
+            uint32_t cache = hull::DistanceMap::NO_START;
+            if (warm) map.Closest(points.data(), count, results.data(), cache);
+            else for (size_t i = 0; i < count; ++i) results[i] = map.Closest(points[i]);
+            double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+            return std::pair(ns, check(points));
+        };
+
+        auto [bruteNs, bruteWrong] = time(random, false);
+        auto [pathBruteNs, pathBruteWrong] = time(path, false);
+        auto [pathNs, pathWrong] = time(path, true);
+        auto [randomNs, randomWrong] = time(random, true);
+        std::fprintf(stderr, "distance : %zu faces, %.1f ns brute force (%.1f ns on the path), %.1f ns warm on the path, %.1f ns warm random (%zu queries, %zu / %zu / %zu / %zu checked off)\n",
+            map.FaceCount(), bruteNs, pathBruteNs, pathNs, randomNs, count, bruteWrong, pathBruteWrong, pathWrong, randomWrong);
+        return bruteWrong + pathBruteWrong + pathWrong + randomWrong;
+    }
+
+    // rotation of the unit quaternion (w, x, y, z) and a position
+    hull::Transform MakeTransform(float w, float x, float y, float z, const hull::Vec3& position)
+    {
+        return
+        {
+            { 1 - 2 * (y * y + z * z), 2 * (x * y + w * z), 2 * (x * z - w * y) },
+            { 2 * (x * y - w * z), 1 - 2 * (x * x + z * z), 2 * (y * z + w * x) },
+            { 2 * (x * z + w * y), 2 * (y * z - w * x), 1 - 2 * (x * x + y * y) },
+            position,
+        };
+    }
+
+    // hulls with more vertices are not checked against every axis by RunOverlap (e * e axes times v vertices per pair)
+    constexpr size_t MAX_REFERENCE_VERTICES = 64;
+
+    // return : true if the projections of a and b onto axis are disjoint
+    bool Separates(const std::vector<hull::Vec3>& a, const std::vector<hull::Vec3>& b, const hull::Vec3& axis)
+    {
+        if (hull::LengthSq(axis) < 1e-12f) return false;
+        float maxA = -INFINITY, minA = INFINITY, maxB = -INFINITY, minB = INFINITY;
+        for (const hull::Vec3& v : a)
+        {
+            maxA = std::max(maxA, hull::Dot(axis, v));
+            minA = std::min(minA, hull::Dot(axis, v));
+        }
+        for (const hull::Vec3& v : b)
+        {
+            maxB = std::max(maxB, hull::Dot(axis, v));
+            minB = std::min(minB, hull::Dot(axis, v));
+        }
+        return minB > maxA || minA > maxB;
+    }
+
+    // return : true if no face normal or edge-edge cross product of the transformed vertices a and b of hull separates them
+    // (every axis, each edge once, brute force supports)
+    bool ReferenceOverlap(const hull::Hull& hull, const std::vector<hull::Vec3>& a, const std::vector<hull::Vec3>& b)
+    {
+        std::vector<hull::Vec3> edgesA, edgesB;
+        for (size_t face = 0; face < hull.FaceCount(); ++face)
+        {
+            const uint32_t* corner = &hull.indices[3 * face];
+            if (Separates(a, b, hull::Cross(a[corner[1]] - a[corner[0]], a[corner[2]] - a[corner[0]]))) return false;
+            if (Separates(a, b, hull::Cross(b[corner[1]] - b[corner[0]], b[corner[2]] - b[corner[0]]))) return false;
+            for (int i = 0; i < 3; ++i)
+            {
+                // the twin half-edge runs the other way
+                uint32_t from = corner[i], to = corner[(i + 1) % 3];
+                if (from > to) continue;
+                edgesA.push_back(a[to] - a[from]);
+                edgesB.push_back(b[to] - b[from]);
+            }
+        }
+        for (const hull::Vec3& edgeA : edgesA)
+        {
+            for (const hull::Vec3& edgeB : edgesB)
+            {
+                if (Separates(a, b, hull::Cross(edgeA, edgeB))) return false;
+            }
+        }
+        return true;
+    }
+
+    // time overlap tests of pairs of the built hull : b posed around a at 0.3 to 1.3 bounding radii (random rotations), then moved
+    // a little per frame so later frames reuse the cached axes. of the first 20 pairs of frame 0, separated ones are checked along
+    // their cached axis and overlapping ones against every axis (hulls of at most MAX_REFERENCE_VERTICES vertices)
+    // return : checked pairs that were wrong
+    size_t RunOverlap(const hull::Hull& hull, size_t count)
+    {
+        hull::SatShape shape(hull);
+        if (shape.PlaneCount() == 0) return 0;
+
+        float radius = 0;
+        for (const hull::Vec3& v : hull.vertices) radius = std::max(radius, hull::Length(v - hull.vertices[0]));
+
+        std::mt19937 engine(std::mt19937::default_seed);
+        std::normal_distribution<float> normal(0.0f, 1.0f);
+        std::uniform_real_distribution<float> uniform(0.3f, 1.3f);
+        struct Motion
+        {
+            float rotation[4];
+            float spin[4];
+            hull::Vec3 position;
+            hull::Vec3 velocity;
+        };
+        std::vector<Motion> motions(2 * count);
+        for (size_t i = 0; i < motions.size(); ++i)
+        {
+            Motion& motion = motions[i];
+            for (float& q : motion.rotation) q = normal(engine);
+            for (float& q : motion.spin) q = normal(engine);
+            hull::Vec3 direction = hull::Normalize({ normal(engine), normal(engine), normal(engine) });
+            motion.position = i % 2 == 0 ? hull::Vec3{ 0, 0, 0 } : direction * (radius * uniform(engine));
+            motion.velocity = hull::Vec3{ normal(engine), normal(engine), normal(engine) } * (radius * 0.002f);
+        }
+
+        std::vector<hull::Transform> transforms(motions.size());
+        auto Pose = [&](int frame)
+        {
+            for (size_t i = 0; i < motions.size(); ++i)
+            {
+                const Motion& motion = motions[i];
+                float q[4], length = 0;
+                for (int k = 0; k < 4; ++k)
+                {
+                    q[k] = motion.rotation[k] + 0.002f * frame * motion.spin[k];
+                    length += q[k] * q[k];
+                }
+                length = std::sqrt(length);
+                transforms[i] = MakeTransform(q[0] / length, q[1] / length, q[2] / length, q[3] / length, motion.position + motion.velocity * static_cast<float>(frame));
+            }
+        };
+
+        const hull::SatShape* shapes[] = { &shape };
+        std::vector<const hull::SatShape*> shapeList(motions.size(), shapes[0]);
+        std::vector<hull::OverlapPair> pairs(count);
+        for (size_t i = 0; i < count; ++i) pairs[i] = { static_cast<uint32_t>(2 * i), static_cast<uint32_t>(2 * i + 1) };
+        std::vector<hull::SatCache> caches(count);
+        std::vector<uint8_t> overlaps(count);
+
+        const int frames = 10;
+        double firstNs = 0, laterNs = 0;
+        size_t overlapCount = 0, wrong = 0, checked = 0;
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            Pose(frame);
+            auto start = std::chrono::steady_clock::now();
+            hull::TestOverlaps(shapeList.data(), transforms.data(), pairs.data(), count, caches.data(), overlaps.data());
+            double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+            if (frame > 0)
+            {
+                laterNs += ns / (frames - 1);
+                continue;
+            }
+
+            firstNs = ns;
+            for (size_t i = 0; i < count; ++i) overlapCount += overlaps[i];
+            for (size_t i = 0; i < std::min<size_t>(count, 20); ++i)
+            {
+                std::vector<hull::Vec3> a, b;
+                for (const hull::Vec3& v : hull.vertices)
+                {
+                    a.push_back(transforms[2 * i].Apply(v));
+                    b.push_back(transforms[2 * i + 1].Apply(v));
+                }
+
+                // separated : the cached axis must separate, overlapping : no axis may (small hulls only)
+                bool overlapping = overlaps[i] != 0;
+                if (!overlapping) wrong += !Separates(a, b, transforms[2 * i].Rotate(caches[i].axis));
+                else if (hull.vertices.size() <= MAX_REFERENCE_VERTICES) wrong += !ReferenceOverlap(hull, a, b);
+                else continue;
+                ++checked;
+            }
+        }
+
+        std::fprintf(stderr, "overlap : %zu planes, %zu edges, %zu / %zu pairs overlap, %.1f ns/pair cold, %.1f ns/pair cached (%zu / %zu checked wrong)\n",
+            shape.PlaneCount(), shape.EdgeCount(), overlapCount, count, firstNs, laterNs, wrong, checked);
+        return wrong;
+    }
+
+    // time ray clips of random rays from a sphere around hull towards random points in its bounds
+    // the first 10000 face plane results are checked against a double precision clip (grazing rays within rounding are not counted)
+    // return : checked results that were wrong
+    size_t RunRays(const hull::Hull& hull, const hull::PolygonHull* polygons, const Options& options)
+    {
+        if (hull.vertices.empty()) return 0;
+
+        hull::PlaneSet planes;
+        if (polygons) planes.Build(*polygons);
+        else planes.Build(hull);
+
+        hull::Vec3 lower = hull.vertices[0], upper = hull.vertices[0];
+        for (const hull::Vec3& v : hull.vertices)
+        {
+            lower = { std::min(lower.x, v.x), std::min(lower.y, v.y), std::min(lower.z, v.z) };
+            upper = { std::max(upper.x, v.x), std::max(upper.y, v.y), std::max(upper.z, v.z) };
+        }
+        hull::Vec3 center = (lower + upper) * 0.5f;
+        float radius = hull::Length(upper - lower);
+
+        std::mt19937 engine(std::mt19937::default_seed);
+        std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+        std::normal_distribution<float> normal(0.0f, 1.0f);
+        std::vector<hull::Ray> rays(options.rays);
+        for (hull::Ray& ray : rays)
+        {
+            hull::Vec3 side = { normal(engine), normal(engine), normal(engine) };
+            ray.origin = center + side * (radius / std::max(hull::Length(side), 1e-6f));
+            hull::Vec3 target = { lower.x + (upper.x - lower.x) * uniform(engine), lower.y + (upper.y - lower.y) * uniform(engine), lower.z + (upper.z - lower.z) * uniform(engine) };
+            ray.direction = target - ray.origin;
+        }
+
+        std::vector<hull::RayHit> hits(rays.size());
+        auto start = std::chrono::steady_clock::now();
+        planes.Intersect(rays.data(), rays.size(), options.build.threadCount, hits.data());
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        size_t hitCount = 0, mismatches = 0;
+        for (size_t i = 0; i < rays.size(); ++i)
+        {
+            hitCount += hits[i].Hit() ? 1 : 0;
+            if (polygons || i >= 10000) continue;
+
+            const hull::Ray& ray = rays[i];
+            double enter = ray.tMin, exit = ray.tMax;
+            for (size_t face = 0; face < hull.FaceCount(); ++face)
+            {
+                hull::Plane plane = hull.FacePlane(face);
+                double facing = double(plane.normal.x) * ray.direction.x + double(plane.normal.y) * ray.direction.y + double(plane.normal.z) * ray.direction.z;
+                double distance = double(plane.normal.x) * ray.origin.x + double(plane.normal.y) * ray.origin.y + double(plane.normal.z) * ray.origin.z - plane.offset;
+                if (facing < 0) enter = std::max(enter, -distance / facing);
+                else if (facing > 0) exit = std::min(exit, -distance / facing);
+                else if (distance > 0) enter = INFINITY;
+            }
+
+            const double tolerance = 1e-4;
+            if (enter <= exit && hits[i].Hit()) mismatches += std::abs(enter - hits[i].tEnter) > tolerance || std::abs(exit - hits[i].tExit) > tolerance ? 1 : 0;
+            else if (enter <= exit || hits[i].Hit()) mismatches += exit - enter > tolerance || hits[i].tExit - hits[i].tEnter > tolerance ? 1 : 0;
+        }
+
+        std::fprintf(stderr, "rays : %zu planes, %zu / %zu hit, %.1f ns/ray (%.1f M rays/s), %zu mismatches\n", planes.PlaneCount(), hitCount, rays.size(),
+            seconds * 1e9 / static_cast<double>(rays.size()), static_cast<double>(rays.size()) / seconds * 1e-6, mismatches);
+        return mismatches;
+    }
+
+    // print the mass properties of hull and the time they took, checked against a double precision sum over the faces
+    // (tetrahedra from the first vertex, relative error of the largest entry of each property)
+    void RunMass(const hull::Hull& hull, const Options& options)
+    {
+        hull::MassProperties properties;
+        auto start = std::chrono::steady_clock::now();
+        bool succeeded = hull::ComputeMassProperties(hull, properties, options.density, options.build.threadCount);
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        if (!succeeded)
+        {
+            std::fprintf(stderr, "mass : no volume\n");
+            return;
+        }
+
+        double volume = 0, first[3] = {}, second[3][3] = {};
+        const hull::Vec3& origin = hull.vertices[0];
+        for (size_t face = 0; face < hull.FaceCount(); ++face)
+        {
+            double corners[3][3];
+            for (int k = 0; k < 3; ++k)
+            {
+                const hull::Vec3& v = hull.vertices[hull.indices[3 * face + k]];
+                corners[k][0] = static_cast<double>(v.x) - origin.x;
+                corners[k][1] = static_cast<double>(v.y) - origin.y;
+                corners[k][2] = static_cast<double>(v.z) - origin.z;
+            }
+            const double* a = corners[0], * b = corners[1], * c = corners[2];
+            double det = a[0] * (b[1] * c[2] - b[2] * c[1]) + a[1] * (b[2] * c[0] - b[0] * c[2]) + a[2] * (b[0] * c[1] - b[1] * c[0]);
+            volume += det / 6;
+            for (int u = 0; u < 3; ++u)
+            {
+                double su = a[u] + b[u] + c[u];
+                first[u] += det * su / 24;
+                for (int v = 0; v < 3; ++v) second[u][v] += det * (a[u] * a[v] + b[u] * b[v] + c[u] * c[v] + su * (a[v] + b[v] + c[v])) / 120;
+            }
+        }
+
+        double centroid[3], inertia[3][3], centroidError = 0, inertiaError = 0, centroidScale = 0, inertiaScale = 0;
+        for (int u = 0; u < 3; ++u) centroid[u] = first[u] / volume;
+        for (int u = 0; u < 3; ++u)
+        {
+            for (int v = 0; v < 3; ++v) second[u][v] -= volume * centroid[u] * centroid[v];
+        }
+        for (int u = 0; u < 3; ++u)
+        {
+            for (int v = 0; v < 3; ++v) inertia[u][v] = options.density * ((u == v ? second[0][0] + second[1][1] + second[2][2] : 0) - second[u][v]);
+        }
+
+        const float* centroidOut = &properties.centroid.x;
+        double origins[3] = { origin.x, origin.y, origin.z };
+        for (int u = 0; u < 3; ++u)
+        {
+            centroidError = std::max(centroidError, std::abs(centroidOut[u] - (centroid[u] + origins[u])));
+            centroidScale = std::max(centroidScale, std::sqrt(std::abs(second[u][u]) / volume));
+            const float* row = &properties.inertia[u].x;
+            for (int v = 0; v < 3; ++v)
+            {
+                inertiaError = std::max(inertiaError, std::abs(row[v] - inertia[u][v]));
+                inertiaScale = std::max(inertiaScale, std::abs(inertia[u][v]));
+            }
+        }
+
+        std::fprintf(stderr, "volume : %g\nmass : %g\ncentroid : %g %g %g\n", properties.volume, properties.mass, properties.centroid.x, properties.centroid.y, properties.centroid.z);
+        for (int u = 0; u < 3; ++u) std::fprintf(stderr, "inertia : %g %g %g\n", properties.inertia[u].x, properties.inertia[u].y, properties.inertia[u].z);
+        std::fprintf(stderr, "mass properties : %.1f us (relative error : volume %.1e, centroid %.1e, inertia %.1e)\n", us,
+            std::abs(properties.volume - volume) / volume, centroidError / centroidScale, inertiaError / inertiaScale);
+    }
+
+    // return : vertices of inner more than tolerance in front of a face plane of outer (planes in double precision, a float
+    // plane through a face with a short edge misses its own far corner by more than the build tolerance)
+    size_t CountOutside(const hull::Hull& outer, const hull::Hull& inner, float tolerance)
+    {
+        struct DoublePlane
+        {
+            double x, y, z, offset;
+        };
+        std::vector<DoublePlane> planes(outer.FaceCount());
+        for (size_t face = 0; face < planes.size(); ++face)
+        {
+            const hull::Vec3& a = outer.vertices[outer.indices[3 * face]];
+            const hull::Vec3& b = outer.vertices[outer.indices[3 * face + 1]];
+            const hull::Vec3& c = outer.vertices[outer.indices[3 * face + 2]];
+            double abx = double(b.x) - a.x, aby = double(b.y) - a.y, abz = double(b.z) - a.z;
+            double acx = double(c.x) - a.x, acy = double(c.y) - a.y, acz = double(c.z) - a.z;
+            double x = aby * acz - abz * acy, y = abz * acx - abx * acz, z = abx * acy - aby * acx;
+            double length = std::sqrt(x * x + y * y + z * z);
+            if (length == 0) length = 1;
+            planes[face] = { x / length, y / length, z / length, (x * a.x + y * a.y + z * a.z) / length };
+        }
+
+        size_t outside = 0;
+        for (const hull::Vec3& v : inner.vertices)
+        {
+            for (const DoublePlane& plane : planes)
+            {
+                if (plane.x * v.x + plane.y * v.y + plane.z * v.z - plane.offset <= tolerance) continue;
+                ++outside;
+                break;
+            }
+        }
+        return outside;
+    }
+
+    // check hull, built from points another way (incremental, streamed, welded within slack), against a one-shot build :
+    // each hull vertex is the input point of its source index and lies on or inside the one-shot hull, the one-shot hull lies
+    // inside hull grown by slack (2 plane tolerances of rounding on both sides)
+    // return : vertices that fail
+    size_t CheckAgainstBuild(const hull::Hull& hull, const std::vector<hull::Vec3>& points, float slack)
+    {
+        hull::Hull reference;
+        if (!hull::CreateConvexHull(points, reference)) return 0;
+
+        hull::Vec3 maxAbs = {};
+        for (const hull::Vec3& v : reference.vertices) maxAbs = { std::max(maxAbs.x, std::abs(v.x)), std::max(maxAbs.y, std::abs(v.y)), std::max(maxAbs.z, std::abs(v.z)) };
+        float tolerance = 2 * hull::PlaneTolerance(maxAbs);
+
+        size_t sourceWrong = 0;
+        for (size_t i = 0; i < hull.vertices.size(); ++i)
+        {
+            uint32_t source = i < hull.sourceIndices.size() ? hull.sourceIndices[i] : ~0u;
+            bool same = source < points.size() && points[source].x == hull.vertices[i].x && points[source].y == hull.vertices[i].y && points[source].z == hull.vertices[i].z;
+            sourceWrong += same ? 0 : 1;
+        }
+        size_t outsideWrong = CountOutside(reference, hull, tolerance);
+        size_t missedWrong = CountOutside(hull, reference, tolerance + slack);
+
+        std::fprintf(stderr, "reference : %zu vertices, %zu / %zu / %zu checked wrong (source, outside, missed)\n", reference.vertices.size(), sourceWrong, outsideWrong, missedWrong);
+        return sourceWrong + outsideWrong + missedWrong;
+    }
+
+    // return : hull of points inserted options.incremental at a time
+    bool RunIncremental(const Options& options, const std::vector<hull::Vec3>& points, hull::Hull& hull)
+    {
+        hull::IncrementalHull incremental(options.build.threadCount);
+
+        std::vector<hull::Vec3> batch;
+        size_t insertCount = 0;
+        for (size_t begin = 0; begin < points.size(); begin += options.incremental)
+        {
+            batch.assign(points.begin() + begin, points.begin() + std::min(points.size(), begin + options.incremental));
+            incremental.Insert(batch);
+            ++insertCount;
+        }
+
+        std::fprintf(stderr, "inserts : %zu\n", insertCount);
+
+        incremental.GetHull(hull);
+        return incremental.IsValid();
+    }
+
+    void PrintCache(const hull::HullCache* cache)
+    {
+        if (!cache) return;
+        std::fprintf(stderr, "cache hits : %zu\ncache misses : %zu\ncache evictions : %zu\ncache size : %llu\n", cache->HitCount(), cache->MissCount(), cache->EvictionCount(), static_cast<unsigned long long>(cache->Size()));
+    }
+
+    // build on the pool as a job (deadline, progress)
+    hull::HullJobResult RunJob(const Options& options, std::vector<hull::Vec3> points, hull::ThreadPool& pool, hull::HullJob::Clock::time_point start)
+    {
+        auto deadline = options.deadline > 0 ? start + std::chrono::milliseconds(options.deadline) : hull::HullJob::Clock::time_point::max();
+
+        hull::HullJob job(std::move(points), options.build, deadline, pool);
+        std::future<hull::HullJobResult>& future = job.Result();
+        if (options.progress)
+        {
+            while (future.wait_for(std::chrono::milliseconds(100)) != std::future_status::ready)
+            {
+                const hull::BuildProgress& progress = job.Progress();
+                std::fprintf(stderr, "remaining : %zu faces : %zu\n", progress.remainingPoints.load(), progress.faceCount.load());
+            }
+        }
+        return future.get();
+    }
+
+    int RunBatch(const Options& options, const hull::PointsView& input, hull::ThreadPool& pool, hull::HullCache* cache)
+    {
+        // synthetic : one cloud per seed, otherwise every mesh views the input
+        std::vector<std::vector<hull::Vec3>> clouds(options.synthetic.empty() ? 0 : options.batch);
+        for (size_t i = 0; i < clouds.size(); ++i)
+        {
+            GeneratePoints(options.synthetic, options.syntheticCount, clouds[i], static_cast<unsigned>(i));
+        }
+
+        std::vector<hull::PointsView> meshes(options.batch);
+        for (size_t i = 0; i < meshes.size(); ++i)
+        {
+            meshes[i] = clouds.empty() ? input : hull::PointsView(clouds[i]);
+        }
+
+        hull::BatchOptions batchOptions;
+        batchOptions.build = options.build;
+        batchOptions.cache = cache;
+
+        std::vector<hull::HullJobResult> results;
+        hull::BatchStats stats = hull::CreateConvexHulls(meshes, results, batchOptions, pool);
+
+        size_t faceCount = 0;
+        for (const hull::HullJobResult& result : results) faceCount += result.hull.FaceCount();
+
+        std::fprintf(stderr, "meshes : %zu\npoints : %zu\nfailed : %zu\nfaces : %zu\nsimd : %s\nthreads : %u\nmeshes/s : %.1f\npoints/s : %.0f\nelapsed : %.0f ms\n", stats.meshCount, stats.pointCount, stats.failedCount, faceCount, hull::ToString(hull::GetSimdLevel()), pool.ThreadCount(), stats.MeshesPerSecond(), stats.PointsPerSecond(), stats.seconds * 1000);
+        PrintCache(cache);
+
+        if (!options.output.empty())
+        {
+            std::vector<hull::Hull> hulls(results.size());
+            for (size_t i = 0; i < results.size(); ++i) hulls[i] = std::move(results[i].hull);
+            if (!hull::WriteHullFile(options.output, hulls))
+            {
+                std::fprintf(stderr, "cannot write %s\n", options.output.c_str());
+                return 1;
+            }
+        }
+
+        return stats.failedCount == 0 ? 0 : 1;
+    }
+
+    // hull of the input file read options.stream points at a time
+    int RunStream(const Options& options)
+    {
+        hull::StreamOptions streamOptions;
+        streamOptions.threadCount = options.build.threadCount;
+        streamOptions.chunkPoints = options.stream;
+
+        hull::Hull hull;
+        hull::StreamStats stats;
+        bool succeeded = hull::CreateConvexHullFromFile(options.input, hull, streamOptions, &stats);
+
+        std::fprintf(stderr, "points : %zu\nchunks : %zu\npeak stored : %zu\nskipped lines : %zu\nvertices : %zu\nfaces : %zu\nthreads : %u\npoints/s : %.0f\nread wait : %.0f ms\nelapsed : %.0f ms\n", stats.pointCount, stats.chunkCount, stats.peakStoredPoints, stats.skippedLines, hull.vertices.size(), hull.FaceCount(), hull::ResolveThreadCount(options.build.threadCount), stats.PointsPerSecond(), stats.readSeconds * 1000, stats.seconds * 1000);
+
+        if (!succeeded)
+        {
+            std::fprintf(stderr, "convex hull creation failed\n");
+            return 1;
+        }
+
+        // the whole file read at once (stream text and raw parse as the loader does)
+        size_t wrong = 0;
+        hull::PointCloudFile cloud;
+        if (cloud.Open(options.input, options.build.threadCount))
+        {
+            std::vector<hull::Vec3> points;
+            cloud.Points().CopyTo(points);
+            wrong = CheckAgainstBuild(hull, points, 0);
+        }
+
+        bool written = WriteOutput(options.output.empty() ? nullptr : options.output.c_str(), hull);
+        return written && wrong == 0 ? 0 : 1;
+    }
+
+    // map a hull file and write its first hull
+    int RunMapped(const Options& options)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        hull::MappedHullFile file;
+        if (!file.Open(options.input))
+        {
+            std::fprintf(stderr, "cannot map %s\n", options.input.c_str());
+            return 1;
+        }
+        auto opened = std::chrono::steady_clock::now();
+
+        size_t faceCount = 0;
+        for (size_t i = 0; i < file.HullCount(); ++i) faceCount += file.GetHull(i).FaceCount();
+        bool verified = file.Verify();
+
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::fprintf(stderr, "hulls : %zu\nfaces : %zu\nbytes : %zu\nverified : %s\nopen : %.3f ms\nelapsed : %.3f ms\n", file.HullCount(), faceCount, file.Size(), verified ? "yes" : "no", std::chrono::duration<double, std::milli>(opened - start).count(), elapsed);
+
+        if (!verified || file.HullCount() == 0) return 1;
+
+        hull::Hull hull;
+        file.GetHull(0).CopyTo(hull);
+        return WriteOutput(options.output.empty() ? nullptr : options.output.c_str(), hull) ? 0 : 1;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!ParseArguments(argc, argv, options))
+    {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+
+    if (!options.simd.empty())
+    {
+        hull::SimdLevel level = hull::SimdLevel::Scalar;
+        if (options.simd == "avx2") level = hull::SimdLevel::AVX2;
+        else if (options.simd == "sse4.1") level = hull::SimdLevel::SSE41;
+        hull::SetSimdLevel(level);
+    }
+
+    if (options.mergeTolerance >= 0 && IsHullFile(options.output))
+    {
+        std::fprintf(stderr, "merged polygons are written as obj only\n");
+        return 2;
+    }
+
+    if (options.synthetic.empty() && IsHullFile(options.input)) return RunMapped(options);
+    if (options.stream > 0) return RunStream(options);
+
+    // input : synthetic points, or a mapped file (batch meshes view it in place, the other builds copy it)
+    std::vector<hull::Vec3> points;
+    hull::PointCloudFile cloud;
+    if (!options.synthetic.empty())
+    {
+        if (!GeneratePoints(options.synthetic, options.syntheticCount, points))
+        {
+            std::fprintf(stderr, "unknown synthetic cloud %s\n", options.synthetic.c_str());
+            return 2;
+        }
+    }
+    else
+    {
+        auto loadStart = std::chrono::steady_clock::now();
+        if (!cloud.Open(options.input, options.build.threadCount))
+        {
+            std::fprintf(stderr, "cannot read %s\n", options.input.c_str());
+            return 1;
+        }
+        auto loaded = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+        std::fprintf(stderr, "load : %.1f ms (%s)\n", loaded, cloud.IsInPlace() ? "in place" : "parsed");
+
+        if (options.batch == 0) cloud.Points().CopyTo(points);
+    }
+
+    // builds run on a pool of --threads workers
+    hull::ThreadPool pool(hull::ResolveThreadCount(options.build.threadCount));
+
+    std::optional<hull::HullCache> cache;
+    if (!options.cache.empty())
+    {
+        cache.emplace(options.cache);
+        if (!cache->IsValid())
+        {
+            std::fprintf(stderr, "cannot use cache directory %s\n", options.cache.c_str());
+            return 1;
+        }
+    }
+
+    if (options.batch > 0) return RunBatch(options, options.synthetic.empty() ? cloud.Points() : hull::PointsView(points), pool, cache ? &*cache : nullptr);
+
+    const char* outputPath = options.output.empty() ? nullptr : options.output.c_str();
+
+    auto start = std::chrono::steady_clock::now();
+
+    if (options.incremental > 0)
+    {
+        hull::Hull hull;
+        bool succeeded = RunIncremental(options, points, hull);
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        std::fprintf(stderr, "points : %zu\nvertices : %zu\nfaces : %zu\nelapsed : %lld ms\n", points.size(), hull.vertices.size(), hull.FaceCount(), static_cast<long long>(elapsed));
+
+        if (!succeeded)
+        {
+            std::fprintf(stderr, "convex hull creation failed\n");
+            return 1;
+        }
+
+        size_t wrong = CheckAgainstBuild(hull, points, 0);
+        bool written = WriteOutput(outputPath, hull);
+        return written && wrong == 0 ? 0 : 1;
+    }
+
+    size_t pointCount = points.size();
+
+    // a welded build (not simplified) is checked against the hull of every point
+    std::vector<hull::Vec3> weldInput;
+    if (options.build.weld && options.build.maxVertices == 0 && options.build.maxError == 0) weldInput = points;
+
+    hull::HullJobResult result;
+    hull::HullKey key = cache ? hull::HashHullInput(points, options.build) : hull::HullKey{};
+    if (cache && cache->Load(key, result.hull))
+    {
+        result.succeeded = true;
+    }
+    else
+    {
+        result = RunJob(options, std::move(points), pool, start);
+        if (cache && result.succeeded) cache->Store(key, result.hull);
+    }
+
+    const hull::Hull& hull = result.hull;
+    const hull::BuildStats& stats = result.stats;
+    bool succeeded = result.succeeded;
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+    std::fprintf(stderr, "status : %s\npoints : %zu\nwelded : %zu\nculled : %zu\nvertices : %zu\nfaces : %zu\nhausdorff : %g\ninflation : %g\nsimd : %s\nthreads : %u\nexact orient3d : %llu\nelapsed : %lld ms\n", hull::ToString(stats.status), pointCount, stats.weldedCount, stats.culledCount, hull.vertices.size(), hull.FaceCount(), stats.hausdorffError, stats.inflation, hull::ToString(hull::GetSimdLevel()), hull::ResolveThreadCount(options.build.threadCount), hull::ExactOrient3DCount(), static_cast<long long>(elapsed));
+    PrintCache(cache ? &*cache : nullptr);
+
+    if (!succeeded)
+    {
+        std::fprintf(stderr, "convex hull creation failed\n");
+        return 1;
+    }
+
+    hull::PolygonHull polygons;
+    if (options.mergeTolerance >= 0 && !MergeFaces(hull, options, polygons)) return 1;
+
+    // checked results that were wrong, any fails the run
+    size_t wrong = 0;
+    if (!weldInput.empty()) wrong += CheckAgainstBuild(hull, weldInput, options.build.weldTolerance);
+    if (options.support > 0) wrong += RunSupport(hull, options.support);
+    if (options.contains > 0) wrong += RunContains(hull, options.mergeTolerance >= 0 ? &polygons : nullptr, options);
+    if (options.distance > 0) wrong += RunDistance(hull, options.distance);
+    if (options.overlap > 0) wrong += RunOverlap(hull, options.overlap);
+    if (options.rays > 0) wrong += RunRays(hull, options.mergeTolerance >= 0 ? &polygons : nullptr, options);
+    if (options.density > 0) RunMass(hull, options);
+
+    bool written = options.mergeTolerance >= 0 ? WritePolygons(outputPath, polygons) : WriteOutput(outputPath, hull);
+    return written && wrong == 0 ? 0 : 1;
+}
@@ -0,0 +1,1596 @@
+#include "HullCore.hpp"
+
+#include "CubeMap.hpp"
+#include "HalfEdgeMesh.hpp"
+#include "Parallel.hpp"
+#include "PlaneKernels.hpp"
+#include "PointSoA.hpp"
+#include "Predicates.hpp"
+#include "Prefilter.hpp"
+#include "ThreadPool.hpp"
+#include "Weld.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+
+namespace hull
+{
+
+namespace
+{
+    // point index + value of a furthest point search (first index wins ties)
+    struct Furthest
+    {
+        uint32_t index;
+        float value;
+    };
+
+    void FoldFurthest(Furthest& result, const Furthest& partial)
+    {
+        if (partial.value > result.value) result = partial;
+    }
+
+    // cells per cube map side of the incremental start faces
+    constexpr int START_RESOLUTION = 16;
+
+    // lexicographic (x, y, z) order
+    bool LessXYZ(const Vec3& a, const Vec3& b)
+    {
+        return a.x < b.x
+            || ((a.x == b.x)
+                && ((a.y < b.y)
+                    || (a.y == b.y && a.z < b.z)));
+    }
+
+    // lexicographic min / max points, bounding box and per-axis max |coordinate|
+    struct Extents
+    {
+        uint32_t min;
+        uint32_t max;
+        Vec3 lower;
+        Vec3 upper;
+        Vec3 maxAbs;
+    };
+
+    Extents FindExtents(const PointsView& view, size_t begin, size_t end)
+    {
+        return view.Dispatch([&](const auto& points)
+        {
+            Extents extents = { static_cast<uint32_t>(begin), static_cast<uint32_t>(begin), points[begin], points[begin], { 0, 0, 0 } };
+            for (size_t i = begin; i < end; ++i)
+            {
+                const Vec3& p = points[i];
+                if (LessXYZ(p, points[extents.min])) extents.min = static_cast<uint32_t>(i);
+                if (LessXYZ(points[extents.max], p)) extents.max = static_cast<uint32_t>(i);
+
+                extents.lower = { std::min(extents.lower.x, p.x), std::min(extents.lower.y, p.y), std::min(extents.lower.z, p.z) };
+                extents.upper = { std::max(extents.upper.x, p.x), std::max(extents.upper.y, p.y), std::max(extents.upper.z, p.z) };
+
+                Vec3& maxAbs = extents.maxAbs;
+                maxAbs = { std::max(maxAbs.x, std::abs(p.x)), std::max(maxAbs.y, std::abs(p.y)), std::max(maxAbs.z, std::abs(p.z)) };
+            }
+            return extents;
+        });
+    }
+
+    // return : point with the largest squared distance from the line through origin along unit direction (first if none > 0)
+    Furthest FindFurthestFromLine(const PointsView& view, const Vec3& origin, const Vec3& direction, uint32_t first, size_t begin, size_t end)
+    {
+        return view.Dispatch([&](const auto& points)
+        {
+            Furthest furthest = { first, 0 };
+            for (size_t i = begin; i < end; ++i)
+            {
+                Vec3 vec = points[i] - origin;
+                float along = Dot(direction, vec);
+                float lenSq = LengthSq(vec) - along * along;
+                if (lenSq > furthest.value)
+                {
+                    furthest = { static_cast<uint32_t>(i), lenSq };
+                }
+            }
+            return furthest;
+        });
+    }
+
+    // return : point with the largest plane distance in [begin, end) (points are transposed to soa per block)
+    Furthest FindFurthest(const PointsView& points, const Plane& plane, size_t begin, size_t end)
+    {
+        PointSoA block;
+        Furthest furthest = { 0, -FLT_MAX };
+        for (size_t blockBegin = begin; blockBegin < end; blockBegin += BLOCK_SIZE)
+        {
+            block.AssignRange(points, blockBegin, std::min(BLOCK_SIZE, end - blockBegin));
+
+            float distance;
+            size_t i = ArgMaxDistance(plane, block.x.data(), block.y.data(), block.z.data(), block.Size(), &distance);
+            if (distance > furthest.value)
+            {
+                furthest = { block.index[i], distance };
+            }
+        }
+        return furthest;
+    }
+
+    // soa block + partition outputs for the batch kernels (one per worker)
+    struct AssignBuffers
+    {
+        PointSoA block;
+        uint32_t aboveIndices[BLOCK_SIZE + PARTITION_PADDING];
+        float aboveDistances[BLOCK_SIZE + PARTITION_PADDING];
+    };
+
+    // conflict lists collected by one worker for a face range, merged into the FaceInfo afterwards
+    struct PartialOutside
+    {
+        std::vector<std::vector<uint32_t>> outside;
+        std::vector<Furthest> furthest;
+
+        void Reset(size_t faceCount)
+        {
+            if (this->outside.size() < faceCount) this->outside.resize(faceCount);
+            for (size_t i = 0; i < faceCount; ++i) this->outside[i].clear();
+            this->furthest.assign(faceCount, { 0, 0 });
+        }
+
+        void Add(size_t slot, const uint32_t* indices, const float* distances, size_t count)
+        {
+            size_t i = std::max_element(distances, distances + count) - distances;
+            if (this->outside[slot].empty() || distances[i] > this->furthest[slot].value)
+            {
+                this->furthest[slot] = { indices[i], distances[i] };
+            }
+            this->outside[slot].insert(this->outside[slot].end(), indices, indices + count);
+        }
+    };
+
+    // faces flooded by a LocateFace walk : stamps[face] == stamp (stamp advances once per flood)
+    struct WalkStamps
+    {
+        std::vector<uint32_t> stamps;
+        uint32_t stamp = 0;
+        std::vector<uint32_t> flood;
+    };
+
+    // coarse stop test of a BuildControl (cancel request, deadline), safe to call from worker threads
+    class StopCheck
+    {
+    public:
+        explicit StopCheck(const BuildControl* control_) : control(control_), status(BuildStatus::Succeeded) {}
+
+        // return : true if the build must stop
+        bool operator()()
+        {
+            if (!this->control) return false;
+            if (this->control->stopToken.stop_requested())
+            {
+                this->status = BuildStatus::Cancelled;
+                return true;
+            }
+            if (this->control->deadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() >= this->control->deadline)
+            {
+                this->status = BuildStatus::TimedOut;
+                return true;
+            }
+            return false;
+        }
+
+        // Succeeded until a stop was seen
+        BuildStatus Status() const { return this->status; }
+
+    private:
+        const BuildControl* control;
+        std::atomic<BuildStatus> status;
+    };
+
+    // conflict data of a mesh face (points that see the face)
+    struct FaceInfo
+    {
+        std::vector<uint32_t> outside;
+        uint32_t furthest;
+        float furthestDistance;
+
+        // iteration stamp of the last visibility test and its result
+        uint32_t mark;
+        bool visible;
+    };
+
+    class QuickHullBuilder
+    {
+    public:
+        QuickHullBuilder(const PointsView& points_, float tolerance_, unsigned workerCount_)
+            : points(points_), tolerance(tolerance_), workerCount(workerCount_), mesh(), infos(), pending(), outsideCount(0), iteration(0), buffers(1), partials(), center{ 0, 0, 0 }, scales(), startFaces(), walks()
+        {}
+
+        // create first tetrahedron (a, b, c, d : a, b, c clockwise seen from outside, d below)
+        void InitTetrahedron(uint32_t a, uint32_t b, uint32_t c, uint32_t d)
+        {
+            uint32_t f0 = this->AddFace(a, b, c);
+            uint32_t f1 = this->AddFace(b, a, d);
+            uint32_t f2 = this->AddFace(c, b, d);
+            uint32_t f3 = this->AddFace(c, d, a);
+            uint32_t faces[4] = { f0, f1, f2, f3 };
+
+            // link twins (each of the 6 edges appears once in each direction)
+            for (uint32_t fi : faces)
+            {
+                for (int i = 0; i < 3; ++i)
+                {
+                    uint32_t edge = HalfEdgeMesh::EdgeOf(fi, i);
+                    for (uint32_t fj : faces)
+                    {
+                        for (int j = 0; j < 3; ++j)
+                        {
+                            uint32_t other = HalfEdgeMesh::EdgeOf(fj, j);
+                            if (this->mesh.Origin(edge) == this->mesh.Destination(other) && this->mesh.Destination(edge) == this->mesh.Origin(other))
+                            {
+                                this->mesh.Link(edge, other);
+                            }
+                        }
+                    }
+                }
+            }
+
+            // every point goes to the first face it sees
+            // (the tetrahedron's own vertices are on or below every face, so they stay unassigned)
+            this->AssignPoints(this->points.count, faces, faces + 4, [this](PointSoA& block, size_t begin, size_t count)
+            {
+                block.AssignRange(this->points, begin, count);
+            });
+
+            for (uint32_t face : faces) this->PushIfPending(face);
+        }
+
+        // assign points [begin, end) to the faces they see (incremental insert), points inside the hull are dropped.
+        // each point is located by LocateFace (needs SetCenter), not tested against every face, so the cost does not grow with the hull.
+        void InsertPoints(size_t begin, size_t end)
+        {
+            size_t count = end - begin;
+            std::vector<Furthest> located(count);
+
+            uint32_t anyFace = 0;
+            while (!this->mesh.IsAlive(anyFace)) ++anyFace;
+
+            size_t chunkCount = ChunkCount(count, this->workerCount, MIN_PARALLEL_POINTS);
+            if (this->walks.size() < chunkCount) this->walks.resize(chunkCount);
+
+            ParallelChunks(count, chunkCount, [&](size_t chunk, size_t chunkBegin, size_t chunkEnd)
+            {
+                WalkStamps& walk = this->walks[chunk];
+                walk.stamps.resize(this->mesh.FaceCapacity(), 0);
+
+                uint32_t face = anyFace;
+                for (size_t i = chunkBegin; i < chunkEnd; ++i)
+                {
+                    const Vec3& p = this->points[begin + i];
+                    located[i] = this->LocateFace(p, this->StartFace(p, face), walk);
+                    face = located[i].index;
+                }
+            });
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (located[i].value <= this->tolerance) continue;
+
+                uint32_t face = located[i].index;
+                bool wasEmpty = this->infos[face].outside.empty();
+                this->AddOutside(face, static_cast<uint32_t>(begin + i), located[i].value);
+                if (wasEmpty) this->pending.push_back(face);
+            }
+        }
+
+        // add furthest points until no face has outside points
+        // stop and progress are checked every CHECK_INTERVAL added points (progress is null for sub-hulls)
+        // return : false if stopped
+        bool Run(StopCheck& stop, BuildProgress* progress)
+        {
+            constexpr uint32_t CHECK_INTERVAL = 256;
+            for (uint32_t step = 0; !this->pending.empty(); ++step)
+            {
+                if (step % CHECK_INTERVAL == 0)
+                {
+                    if (progress)
+                    {
+                        progress->remainingPoints.store(this->outsideCount, std::memory_order_relaxed);
+                        progress->faceCount.store(this->mesh.FaceCount(), std::memory_order_relaxed);
+                    }
+                    if (stop()) return false;
+                }
+
+                uint32_t face = this->pending.back();
+                this->pending.pop_back();
+
+                if (!this->mesh.IsAlive(face) || this->infos[face].outside.empty()) continue;
+
+                this->AddPoint(face, this->infos[face].furthest);
+            }
+            return true;
+        }
+
+        // add the furthest point over all faces first, until the hull has maxVertices vertices (0 : no limit)
+        // or no point is more than maxError above its face. stop is checked every CHECK_INTERVAL added points.
+        // return : false if stopped
+        bool RunFurthestFirst(uint32_t maxVertices, float maxError, StopCheck& stop)
+        {
+            constexpr uint32_t CHECK_INTERVAL = 256;
+
+            // faces by furthest distance (ties : lowest face), entries of faces that changed since are skipped
+            auto lower = [](const Furthest& a, const Furthest& b) { return a.value != b.value ? a.value < b.value : a.index > b.index; };
+            std::vector<Furthest> heap;
+            auto flushPending = [&]()
+            {
+                for (uint32_t face : this->pending)
+                {
+                    if (!this->mesh.IsAlive(face) || this->infos[face].outside.empty()) continue;
+                    heap.push_back({ face, this->infos[face].furthestDistance });
+                    std::push_heap(heap.begin(), heap.end(), lower);
+                }
+                this->pending.clear();
+            };
+
+            // resumed runs start from every face with outside points
+            this->pending.clear();
+            for (uint32_t face = 0; face < this->mesh.FaceCapacity(); ++face) this->pending.push_back(face);
+            flushPending();
+            for (uint32_t step = 0; !heap.empty(); ++step)
+            {
+                if (step % CHECK_INTERVAL == 0 && stop()) return false;
+
+                std::pop_heap(heap.begin(), heap.end(), lower);
+                Furthest top = heap.back();
+                heap.pop_back();
+
+                const FaceInfo& info = this->infos[top.index];
+                if (!this->mesh.IsAlive(top.index) || info.outside.empty() || info.furthestDistance != top.value) continue;
+                if ((maxVertices > 0 && this->VertexCount() >= maxVertices) || top.value <= maxError) break;
+
+                this->AddPoint(top.index, info.furthest);
+                flushPending();
+            }
+            return true;
+        }
+
+        // compact alive faces into an indexed triangle list
+        void GetHull(Hull& hull) const
+        {
+            hull.Clear();
+            hull.indices.reserve(this->mesh.FaceCount() * 3);
+
+            std::vector<uint32_t> remap(this->points.count, HalfEdgeMesh::INVALID);
+            for (uint32_t face = 0; face < this->mesh.FaceCapacity(); ++face)
+            {
+                if (!this->mesh.IsAlive(face)) continue;
+                for (uint32_t index : this->mesh.GetFace(face).v)
+                {
+                    if (remap[index] == HalfEdgeMesh::INVALID)
+                    {
+                        remap[index] = static_cast<uint32_t>(hull.vertices.size());
+                        hull.vertices.push_back(this->points[index]);
+                        hull.sourceIndices.push_back(index);
+                    }
+                    hull.indices.push_back(remap[index]);
+                }
+            }
+        }
+
+        void SetTolerance(float tolerance_) { this->tolerance = tolerance_; }
+
+        uint32_t FaceCount() const { return this->mesh.FaceCount(); }
+
+        // vertices of a closed triangle mesh of genus 0
+        uint32_t VertexCount() const { return this->mesh.FaceCount() / 2 + 2; }
+
+        // return : flag per point, set for hull vertices
+        std::vector<uint8_t> UsedVertices() const
+        {
+            std::vector<uint8_t> used(this->points.count, 0);
+            for (uint32_t face = 0; face < this->mesh.FaceCapacity(); ++face)
+            {
+                if (!this->mesh.IsAlive(face)) continue;
+                for (uint32_t index : this->mesh.GetFace(face).v) used[index] = 1;
+            }
+            return used;
+        }
+
+        // points were moved or appended to (incremental insert), the view has to follow them
+        void SetPoints(const PointsView& points_)
+        {
+            this->points = points_;
+        }
+
+        // renumber face vertices after the point array was compacted (remap : old index -> new index)
+        // only valid between runs (no conflict lists)
+        void RemapVertices(const std::vector<uint32_t>& remap)
+        {
+            for (uint32_t face = 0; face < this->mesh.FaceCapacity(); ++face)
+            {
+                if (!this->mesh.IsAlive(face)) continue;
+                for (uint32_t& index : this->mesh.GetFace(face).v) index = remap[index];
+            }
+        }
+
+        // interior point : mean face corner
+        Vec3 MeanCorner() const
+        {
+            Vec3 center = { 0, 0, 0 };
+            for (uint32_t face = 0; face < this->mesh.FaceCapacity(); ++face)
+            {
+                if (!this->mesh.IsAlive(face)) continue;
+                for (uint32_t index : this->mesh.GetFace(face).v) center += this->points[index];
+            }
+            return center / static_cast<float>(this->mesh.FaceCount() * 3);
+        }
+
+        // interior reference point of LocateFace : caches the face scales and start faces,
+        // faces added later are cached by AddFace (the hull only grows, so center stays inside)
+        // return : distance of center to the nearest face plane
+        float SetCenter(const Vec3& center_)
+        {
+            this->center = center_;
+            this->scales.assign(this->mesh.FaceCapacity(), 0);
+            this->startFaces.assign(6 * START_RESOLUTION * START_RESOLUTION, HalfEdgeMesh::INVALID);
+
+            float radius = FLT_MAX;
+            for (uint32_t face = 0; face < this->mesh.FaceCapacity(); ++face)
+            {
+                if (!this->mesh.IsAlive(face)) continue;
+                radius = std::min(radius, -this->mesh.GetFace(face).plane.Distance(this->center));
+                this->CacheStart(face);
+            }
+            return radius;
+        }
+
+        // face with the largest scaled distance (plane distance / distance of the ball center to the plane) of p,
+        // found by hill climbing over twins from start.
+        // the scaled distance + 1 is linear in the dual vertex of the face, so a local maximum is the global one
+        // and p is outside the hull if and only if that face sees it. coplanar (equal within tolerance) neighbors are flooded.
+        // return : face and its plane distance
+        Furthest LocateFace(const Vec3& p, uint32_t start, WalkStamps& walk) const
+        {
+            std::vector<uint32_t>& stamps = walk.stamps;
+            uint32_t& stamp = walk.stamp;
+
+            uint32_t best = start;
+            float bestScore = this->mesh.GetFace(best).plane.Distance(p) * this->scales[best];
+
+            std::vector<uint32_t>& flood = walk.flood;
+            for (;;)
+            {
+                bool improved = false;
+                flood.assign(1, best);
+                if (++stamp == 0)
+                {
+                    std::fill(stamps.begin(), stamps.end(), 0);
+                    stamp = 1;
+                }
+                stamps[best] = stamp;
+                for (size_t i = 0; i < flood.size() && !improved; ++i)
+                {
+                    for (int j = 0; j < 3; ++j)
+                    {
+                        uint32_t neighbor = HalfEdgeMesh::FaceOf(this->mesh.Twin(HalfEdgeMesh::EdgeOf(flood[i], j)));
+                        float distance = this->mesh.GetFace(neighbor).plane.Distance(p);
+                        float score = distance * this->scales[neighbor];
+                        if (score > bestScore && stamps[neighbor] != stamp)
+                        {
+                            best = neighbor;
+                            bestScore = score;
+                            improved = true;
+                            break;
+                        }
+                        if (stamps[neighbor] != stamp && (distance + this->tolerance) * this->scales[neighbor] >= bestScore)
+                        {
+                            stamps[neighbor] = stamp;
+                            flood.push_back(neighbor);
+                        }
+                    }
+                }
+                if (!improved) break;
+            }
+
+            return { best, this->mesh.GetFace(best).plane.Distance(p) };
+        }
+
+    private:
+
+        uint32_t AddFace(uint32_t v0, uint32_t v1, uint32_t v2)
+        {
+            uint32_t face = this->mesh.AddFace(v0, v1, v2);
+            if (this->infos.size() < this->mesh.FaceCapacity()) this->infos.resize(this->mesh.FaceCapacity());
+
+            this->mesh.GetFace(face).plane = Plane::FromTriangle(this->points[v0], this->points[v1], this->points[v2]);
+            if (!this->startFaces.empty()) this->CacheStart(face);
+
+            FaceInfo& info = this->infos[face];
+            info.outside.clear();
+            info.furthest = 0;
+            info.furthestDistance = 0;
+            info.mark = 0;
+            info.visible = false;
+            return face;
+        }
+
+        // scale and start cell of a face for LocateFace (the last face of a direction cell wins)
+        void CacheStart(uint32_t face)
+        {
+            if (this->scales.size() < this->mesh.FaceCapacity()) this->scales.resize(this->mesh.FaceCapacity());
+
+            const Plane& plane = this->mesh.GetFace(face).plane;
+            this->scales[face] = 1 / std::max(-plane.Distance(this->center), FLT_MIN);
+            this->startFaces[CubeMapCell(plane.normal, START_RESOLUTION)] = face;
+        }
+
+        // return : start face of a walk to p, the face of the direction cell of p or previous, whichever is closer
+        uint32_t StartFace(const Vec3& p, uint32_t previous) const
+        {
+            uint32_t toward = this->startFaces[CubeMapCell(p - this->center, START_RESOLUTION)];
+            if (toward == HalfEdgeMesh::INVALID || !this->mesh.IsAlive(toward)) return previous;
+            if (!this->mesh.IsAlive(previous)) return toward;
+
+            float towardScore = this->mesh.GetFace(toward).plane.Distance(p) * this->scales[toward];
+            float previousScore = this->mesh.GetFace(previous).plane.Distance(p) * this->scales[previous];
+            return towardScore > previousScore ? toward : previous;
+        }
+
+        void ResetFurthest(uint32_t face)
+        {
+            FaceInfo& info = this->infos[face];
+            const Plane& plane = this->mesh.GetFace(face).plane;
+            info.furthestDistance = 0;
+            for (uint32_t index : info.outside)
+            {
+                float distance = plane.Distance(this->points[index]);
+                if (distance > info.furthestDistance)
+                {
+                    info.furthest = index;
+                    info.furthestDistance = distance;
+                }
+            }
+        }
+
+        void PushIfPending(uint32_t face)
+        {
+            if (!this->infos[face].outside.empty()) this->pending.push_back(face);
+        }
+
+        // assign each point of the block to the first face in [first, last) it sees, points that see no face are inside and dropped.
+        // one batch partition kernel call per face, the points left below are compacted for the next face.
+        // emit(slot, indices, distances, count) receives the points above face first[slot].
+        template<class Emit>
+        void AssignBlock(AssignBuffers& buffers, const uint32_t* first, const uint32_t* last, Emit&& emit) const
+        {
+            float* x = buffers.block.x.data();
+            float* y = buffers.block.y.data();
+            float* z = buffers.block.z.data();
+            uint32_t* index = buffers.block.index.data();
+            size_t count = buffers.block.Size();
+
+            for (const uint32_t* face = first; face != last && count > 0; ++face)
+            {
+                size_t below = 0;
+                size_t above = PartitionAbove(this->mesh.GetFace(*face).plane, this->tolerance, x, y, z, index, count,
+                    buffers.aboveIndices, buffers.aboveDistances, &below);
+                if (above > 0) emit(face - first, buffers.aboveIndices, buffers.aboveDistances, above);
+                count = below;
+            }
+        }
+
+        // assign count points to the faces [first, last), fill(block, begin, n) loads points [begin, begin + n) of the set.
+        // large sets are split over the workers, each collects its own conflict lists, and those are merged in point order,
+        // so lists and furthest points are the same as with one worker.
+        template<class Fill>
+        void AssignPoints(size_t count, const uint32_t* first, const uint32_t* last, Fill&& fill)
+        {
+            size_t chunkCount = ChunkCount(count, this->workerCount, MIN_PARALLEL_POINTS);
+            if (chunkCount == 1)
+            {
+                AssignBuffers& buffers = this->buffers[0];
+                for (size_t begin = 0; begin < count; begin += BLOCK_SIZE)
+                {
+                    fill(buffers.block, begin, std::min(BLOCK_SIZE, count - begin));
+                    this->AssignBlock(buffers, first, last, [this, first](size_t slot, const uint32_t* indices, const float* distances, size_t n)
+                    {
+                        this->AddOutside(first[slot], indices, distances, n);
+                    });
+                }
+                return;
+            }
+
+            size_t faceCount = last - first;
+            if (this->buffers.size() < chunkCount) this->buffers.resize(chunkCount);
+            if (this->partials.size() < chunkCount) this->partials.resize(chunkCount);
+
+            ParallelChunks(count, chunkCount, [&](size_t chunk, size_t begin, size_t end)
+            {
+                AssignBuffers& buffers = this->buffers[chunk];
+                PartialOutside& partial = this->partials[chunk];
+                partial.Reset(faceCount);
+                for (size_t blockBegin = begin; blockBegin < end; blockBegin += BLOCK_SIZE)
+                {
+                    fill(buffers.block, blockBegin, std::min(BLOCK_SIZE, end - blockBegin));
+                    this->AssignBlock(buffers, first, last, [&partial](size_t slot, const uint32_t* indices, const float* distances, size_t n)
+                    {
+                        partial.Add(slot, indices, distances, n);
+                    });
+                }
+            });
+
+            for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+            {
+                const PartialOutside& partial = this->partials[chunk];
+                for (size_t slot = 0; slot < faceCount; ++slot)
+                {
+                    const std::vector<uint32_t>& outside = partial.outside[slot];
+                    if (outside.empty()) continue;
+
+                    FaceInfo& info = this->infos[first[slot]];
+                    if (info.outside.empty() || partial.furthest[slot].value > info.furthestDistance)
+                    {
+                        info.furthest = partial.furthest[slot].index;
+                        info.furthestDistance = partial.furthest[slot].value;
+                    }
+                    info.outside.insert(info.outside.end(), outside.begin(), outside.end());
+                    this->outsideCount += outside.size();
+                }
+            }
+        }
+
+        // assign orphans to the new faces [first, last)
+        void AssignOrphans(const uint32_t* first, const uint32_t* last)
+        {
+            // large sets (early iterations on dense clouds) : gather to soa blocks for the batch kernels
+            constexpr size_t MIN_BATCH = 4096;
+            if (this->orphans.size() >= MIN_BATCH)
+            {
+                this->AssignPoints(this->orphans.size(), first, last, [this](PointSoA& block, size_t begin, size_t count)
+                {
+                    block.AssignGather(this->points, this->orphans.data() + begin, count);
+                });
+                return;
+            }
+
+            for (uint32_t index : this->orphans)
+            {
+                const Vec3& point = this->points[index];
+                for (const uint32_t* face = first; face != last; ++face)
+                {
+                    float distance = this->mesh.GetFace(*face).plane.Distance(point);
+                    if (distance > this->tolerance)
+                    {
+                        this->AddOutside(*face, index, distance);
+                        break;
+                    }
+                }
+            }
+        }
+
+        void AddOutside(uint32_t face, uint32_t index, float distance)
+        {
+            FaceInfo& info = this->infos[face];
+            if (info.outside.empty() || distance > info.furthestDistance)
+            {
+                info.furthest = index;
+                info.furthestDistance = distance;
+            }
+            info.outside.push_back(index);
+            ++this->outsideCount;
+        }
+
+        void AddOutside(uint32_t face, const uint32_t* indices, const float* distances, size_t count)
+        {
+            FaceInfo& info = this->infos[face];
+            size_t furthest = std::max_element(distances, distances + count) - distances;
+            if (info.outside.empty() || distances[furthest] > info.furthestDistance)
+            {
+                info.furthest = indices[furthest];
+                info.furthestDistance = distances[furthest];
+            }
+            info.outside.insert(info.outside.end(), indices, indices + count);
+            this->outsideCount += count;
+        }
+
+        // eye strictly outside the face (exact orientation, so the visible region is always a disk)
+        bool IsVisible(uint32_t face, const Vec3& eye)
+        {
+            FaceInfo& info = this->infos[face];
+            if (info.mark != this->iteration)
+            {
+                const uint32_t* v = this->mesh.GetFace(face).v;
+                info.mark = this->iteration;
+                info.visible = SideOfFace(this->points[v[0]], this->points[v[1]], this->points[v[2]], eye) > 0;
+            }
+            return info.visible;
+        }
+
+        // drop a point that can not be added (its face does not see it exactly)
+        void DropEye(uint32_t startFace, uint32_t eyeIndex)
+        {
+            std::vector<uint32_t>& outside = this->infos[startFace].outside;
+            outside.erase(std::find(outside.begin(), outside.end(), eyeIndex));
+            --this->outsideCount;
+            this->ResetFurthest(startFace);
+            this->PushIfPending(startFace);
+        }
+
+        void AddPoint(uint32_t startFace, uint32_t eyeIndex)
+        {
+            const Vec3& eye = this->points[eyeIndex];
+            ++this->iteration;
+
+            // visible region : BFS over twins from the face under the eye
+            this->visibleFaces.clear();
+            if (!this->IsVisible(startFace, eye))
+            {
+                this->DropEye(startFace, eyeIndex);
+                return;
+            }
+            this->visibleFaces.push_back(startFace);
+
+            uint32_t horizonStart = HalfEdgeMesh::INVALID;
+            for (size_t i = 0; i < this->visibleFaces.size(); ++i)
+            {
+                uint32_t face = this->visibleFaces[i];
+                for (int j = 0; j < 3; ++j)
+                {
+                    uint32_t edge = HalfEdgeMesh::EdgeOf(face, j);
+                    uint32_t neighbor = HalfEdgeMesh::FaceOf(this->mesh.Twin(edge));
+                    bool tested = this->infos[neighbor].mark == this->iteration;
+                    if (this->IsVisible(neighbor, eye))
+                    {
+                        if (!tested) this->visibleFaces.push_back(neighbor);
+                    }
+                    else if (horizonStart == HalfEdgeMesh::INVALID)
+                    {
+                        horizonStart = edge;
+                    }
+                }
+            }
+
+            // horizon : walk the boundary of the visible region
+            // (from a horizon edge, turn around its end vertex inside the visible region until the next horizon edge)
+            this->horizon.clear();
+            size_t maxHorizon = this->visibleFaces.size() * 3;
+            uint32_t edge = horizonStart;
+            while (edge != HalfEdgeMesh::INVALID)
+            {
+                this->horizon.push_back(edge);
+
+                edge = HalfEdgeMesh::Next(edge);
+                while (this->infos[HalfEdgeMesh::FaceOf(this->mesh.Twin(edge))].visible)
+                {
+                    edge = HalfEdgeMesh::Next(this->mesh.Twin(edge));
+                }
+                if (edge == horizonStart) break;
+                if (this->horizon.size() > maxHorizon) edge = HalfEdgeMesh::INVALID;
+            }
+
+            // visible region is not a disk : can not happen with exact orientation, kept as a guard against endless loops
+            if (edge == HalfEdgeMesh::INVALID)
+            {
+                this->DropEye(startFace, eyeIndex);
+                return;
+            }
+
+            // cone of new faces (u, v, eye) on horizon edges (u -> v)
+            this->horizonEdges.clear();
+            for (uint32_t h : this->horizon)
+            {
+                this->horizonEdges.push_back({ this->mesh.Origin(h), this->mesh.Destination(h), this->mesh.Twin(h) });
+            }
+
+            this->orphans.clear();
+            for (uint32_t face : this->visibleFaces)
+            {
+                for (uint32_t index : this->infos[face].outside)
+                {
+                    if (index != eyeIndex) this->orphans.push_back(index);
+                }
+                this->outsideCount -= this->infos[face].outside.size();
+                this->infos[face].outside.clear();
+                this->mesh.RemoveFace(face);
+            }
+
+            this->newFaces.clear();
+            for (auto& [u, v, twin] : this->horizonEdges)
+            {
+                uint32_t face = this->AddFace(u, v, eyeIndex);
+                this->mesh.Link(HalfEdgeMesh::EdgeOf(face, 0), twin);
+                this->newFaces.push_back(face);
+            }
+            for (size_t i = 0; i < this->newFaces.size(); ++i)
+            {
+                uint32_t face = this->newFaces[i];
+                uint32_t next = this->newFaces[(i + 1) % this->newFaces.size()];
+                this->mesh.Link(HalfEdgeMesh::EdgeOf(face, 1), HalfEdgeMesh::EdgeOf(next, 2));
+            }
+
+            // redistribute points of deleted faces
+            this->AssignOrphans(this->newFaces.data(), this->newFaces.data() + this->newFaces.size());
+
+            for (uint32_t face : this->newFaces) this->PushIfPending(face);
+        }
+
+    private:
+        struct HorizonEdge
+        {
+            uint32_t u, v, twin;
+        };
+
+        PointsView points;
+        float tolerance;
+        const unsigned workerCount;
+
+        HalfEdgeMesh mesh;
+        std::vector<FaceInfo> infos;
+
+        // faces with outside points
+        std::vector<uint32_t> pending;
+
+        // points in all conflict lists
+        size_t outsideCount;
+
+        uint32_t iteration;
+
+        // work buffers
+        std::vector<uint32_t> visibleFaces;
+        std::vector<uint32_t> horizon;
+        std::vector<HorizonEdge> horizonEdges;
+        std::vector<uint32_t> newFaces;
+
+        // points of deleted faces waiting for a new face
+        std::vector<uint32_t> orphans;
+
+        // per worker assignment state
+        std::vector<AssignBuffers> buffers;
+        std::vector<PartialOutside> partials;
+
+        // incremental insert : interior point, per face 1 / distance of the center to the plane,
+        // a face per normal direction cell (CubeMapCell) to start the walks from, walk state per worker
+        Vec3 center;
+        std::vector<float> scales;
+        std::vector<uint32_t> startFaces;
+        std::vector<WalkStamps> walks;
+    };
+
+    // Find min and max point, bounding box and max |coordinate| (chunk partials folded in index order)
+    Extents ReduceExtents(const PointsView& points, size_t chunkCount)
+    {
+        return ParallelReduce<Extents>(points.count, chunkCount,
+            [&points](size_t begin, size_t end) { return FindExtents(points, begin, end); },
+            [&points](Extents& result, const Extents& partial)
+            {
+                if (LessXYZ(points[partial.min], points[result.min])) result.min = partial.min;
+                if (LessXYZ(points[result.max], points[partial.max])) result.max = partial.max;
+                result.lower = { std::min(result.lower.x, partial.lower.x), std::min(result.lower.y, partial.lower.y), std::min(result.lower.z, partial.lower.z) };
+                result.upper = { std::max(result.upper.x, partial.upper.x), std::max(result.upper.y, partial.upper.y), std::max(result.upper.z, partial.upper.z) };
+                result.maxAbs = { std::max(result.maxAbs.x, partial.maxAbs.x), std::max(result.maxAbs.y, partial.maxAbs.y), std::max(result.maxAbs.z, partial.maxAbs.z) };
+            });
+    }
+
+    // first tetrahedron : lexicographic min and max, furthest point from their line, furthest point from that plane
+    // (tetra[0], tetra[1], tetra[2] clockwise seen from outside, tetra[3] below)
+    // return : false if all points are on a line or a plane
+    bool FindTetrahedron(const PointsView& points, const Extents& extents, float tolerance, unsigned workerCount, uint32_t (&tetra)[4])
+    {
+        const size_t chunkCount = ChunkCount(points.count, workerCount, MIN_PARALLEL_POINTS);
+
+        uint32_t min = extents.min;
+        uint32_t max = extents.max;
+
+        // Find furthest point from segment(min, max)
+        Vec3 vec1 = Normalize(points[min] - points[max]);
+        Furthest furthestFromLine = ParallelReduce<Furthest>(points.count, chunkCount,
+            [&](size_t begin, size_t end) { return FindFurthestFromLine(points, points[max], vec1, min, begin, end); },
+            FoldFurthest);
+        uint32_t far1 = furthestFromLine.index;
+
+        // all points are on a line
+        if (furthestFromLine.value <= tolerance * tolerance) return false;
+
+        // Find furthest point from Triangle(min, max, far1) on either side
+        Plane plane = Plane::FromTriangle(points[min], points[max], points[far1]);
+        Plane flipped = { -plane.normal, -plane.offset };
+        Furthest above = ParallelReduce<Furthest>(points.count, chunkCount,
+            [&](size_t begin, size_t end) { return FindFurthest(points, plane, begin, end); },
+            FoldFurthest);
+        Furthest below = ParallelReduce<Furthest>(points.count, chunkCount,
+            [&](size_t begin, size_t end) { return FindFurthest(points, flipped, begin, end); },
+            FoldFurthest);
+        float aboveDistance = above.value;
+        float belowDistance = below.value;
+        uint32_t far2 = aboveDistance >= belowDistance ? above.index : below.index;
+
+        // all points are on a plane
+        if (std::max(aboveDistance, belowDistance) <= tolerance) return false;
+
+        // far2 must be below (min, max, far1)
+        int side = SideOfFace(points[min], points[max], points[far1], points[far2]);
+        if (side == 0) return false;
+        if (side > 0)
+        {
+            std::swap(min, max);
+        }
+
+        tetra[0] = min;
+        tetra[1] = max;
+        tetra[2] = far1;
+        tetra[3] = far2;
+        return true;
+    }
+
+    // points FindTetrahedron found flat : the ones that can still be vertices of a hull once a point off their plane comes
+    // (one if all coincide, the two ends on a line, else the corners of their convex polygon in the plane)
+    // return : indices in ascending order
+    std::vector<uint32_t> FlatHullVertices(const PointsView& points, const Extents& extents, float tolerance)
+    {
+        const Vec3 origin = points[extents.min];
+        Vec3 axis = points[extents.max] - origin;
+        if (LengthSq(axis) <= tolerance * tolerance) return { extents.min };
+        axis = Normalize(axis);
+
+        Furthest far = FindFurthestFromLine(points, origin, axis, extents.min, 0, points.count);
+        if (far.value <= tolerance * tolerance) return { std::min(extents.min, extents.max), std::max(extents.min, extents.max) };
+
+        // monotone chain over the plane coordinates, points on an edge are dropped
+        Vec3 side = Normalize(Cross(Cross(axis, points[far.index] - origin), axis));
+        std::vector<std::pair<double, double>> coordinates(points.count);
+        for (size_t i = 0; i < points.count; ++i)
+        {
+            Vec3 vec = points[i] - origin;
+            coordinates[i] = { Dot(vec, axis), Dot(vec, side) };
+        }
+
+        std::vector<uint32_t> order(points.count);
+        for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return coordinates[a] < coordinates[b]; });
+
+        auto Turn = [&](uint32_t o, uint32_t a, uint32_t b)
+        {
+            return (coordinates[a].first - coordinates[o].first) * (coordinates[b].second - coordinates[o].second) -
+                (coordinates[a].second - coordinates[o].second) * (coordinates[b].first - coordinates[o].first);
+        };
+
+        std::vector<uint32_t> chain(2 * order.size());
+        size_t count = 0;
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            while (count >= 2 && Turn(chain[count - 2], chain[count - 1], order[i]) <= 0) --count;
+            chain[count++] = order[i];
+        }
+        for (size_t i = order.size() - 1, lower = count + 1; i-- > 0;)
+        {
+            while (count >= lower && Turn(chain[count - 2], chain[count - 1], order[i]) <= 0) --count;
+            chain[count++] = order[i];
+        }
+
+        // the chain ends where it started
+        chain.resize(count - 1);
+        std::sort(chain.begin(), chain.end());
+        return chain;
+    }
+
+    // quickhull of points, the tolerance is passed in so sub-hulls use the one of the whole cloud
+    // return : false if points are degenerate or the build was stopped
+    bool BuildQuickHull(const PointsView& points, const Extents& extents, float tolerance, unsigned workerCount, StopCheck& stop, BuildProgress* progress, Hull& hull)
+    {
+        uint32_t tetra[4];
+        if (!FindTetrahedron(points, extents, tolerance, workerCount, tetra)) return false;
+
+        QuickHullBuilder builder(points, tolerance, workerCount);
+        builder.InitTetrahedron(tetra[0], tetra[1], tetra[2], tetra[3]);
+
+        if (!builder.Run(stop, progress)) return false;
+
+        builder.GetHull(hull);
+
+        return true;
+    }
+
+    // points per slab when the slab count is automatic
+    constexpr size_t POINTS_PER_SLAB = 65536;
+    constexpr size_t MAX_SLABS = 256;
+
+    // divide and conquer : split the cloud into slabCount slabs of about equal point count along the longest bounding box axis,
+    // hull every slab as a task on a work-stealing pool, then hull the union of the slab hull vertices.
+    // the result does not depend on workerCount.
+    bool BuildDivideAndConquer(const PointsView& points, const Extents& extents, float tolerance, unsigned workerCount, size_t slabCount, StopCheck& stop, BuildProgress* progress, Hull& hull)
+    {
+        Vec3 size = extents.upper - extents.lower;
+        int axis = size.x >= size.y && size.x >= size.z ? 0 : (size.y >= size.z ? 1 : 2);
+        auto Coordinate = [axis](const Vec3& p) { return axis == 0 ? p.x : (axis == 1 ? p.y : p.z); };
+
+        // slab bounds from quantiles of a strided sample
+        constexpr size_t SAMPLE_COUNT = 65536;
+        size_t stride = std::max<size_t>(1, points.count / SAMPLE_COUNT);
+        std::vector<float> sample;
+        sample.reserve(points.count / stride + 1);
+        for (size_t i = 0; i < points.count; i += stride) sample.push_back(Coordinate(points[i]));
+        std::sort(sample.begin(), sample.end());
+
+        std::vector<float> bounds(slabCount - 1);
+        for (size_t slab = 1; slab < slabCount; ++slab) bounds[slab - 1] = sample[slab * sample.size() / slabCount];
+
+        // slab of each point, counted per chunk
+        const size_t chunkCount = ChunkCount(points.count, workerCount, MIN_PARALLEL_POINTS);
+        std::vector<uint8_t> slabOf(points.count);
+        std::vector<size_t> offsets(chunkCount * slabCount, 0);
+        ParallelChunks(points.count, chunkCount, [&](size_t chunk, size_t begin, size_t end)
+        {
+            size_t* count = offsets.data() + chunk * slabCount;
+            for (size_t i = begin; i < end; ++i)
+            {
+                size_t slab = std::upper_bound(bounds.begin(), bounds.end(), Coordinate(points[i])) - bounds.begin();
+                slabOf[i] = static_cast<uint8_t>(slab);
+                ++count[slab];
+            }
+        });
+
+        // counts -> write offset of each chunk inside its slab, so slabs keep input order
+        std::vector<std::vector<Vec3>> slabPoints(slabCount);
+        std::vector<std::vector<uint32_t>> slabSources(slabCount);
+        for (size_t slab = 0; slab < slabCount; ++slab)
+        {
+            size_t total = 0;
+            for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+            {
+                size_t count = offsets[chunk * slabCount + slab];
+                offsets[chunk * slabCount + slab] = total;
+                total += count;
+            }
+            slabPoints[slab].resize(total);
+            slabSources[slab].resize(total);
+        }
+
+        ParallelChunks(points.count, chunkCount, [&](size_t chunk, size_t begin, size_t end)
+        {
+            size_t* offset = offsets.data() + chunk * slabCount;
+            for (size_t i = begin; i < end; ++i)
+            {
+                size_t slab = slabOf[i];
+                size_t position = offset[slab]++;
+                slabPoints[slab][position] = points[i];
+                slabSources[slab][position] = static_cast<uint32_t>(i);
+            }
+        });
+        slabOf = {};
+
+        // sub-hulls : slab points are replaced by their hull vertices.
+        // tiny or flat slabs are kept as they are, the merge hull takes care of them.
+        {
+            // on a pool worker (job, batch) the slabs are tasks of that pool, otherwise of a local one
+            std::optional<ThreadPool> localPool;
+            ThreadPool* pool = ThreadPool::Current();
+            if (!pool) pool = &localPool.emplace(workerCount - 1);
+
+            TaskGroup group(*pool);
+            for (size_t slab = 0; slab < slabCount; ++slab)
+            {
+                group.Run([&, slab]()
+                {
+                    std::vector<Vec3>& subPoints = slabPoints[slab];
+                    if (subPoints.size() < 4 || stop.Status() != BuildStatus::Succeeded) return;
+
+                    Hull sub;
+                    if (!BuildQuickHull(subPoints, FindExtents(subPoints, 0, subPoints.size()), tolerance, 1, stop, nullptr, sub)) return;
+
+                    std::vector<uint32_t> sources(sub.sourceIndices.size());
+                    for (size_t i = 0; i < sources.size(); ++i) sources[i] = slabSources[slab][sub.sourceIndices[i]];
+
+                    subPoints = std::move(sub.vertices);
+                    slabSources[slab] = std::move(sources);
+                });
+            }
+            group.Wait();
+        }
+        if (stop.Status() != BuildStatus::Succeeded || stop()) return false;
+
+        // merge : hull of the sub-hull vertices
+        std::vector<Vec3> merged;
+        std::vector<uint32_t> mergedSources;
+        for (size_t slab = 0; slab < slabCount; ++slab)
+        {
+            merged.insert(merged.end(), slabPoints[slab].begin(), slabPoints[slab].end());
+            mergedSources.insert(mergedSources.end(), slabSources[slab].begin(), slabSources[slab].end());
+        }
+        slabPoints = {};
+        slabSources = {};
+
+        if (merged.size() < 4) return false;
+
+        Extents mergedExtents = ReduceExtents(merged, ChunkCount(merged.size(), workerCount, MIN_PARALLEL_POINTS));
+        if (!BuildQuickHull(merged, mergedExtents, tolerance, workerCount, stop, progress, hull)) return false;
+
+        for (uint32_t& source : hull.sourceIndices) source = mergedSources[source];
+
+        return true;
+    }
+
+    // how far points are outside a hull
+    struct OutsideDistance
+    {
+        // largest distance above a face plane
+        float plane;
+
+        // largest distance to the hull
+        float hull;
+    };
+
+    // points more than tolerance above a face plane are measured, the others count as inside.
+    // the distance to the surface is the smallest triangle distance, a face is skipped when its plane is already further.
+    OutsideDistance MeasureOutside(const PointsView& points, const Hull& hull, float tolerance, unsigned workerCount)
+    {
+        std::vector<Plane> planes(hull.FaceCount());
+        for (size_t face = 0; face < planes.size(); ++face) planes[face] = hull.FacePlane(face);
+
+        return ParallelReduce<OutsideDistance>(points.count, ChunkCount(points.count, workerCount, MIN_PARALLEL_POINTS),
+            [&](size_t begin, size_t end)
+            {
+                OutsideDistance result = { 0, 0 };
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const Vec3 point = points[i];
+                    float planeDistance = -FLT_MAX;
+                    for (const Plane& plane : planes) planeDistance = std::max(planeDistance, plane.Distance(point));
+                    if (planeDistance <= tolerance) continue;
+
+                    float distanceSq = FLT_MAX;
+                    for (size_t face = 0; face < planes.size(); ++face)
+                    {
+                        float distance = planes[face].Distance(point);
+                        if (distance * distance >= distanceSq) continue;
+
+                        const uint32_t* v = &hull.indices[face * 3];
+                        Vec3 closest = ClosestPointOnTriangle(point, hull.vertices[v[0]], hull.vertices[v[1]], hull.vertices[v[2]]);
+                        distanceSq = std::min(distanceSq, LengthSq(point - closest));
+                    }
+
+                    result.plane = std::max(result.plane, planeDistance);
+                    result.hull = std::max(result.hull, std::sqrt(distanceSq));
+                }
+                return result;
+            },
+            [](OutsideDistance& result, const OutsideDistance& partial)
+            {
+                result.plane = std::max(result.plane, partial.plane);
+                result.hull = std::max(result.hull, partial.hull);
+            });
+    }
+
+    // shortest m with Dot(normal, m) >= 1 for all normals : u / |u|^2, u the point of the normals' convex hull closest to the origin
+    // (frank-wolfe steps toward it, then m is scaled so the bound holds for the u reached).
+    // 3 normals (a simple vertex) : Dot(normal, m) = 1 solved exactly, the corner of the offset planes.
+    // return : zero vector if the normals do not fit in an open half space
+    Vec3 OffsetDirection(const std::vector<Vec3>& normals)
+    {
+        constexpr int STEPS = 256;
+
+        if (normals.size() == 3)
+        {
+            const Vec3& n0 = normals[0];
+            const Vec3& n1 = normals[1];
+            const Vec3& n2 = normals[2];
+            float determinant = Dot(n0, Cross(n1, n2));
+            if (std::abs(determinant) > 1e-6f) return (Cross(n1, n2) + Cross(n2, n0) + Cross(n0, n1)) / determinant;
+        }
+
+        Vec3 u = normals[0];
+        for (int step = 0; step < STEPS; ++step)
+        {
+            const Vec3* lowest = &normals[0];
+            for (const Vec3& normal : normals)
+            {
+                if (Dot(normal, u) < Dot(*lowest, u)) lowest = &normal;
+            }
+
+            Vec3 toward = *lowest - u;
+            float lengthSq = LengthSq(toward);
+            if (lengthSq == 0 || Dot(*lowest, u) >= LengthSq(u) * (1 - 1e-6f)) break;
+            u += toward * std::clamp(-Dot(u, toward) / lengthSq, 0.0f, 1.0f);
+        }
+
+        float lowest = FLT_MAX;
+        for (const Vec3& normal : normals) lowest = std::min(lowest, Dot(normal, u));
+        if (!(lowest > 0)) return { 0, 0, 0 };
+        return u / lowest;
+    }
+
+    // hull vertices moved out so every face plane through a vertex moves out by at least distance
+    std::vector<Vec3> OffsetVertices(const Hull& hull, float distance)
+    {
+        std::vector<std::vector<Vec3>> normals(hull.vertices.size());
+        for (size_t face = 0; face < hull.FaceCount(); ++face)
+        {
+            Vec3 normal = hull.FacePlane(face).normal;
+            for (int corner = 0; corner < 3; ++corner) normals[hull.indices[face * 3 + corner]].push_back(normal);
+        }
+
+        std::vector<Vec3> moved(hull.vertices.size());
+        for (size_t vertex = 0; vertex < moved.size(); ++vertex)
+        {
+            moved[vertex] = hull.vertices[vertex];
+            if (!normals[vertex].empty()) moved[vertex] += OffsetDirection(normals[vertex]) * distance;
+        }
+        return moved;
+    }
+
+    // hull scaled about its mean vertex until no point is above a face plane : always contains the points,
+    // faces far from the center move out more than needed
+    // return : largest distance a face moved out by
+    float ScaleToContain(Hull& hull, const PointsView& points)
+    {
+        Vec3 center = { 0, 0, 0 };
+        for (const Vec3& vertex : hull.vertices) center += vertex;
+        center = center / static_cast<float>(hull.vertices.size());
+
+        float scale = 1;
+        std::vector<float> heights(hull.FaceCount());
+        for (size_t face = 0; face < heights.size(); ++face)
+        {
+            Plane plane = hull.FacePlane(face);
+            float outside = 0;
+            for (size_t i = 0; i < points.count; ++i) outside = std::max(outside, plane.Distance(points[i]));
+
+            heights[face] = -plane.Distance(center);
+            if (heights[face] > 0) scale = std::max(scale, (heights[face] + outside) / heights[face]);
+        }
+
+        for (Vec3& vertex : hull.vertices) vertex = center + (vertex - center) * scale;
+        return *std::max_element(heights.begin(), heights.end()) * (scale - 1);
+    }
+
+    // simplified hull : quickhull over the vertices of the full hull, furthest point first, stopped at the vertex budget or error.
+    // the hausdorff distance to the full hull is reached at one of its vertices, so those are the points measured.
+    // inflate : offset the vertices, grown until the offset hull holds every full hull vertex (within tolerance),
+    // a hull that does not get there (thin hulls, vertices of many faces) is scaled instead
+    // return : false if stopped (hull is left as it was)
+    bool SimplifyHull(Hull& hull, const BuildOptions& options, float tolerance, unsigned workerCount, StopCheck& stop, BuildStats& stats)
+    {
+        // offset attempts, each with the distance grown by what was still outside
+        constexpr int MAX_INFLATE_STEPS = 4;
+
+        const uint32_t maxVertices = options.maxVertices > 0 ? std::max(options.maxVertices, 4u) : 0;
+        if ((maxVertices == 0 || hull.vertices.size() <= maxVertices) && options.maxError <= 0) return true;
+
+        const std::vector<Vec3>& vertices = hull.vertices;
+        uint32_t tetra[4];
+        if (!FindTetrahedron(vertices, ReduceExtents(vertices, 1), tolerance, 1, tetra)) return true;
+
+        QuickHullBuilder builder(vertices, tolerance, 1);
+        builder.InitTetrahedron(tetra[0], tetra[1], tetra[2], tetra[3]);
+
+        // the run stops on plane distances, which are below the distance to the hull near edges and on thin hulls :
+        // measured after each run, resumed with half the threshold until the error holds
+        Hull simplified;
+        OutsideDistance error;
+        for (float threshold = options.maxError;; threshold *= 0.5f)
+        {
+            if (!builder.RunFurthestFirst(maxVertices, threshold, stop)) return false;
+
+            builder.GetHull(simplified);
+            for (uint32_t& source : simplified.sourceIndices) source = hull.sourceIndices[source];
+            error = MeasureOutside(vertices, simplified, tolerance, workerCount);
+
+            if (error.hull <= options.maxError || (maxVertices > 0 && builder.VertexCount() >= maxVertices) || threshold <= tolerance) break;
+        }
+        stats.hausdorffError = error.hull;
+
+        if (options.inflate && error.plane > tolerance)
+        {
+            bool contained = false;
+            float distance = error.plane;
+            for (int step = 0; step < MAX_INFLATE_STEPS && !contained; ++step)
+            {
+                std::vector<Vec3> moved = OffsetVertices(simplified, distance);
+                if (!FindTetrahedron(moved, ReduceExtents(moved, 1), tolerance, 1, tetra)) break;
+
+                Hull inflated;
+                QuickHullBuilder offsetBuilder(moved, tolerance, 1);
+                offsetBuilder.InitTetrahedron(tetra[0], tetra[1], tetra[2], tetra[3]);
+                if (!offsetBuilder.Run(stop, nullptr)) return false;
+                offsetBuilder.GetHull(inflated);
+
+                float outside = MeasureOutside(vertices, inflated, tolerance, workerCount).plane;
+                contained = outside <= tolerance;
+                if (contained)
+                {
+                    for (uint32_t& source : inflated.sourceIndices) source = simplified.sourceIndices[source];
+                    simplified = std::move(inflated);
+                    stats.inflation = distance;
+                }
+                distance += outside;
+            }
+            if (!contained) stats.inflation = ScaleToContain(simplified, vertices);
+        }
+
+        hull = std::move(simplified);
+        return true;
+    }
+}
+
+float PlaneTolerance(const Vec3& maxAbs)
+{
+    return 3 * FLT_EPSILON * (maxAbs.x + maxAbs.y + maxAbs.z);
+}
+
+bool CreateConvexHull(const PointsView& points, Hull& hull, const BuildOptions& options, BuildStats* stats, const BuildControl* control)
+{
+    hull.Clear();
+
+    BuildStats localStats;
+    if (!stats) stats = &localStats;
+    *stats = {};
+
+    stats->status = BuildStatus::Degenerate;
+    if (points.count < 4) return false;
+
+    StopCheck stop(control);
+    BuildProgress* progress = control ? control->progress : nullptr;
+    if (progress)
+    {
+        progress->remainingPoints.store(points.count, std::memory_order_relaxed);
+        progress->faceCount.store(0, std::memory_order_relaxed);
+    }
+
+    // point passes are split into chunks, partial results are folded in index order (same result for any worker count)
+    const unsigned workerCount = ResolveThreadCount(options.threadCount);
+
+    Extents extents = ReduceExtents(points, ChunkCount(points.count, workerCount, MIN_PARALLEL_POINTS));
+    const float tolerance = PlaneTolerance(extents.maxAbs);
+
+    // welding : build from one point per cluster of near duplicates
+    PointsView input = points;
+    WeldResult weld;
+    bool welded = false;
+    if (options.weld && !stop() && WeldPoints(points, options.weldTolerance, workerCount, weld))
+    {
+        stats->weldedCount = points.count - weld.points.size();
+        if (weld.points.size() < 4) return false;
+
+        input = weld.points;
+        welded = true;
+        extents = ReduceExtents(input, ChunkCount(input.count, workerCount, MIN_PARALLEL_POINTS));
+    }
+
+    // pre-filter : build from the points left outside the extreme point polytope
+    std::vector<Vec3> kept;
+    std::vector<uint32_t> keptSources;
+    bool culled = false;
+    if (options.extremeDirections > 0 && !stop() && CullInteriorPoints(input, options.extremeDirections, tolerance, workerCount, keptSources))
+    {
+        stats->culledCount = input.count - keptSources.size();
+
+        kept.resize(keptSources.size());
+        for (size_t i = 0; i < kept.size(); ++i) kept[i] = input[keptSources[i]];
+
+        input = kept;
+        culled = true;
+        extents = ReduceExtents(kept, ChunkCount(kept.size(), workerCount, MIN_PARALLEL_POINTS));
+    }
+
+    size_t slabCount = options.slabCount > 0 ? options.slabCount : input.count / POINTS_PER_SLAB;
+    slabCount = std::min(slabCount, MAX_SLABS);
+
+    bool succeeded = !stop() && (slabCount > 1
+        ? BuildDivideAndConquer(input, extents, tolerance, workerCount, slabCount, stop, progress, hull)
+        : BuildQuickHull(input, extents, tolerance, workerCount, stop, progress, hull));
+    if (!succeeded)
+    {
+        if (stop.Status() != BuildStatus::Succeeded) stats->status = stop.Status();
+        hull.Clear();
+        return false;
+    }
+
+    if (culled)
+    {
+        for (uint32_t& source : hull.sourceIndices) source = keptSources[source];
+    }
+    if (welded)
+    {
+        for (uint32_t& source : hull.sourceIndices) source = weld.sources[source];
+    }
+
+    if ((options.maxVertices > 0 || options.maxError > 0) && !SimplifyHull(hull, options, tolerance, workerCount, stop, *stats))
+    {
+        stats->status = stop.Status();
+        hull.Clear();
+        return false;
+    }
+
+    if (progress)
+    {
+        progress->remainingPoints.store(0, std::memory_order_relaxed);
+        progress->faceCount.store(hull.FaceCount(), std::memory_order_relaxed);
+    }
+
+    stats->status = BuildStatus::Succeeded;
+    return true;
+}
+
+///////////////////////////////////////////////////////////
+
+struct IncrementalHull::Impl
+{
+    explicit Impl(unsigned workerCount_)
+        : workerCount(workerCount_), points(), sources(), insertedCount(0), maxAbs{ 0, 0, 0 }, tolerance(0), builder(), center{ 0, 0, 0 }, innerRadiusSq(0), refreshFaceCount(0)
+    {}
+
+    // drop the points that are not hull vertices, once they outnumber the vertices
+    void Compact()
+    {
+        if (this->points.size() <= 2 * size_t(this->builder->VertexCount()) + BLOCK_SIZE) return;
+
+        std::vector<uint8_t> used = this->builder->UsedVertices();
+        std::vector<uint32_t> remap(this->points.size(), HalfEdgeMesh::INVALID);
+        size_t count = 0;
+        for (size_t i = 0; i < this->points.size(); ++i)
+        {
+            if (!used[i]) continue;
+            remap[i] = static_cast<uint32_t>(count);
+            this->points[count] = this->points[i];
+            this->sources[count] = this->sources[i];
+            ++count;
+        }
+        this->points.resize(count);
+        this->sources.resize(count);
+
+        this->builder->SetPoints(this->points);
+        this->builder->RemapVertices(remap);
+    }
+
+    // new interior point and inner ball (O(faces)) once the hull doubled its faces since the last time,
+    // or when the insert walked at least as many candidates. in between the old ball stays inside the growing hull.
+    void Refresh(size_t candidateCount)
+    {
+        if (this->builder->FaceCount() < 2 * this->refreshFaceCount && candidateCount < this->builder->FaceCount()) return;
+        this->refreshFaceCount = this->builder->FaceCount();
+
+        this->center = this->builder->MeanCorner();
+        float radius = this->builder->SetCenter(this->center) * (1 - 1e-4f) - this->tolerance;
+        this->innerRadiusSq = radius > 0 ? radius * radius : 0;
+    }
+
+    const unsigned workerCount;
+
+    // hull vertices + candidates of the last insert (every point until the first tetrahedron)
+    std::vector<Vec3> points;
+
+    // insertion index of each stored point
+    std::vector<uint32_t> sources;
+
+    size_t insertedCount;
+    Vec3 maxAbs;
+    float tolerance;
+
+    // built once the points span a tetrahedron, refers to points
+    std::optional<QuickHullBuilder> builder;
+
+    // ball inside the hull (quick reject)
+    Vec3 center;
+    float innerRadiusSq;
+
+    // face count at the last Refresh
+    size_t refreshFaceCount;
+};
+
+IncrementalHull::IncrementalHull(unsigned threadCount)
+    : impl(std::make_unique<Impl>(ResolveThreadCount(threadCount)))
+{}
+
+IncrementalHull::~IncrementalHull() = default;
+IncrementalHull::IncrementalHull(IncrementalHull&&) noexcept = default;
+IncrementalHull& IncrementalHull::operator=(IncrementalHull&&) noexcept = default;
+
+bool IncrementalHull::Insert(const std::vector<Vec3>& points)
+{
+    Impl& impl = *this->impl;
+
+    const size_t firstSource = impl.insertedCount;
+    impl.insertedCount += points.size();
+
+    for (const Vec3& p : points)
+    {
+        impl.maxAbs = { std::max(impl.maxAbs.x, std::abs(p.x)), std::max(impl.maxAbs.y, std::abs(p.y)), std::max(impl.maxAbs.z, std::abs(p.z)) };
+    }
+    impl.tolerance = PlaneTolerance(impl.maxAbs);
+
+    // candidates : points outside the inner ball
+    const size_t begin = impl.points.size();
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        if (impl.builder && LengthSq(points[i] - impl.center) < impl.innerRadiusSq) continue;
+
+        impl.points.push_back(points[i]);
+        impl.sources.push_back(static_cast<uint32_t>(firstSource + i));
+    }
+
+    if (!impl.builder)
+    {
+        if (impl.points.size() < 4) return false;
+
+        Extents extents = ReduceExtents(impl.points, ChunkCount(impl.points.size(), impl.workerCount, MIN_PARALLEL_POINTS));
+        uint32_t tetra[4];
+        if (!FindTetrahedron(impl.points, extents, impl.tolerance, impl.workerCount, tetra))
+        {
+            // flat so far : keep only the points that can still become vertices, so flat input does not pile up
+            std::vector<uint32_t> keep = FlatHullVertices(impl.points, extents, impl.tolerance);
+            for (size_t i = 0; i < keep.size(); ++i)
+            {
+                impl.points[i] = impl.points[keep[i]];
+                impl.sources[i] = impl.sources[keep[i]];
+            }
+            impl.points.resize(keep.size());
+            impl.sources.resize(keep.size());
+            return false;
+        }
+
+        impl.builder.emplace(impl.points, impl.tolerance, impl.workerCount);
+        impl.builder->InitTetrahedron(tetra[0], tetra[1], tetra[2], tetra[3]);
+    }
+    else
+    {
+        if (begin == impl.points.size()) return true;
+
+        impl.builder->SetPoints(impl.points);
+        impl.builder->SetTolerance(impl.tolerance);
+        impl.builder->InsertPoints(begin, impl.points.size());
+    }
+
+    StopCheck stop(nullptr);
+    impl.builder->Run(stop, nullptr);
+
+    impl.Compact();
+    impl.Refresh(impl.points.size() - begin);
+    return true;
+}
+
+void IncrementalHull::Clear()
+{
+    this->impl = std::make_unique<Impl>(this->impl->workerCount);
+}
+
+bool IncrementalHull::IsValid() const
+{
+    return this->impl->builder.has_value();
+}
+
+size_t IncrementalHull::PointCount() const
+{
+    return this->impl->insertedCount;
+}
+
+size_t IncrementalHull::StoredPointCount() const
+{
+    return this->impl->points.size();
+}
+
+size_t IncrementalHull::FaceCount() const
+{
+    return this->impl->builder ? this->impl->builder->FaceCount() : 0;
+}
+
+void IncrementalHull::GetHull(Hull& hull) const
+{
+    hull.Clear();
+    if (!this->impl->builder) return;
+
+    this->impl->builder->GetHull(hull);
+    for (uint32_t& source : hull.sourceIndices) source = this->impl->sources[source];
+}
+
+const char* ToString(BuildStatus status)
+{
+    switch (status)
+    {
+    case BuildStatus::Succeeded:  return "succeeded";
+    case BuildStatus::Degenerate: return "degenerate";
+    case BuildStatus::Cancelled:  return "cancelled";
+    default:                      return "timed out";
+    }
+}
+
+}
\ No newline at end of file
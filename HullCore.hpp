@@ -0,0 +1,168 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stop_token>
+#include <vector>
+
+#include "PointsView.hpp"
+#include "Vec3.hpp"
+
+namespace hull
+{
+	// convex hull as indexed triangle list
+	struct Hull
+	{
+		// hull vertices (subset of the input points)
+		std::vector<Vec3> vertices;
+
+		// 3 indices into vertices per face, a -> b -> c : clockwise
+		std::vector<uint32_t> indices;
+
+		// input point index of each hull vertex
+		std::vector<uint32_t> sourceIndices;
+
+		size_t FaceCount() const { return this->indices.size() / 3; }
+
+		Plane FacePlane(size_t face) const
+		{
+			return Plane::FromTriangle(this->vertices[this->indices[face * 3]], this->vertices[this->indices[face * 3 + 1]], this->vertices[this->indices[face * 3 + 2]]);
+		}
+
+		void Clear()
+		{
+			this->vertices.clear();
+			this->indices.clear();
+			this->sourceIndices.clear();
+		}
+	};
+
+	// hull build settings
+	struct BuildOptions
+	{
+		// worker threads for the point passes (0 : one per hardware thread, 1 : serial)
+		// the hull does not depend on this value
+		unsigned threadCount = 1;
+
+		// divide and conquer : split the cloud into slabs along its longest axis, hull the slabs concurrently,
+		// then hull the union of their vertices (1 : off, 0 : one slab per 64k points, at most 256)
+		unsigned slabCount = 1;
+
+		// Akl-Toussaint pre-filter : cull points inside the polytope of the extreme points along this many directions
+		// before the build (0 : off, typically 26 or 62)
+		unsigned extremeDirections = 0;
+
+		// weld points within weldTolerance of an earlier point before the build (0 : exact duplicates only),
+		// the hull source indices still refer to the input points
+		bool weld = false;
+		float weldTolerance = 0;
+
+		// simplified hull : vertices of the full hull are added furthest first until the hull has maxVertices vertices
+		// (0 : no limit, at least 4) or none is more than maxError outside it (0 : no limit)
+		unsigned maxVertices = 0;
+		float maxError = 0;
+
+		// push a simplified hull out until it contains every input point (the vertices are not input points any more,
+		// their source indices are those of the vertices they were moved from)
+		bool inflate = false;
+	};
+
+	// how a build ended
+	enum class BuildStatus
+	{
+		Succeeded,
+		Degenerate,	// fewer than 4 points, or all points on a line or a plane
+		Cancelled,	// BuildControl::stopToken was signalled
+		TimedOut,	// BuildControl::deadline passed
+	};
+
+	const char* ToString(BuildStatus status);
+
+	// hull build report
+	struct BuildStats
+	{
+		BuildStatus status = BuildStatus::Succeeded;
+
+		// points merged into an earlier point by welding
+		size_t weldedCount = 0;
+
+		// points removed by the pre-filter
+		size_t culledCount = 0;
+
+		// simplified hull : largest distance of an input point outside it (hausdorff distance to the full hull, before inflation)
+		float hausdorffError = 0;
+
+		// distance the simplified hull was pushed out by
+		float inflation = 0;
+	};
+
+	// live counters of a running build, written at the control check points
+	struct BuildProgress
+	{
+		// points still waiting in conflict lists
+		std::atomic<size_t> remainingPoints = 0;
+
+		// faces of the current hull
+		std::atomic<size_t> faceCount = 0;
+	};
+
+	// cancellation, deadline and progress of one build
+	// checked between build stages and every few hundred added points (not per face), so the overhead is negligible
+	struct BuildControl
+	{
+		std::stop_token stopToken;
+		std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+		BuildProgress* progress = nullptr;
+	};
+
+	// distance below which a point counts as lying on a plane, for a cloud with per-axis max |coordinate| maxAbs
+	// (the tolerance of the build, for code that checks its planes)
+	float PlaneTolerance(const Vec3& maxAbs);
+
+	// create convex hull from points (a std::vector<Vec3> or positions read in place, see PointsView)
+	// return : false if points are degenerate or the build was cancelled / timed out (see stats->status)
+	bool CreateConvexHull(const PointsView& points, Hull& hull, const BuildOptions& options = {}, BuildStats* stats = nullptr, const BuildControl* control = nullptr);
+
+	// convex hull kept up to date while batches of points are inserted
+	//
+	// faces and topology are kept between inserts : new points inside the hull are discarded by an inner ball test,
+	// then a batch plane test against the faces, only the points outside go through the visible region / horizon update.
+	// only hull vertices (and the points of the last insert) are stored, not every point seen.
+	class IncrementalHull
+	{
+	public:
+		// threadCount : worker threads for the plane tests of large batches (0 : one per hardware thread)
+		explicit IncrementalHull(unsigned threadCount = 1);
+		~IncrementalHull();
+
+		IncrementalHull(IncrementalHull&&) noexcept;
+		IncrementalHull& operator=(IncrementalHull&&) noexcept;
+
+		// add points, their source indices follow the points inserted before
+		// return : false while all points seen are degenerate (fewer than 4, on a line or a plane), the hull is then empty
+		// and only the points that can still become vertices are kept (one, the ends of the line or the corners of the planar polygon)
+		bool Insert(const std::vector<Vec3>& points);
+
+		void Clear();
+
+		// hull exists
+		bool IsValid() const;
+
+		// points inserted so far
+		size_t PointCount() const;
+
+		// points held (hull vertices + candidates of the last insert)
+		size_t StoredPointCount() const;
+
+		size_t FaceCount() const;
+
+		// current hull, sourceIndices index the points in insertion order
+		void GetHull(Hull& hull) const;
+
+	private:
+		struct Impl;
+		std::unique_ptr<Impl> impl;
+	};
+}
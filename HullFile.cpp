@@ -0,0 +1,333 @@
+#include "HullFile.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "HalfEdgeMesh.hpp"
+
+namespace hull
+{
+
+namespace
+{
+    // "HULS"
+    constexpr uint32_t FILE_MAGIC = 0x534C5548;
+
+    // written as is, reads back differently on a machine of the other byte order
+    constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    constexpr uint32_t HAS_ADJACENCY = 1;
+    constexpr uint32_t HAS_SOURCE_INDICES = 2;
+
+    // BuildTwins marks open edges the same way
+    constexpr uint32_t OPEN_EDGE = HalfEdgeMesh::INVALID;
+
+    struct FileHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t byteOrder;
+        uint32_t headerSize;
+        uint64_t fileSize;
+        uint64_t hullCount;
+        uint64_t tag[2];
+        uint64_t reserved[2];
+    };
+
+    // offsets are from the start of the file, 0 for a block that is not stored
+    struct HullRecord
+    {
+        uint32_t vertexCount;
+        uint32_t faceCount;
+        uint32_t flags;
+        uint32_t reserved;
+        uint64_t vertexOffset;
+        uint64_t indexOffset;
+        uint64_t planeOffset;
+        uint64_t adjacencyOffset;
+        uint64_t sourceOffset;
+        uint64_t reserved2;
+    };
+
+    static_assert(sizeof(FileHeader) == HULL_FILE_ALIGNMENT);
+    static_assert(sizeof(HullRecord) == HULL_FILE_ALIGNMENT);
+    static_assert(sizeof(Vec3) == 12 && sizeof(Plane) == 16, "blocks are mapped as Vec3 / Plane arrays");
+
+    uint64_t Align(uint64_t offset)
+    {
+        return (offset + HULL_FILE_ALIGNMENT - 1) & ~uint64_t(HULL_FILE_ALIGNMENT - 1);
+    }
+
+    class BlockWriter
+    {
+    public:
+        explicit BlockWriter(std::ofstream& file_) : file(file_), position(0) {}
+
+        void Write(const void* data, size_t size)
+        {
+            this->file.write(static_cast<const char*>(data), size);
+            this->position += size;
+        }
+
+        // zero padding up to offset
+        void Seek(uint64_t offset)
+        {
+            static const char zeros[HULL_FILE_ALIGNMENT] = {};
+            while (this->position < offset)
+            {
+                size_t size = static_cast<size_t>(std::min<uint64_t>(offset - this->position, sizeof(zeros)));
+                this->Write(zeros, size);
+            }
+        }
+
+    private:
+        std::ofstream& file;
+        uint64_t position;
+    };
+
+    // return : true if [offset, offset + size) is an aligned range of the file
+    bool BlockFits(uint64_t offset, uint64_t size, uint64_t fileSize)
+    {
+        return offset % HULL_FILE_ALIGNMENT == 0 && offset >= sizeof(FileHeader) && offset <= fileSize && size <= fileSize - offset;
+    }
+
+    bool CheckRecord(const HullRecord& record, uint64_t fileSize)
+    {
+        uint64_t vertexCount = record.vertexCount;
+        uint64_t faceCount = record.faceCount;
+
+        if (!BlockFits(record.vertexOffset, vertexCount * sizeof(Vec3), fileSize)) return false;
+        if (!BlockFits(record.indexOffset, faceCount * 3 * sizeof(uint32_t), fileSize)) return false;
+        if (!BlockFits(record.planeOffset, faceCount * sizeof(Plane), fileSize)) return false;
+
+        if (record.flags & HAS_ADJACENCY)
+        {
+            if (!BlockFits(record.adjacencyOffset, faceCount * 3 * sizeof(uint32_t), fileSize)) return false;
+        }
+        else if (record.adjacencyOffset != 0) return false;
+
+        if (record.flags & HAS_SOURCE_INDICES)
+        {
+            if (!BlockFits(record.sourceOffset, vertexCount * sizeof(uint32_t), fileSize)) return false;
+        }
+        else if (record.sourceOffset != 0) return false;
+
+        return (record.flags & ~(HAS_ADJACENCY | HAS_SOURCE_INDICES)) == 0;
+    }
+}
+
+void HullView::CopyTo(Hull& hull) const
+{
+    hull.vertices.assign(this->vertices.begin(), this->vertices.end());
+    hull.indices.assign(this->indices.begin(), this->indices.end());
+    hull.sourceIndices.assign(this->sourceIndices.begin(), this->sourceIndices.end());
+}
+
+bool WriteHullFile(const std::filesystem::path& path, std::span<const Hull> hulls, const HullFileOptions& options)
+{
+    // layout first : the records hold the offsets of every block
+    std::vector<HullRecord> records(hulls.size());
+    uint64_t offset = sizeof(FileHeader) + hulls.size() * sizeof(HullRecord);
+    for (size_t i = 0; i < hulls.size(); ++i)
+    {
+        const Hull& hull = hulls[i];
+        if (hull.vertices.size() > std::numeric_limits<uint32_t>::max() || hull.FaceCount() > std::numeric_limits<uint32_t>::max() / 3) return false;
+        if (options.sourceIndices && hull.sourceIndices.size() != hull.vertices.size()) return false;
+
+        HullRecord& record = records[i];
+        record = {};
+        record.vertexCount = static_cast<uint32_t>(hull.vertices.size());
+        record.faceCount = static_cast<uint32_t>(hull.FaceCount());
+
+        record.vertexOffset = offset = Align(offset);
+        offset += hull.vertices.size() * sizeof(Vec3);
+        record.indexOffset = offset = Align(offset);
+        offset += hull.indices.size() * sizeof(uint32_t);
+        record.planeOffset = offset = Align(offset);
+        offset += hull.FaceCount() * sizeof(Plane);
+        if (options.adjacency)
+        {
+            record.flags |= HAS_ADJACENCY;
+            record.adjacencyOffset = offset = Align(offset);
+            offset += hull.indices.size() * sizeof(uint32_t);
+        }
+        if (options.sourceIndices)
+        {
+            record.flags |= HAS_SOURCE_INDICES;
+            record.sourceOffset = offset = Align(offset);
+            offset += hull.sourceIndices.size() * sizeof(uint32_t);
+        }
+    }
+
+    FileHeader header = {};
+    header.magic = FILE_MAGIC;
+    header.version = HULL_FILE_VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.headerSize = sizeof(FileHeader);
+    header.fileSize = offset;
+    header.hullCount = hulls.size();
+    header.tag[0] = options.tag[0];
+    header.tag[1] = options.tag[1];
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+
+    BlockWriter writer(file);
+    writer.Write(&header, sizeof(header));
+    writer.Write(records.data(), records.size() * sizeof(HullRecord));
+
+    std::vector<Plane> planes;
+    std::vector<uint32_t> adjacency;
+    for (size_t i = 0; i < hulls.size(); ++i)
+    {
+        const Hull& hull = hulls[i];
+        const HullRecord& record = records[i];
+
+        writer.Seek(record.vertexOffset);
+        writer.Write(hull.vertices.data(), hull.vertices.size() * sizeof(Vec3));
+
+        writer.Seek(record.indexOffset);
+        writer.Write(hull.indices.data(), hull.indices.size() * sizeof(uint32_t));
+
+        planes.resize(hull.FaceCount());
+        for (size_t face = 0; face < planes.size(); ++face) planes[face] = hull.FacePlane(face);
+        writer.Seek(record.planeOffset);
+        writer.Write(planes.data(), planes.size() * sizeof(Plane));
+
+        if (options.adjacency)
+        {
+            BuildTwins(hull, adjacency);
+            writer.Seek(record.adjacencyOffset);
+            writer.Write(adjacency.data(), adjacency.size() * sizeof(uint32_t));
+        }
+        if (options.sourceIndices)
+        {
+            writer.Seek(record.sourceOffset);
+            writer.Write(hull.sourceIndices.data(), hull.sourceIndices.size() * sizeof(uint32_t));
+        }
+    }
+    writer.Seek(header.fileSize);
+
+    file.close();
+    return !file.fail();
+}
+
+///////////////////////////////////////////////////////////
+
+MappedHullFile::MappedHullFile()
+    : file(), hullCount(0)
+{}
+
+MappedHullFile::MappedHullFile(MappedHullFile&& other)
+    : file(std::move(other.file)), hullCount(other.hullCount)
+{
+    other.hullCount = 0;
+}
+
+MappedHullFile& MappedHullFile::operator=(MappedHullFile&& other)
+{
+    if (this != &other)
+    {
+        this->file = std::move(other.file);
+        this->hullCount = other.hullCount;
+        other.hullCount = 0;
+    }
+    return *this;
+}
+
+bool MappedHullFile::Open(const std::filesystem::path& path)
+{
+    this->Close();
+    if (!this->file.Open(path)) return false;
+
+    const unsigned char* data = this->file.Data();
+    const size_t size = this->file.Size();
+    if (size < sizeof(FileHeader))
+    {
+        this->Close();
+        return false;
+    }
+
+    const FileHeader& header = *reinterpret_cast<const FileHeader*>(data);
+    bool valid = header.magic == FILE_MAGIC && header.version == HULL_FILE_VERSION && header.byteOrder == BYTE_ORDER_MARK
+        && header.headerSize == sizeof(FileHeader) && header.fileSize == size
+        && header.hullCount <= (size - sizeof(FileHeader)) / sizeof(HullRecord);
+
+    const HullRecord* records = reinterpret_cast<const HullRecord*>(data + sizeof(FileHeader));
+    for (uint64_t i = 0; valid && i < header.hullCount; ++i)
+    {
+        valid = CheckRecord(records[i], size);
+    }
+
+    if (!valid)
+    {
+        this->Close();
+        return false;
+    }
+
+    this->hullCount = static_cast<size_t>(header.hullCount);
+    return true;
+}
+
+void MappedHullFile::Close()
+{
+    this->file.Close();
+    this->hullCount = 0;
+}
+
+HullView MappedHullFile::GetHull(size_t index) const
+{
+    const unsigned char* data = this->file.Data();
+    const HullRecord& record = reinterpret_cast<const HullRecord*>(data + sizeof(FileHeader))[index];
+
+    HullView view;
+    view.vertices = { reinterpret_cast<const Vec3*>(data + record.vertexOffset), record.vertexCount };
+    view.indices = { reinterpret_cast<const uint32_t*>(data + record.indexOffset), size_t(record.faceCount) * 3 };
+    view.planes = { reinterpret_cast<const Plane*>(data + record.planeOffset), record.faceCount };
+    if (record.flags & HAS_ADJACENCY)
+    {
+        view.adjacency = { reinterpret_cast<const uint32_t*>(data + record.adjacencyOffset), size_t(record.faceCount) * 3 };
+    }
+    if (record.flags & HAS_SOURCE_INDICES)
+    {
+        view.sourceIndices = { reinterpret_cast<const uint32_t*>(data + record.sourceOffset), record.vertexCount };
+    }
+    return view;
+}
+
+uint64_t MappedHullFile::TagHigh() const
+{
+    return this->IsOpen() ? reinterpret_cast<const FileHeader*>(this->file.Data())->tag[0] : 0;
+}
+
+uint64_t MappedHullFile::TagLow() const
+{
+    return this->IsOpen() ? reinterpret_cast<const FileHeader*>(this->file.Data())->tag[1] : 0;
+}
+
+bool MappedHullFile::Verify() const
+{
+    for (size_t i = 0; i < this->hullCount; ++i)
+    {
+        HullView view = this->GetHull(i);
+
+        size_t vertexCount = view.vertices.size();
+        for (uint32_t index : view.indices)
+        {
+            if (index >= vertexCount) return false;
+        }
+
+        size_t edgeCount = view.indices.size();
+        for (uint32_t twin : view.adjacency)
+        {
+            if (twin != OPEN_EDGE && twin >= edgeCount) return false;
+        }
+    }
+    return true;
+}
+
+}
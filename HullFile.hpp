@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+#include "HullCore.hpp"
+#include "MappedFile.hpp"
+
+namespace hull
+{
+	// binary hull set file, mapped read-only and used in place
+	//
+	// layout (little endian, every block 64 byte aligned) :
+	//   header | hull records | per hull : vertices (Vec3) | indices (3 x uint32 per face) | planes (Plane per face)
+	//                                      | [adjacency (3 x uint32 per face)] | [sourceIndices (uint32 per vertex)]
+	// the file is only checked structurally on open (sizes, offsets, alignment), Verify() also checks every index.
+	constexpr uint32_t HULL_FILE_VERSION = 1;
+	constexpr size_t HULL_FILE_ALIGNMENT = 64;
+
+	// optional blocks of a hull file
+	struct HullFileOptions
+	{
+		// twin half-edge of each face edge (see HullView::adjacency)
+		bool adjacency = true;
+
+		// input point index of each vertex
+		bool sourceIndices = true;
+
+		// free 128 bit value kept in the header (e.g. a HullKey)
+		uint64_t tag[2] = { 0, 0 };
+	};
+
+	// one hull inside a mapped file (spans point into the mapping)
+	struct HullView
+	{
+		std::span<const Vec3> vertices;
+
+		// 3 indices into vertices per face, clockwise as Hull::indices
+		std::span<const uint32_t> indices;
+
+		// Hull::FacePlane of each face
+		std::span<const Plane> planes;
+
+		// half-edge 3f+i runs from vertex i to vertex i+1 of face f (as HalfEdgeMesh),
+		// adjacency[3f+i] is its twin half-edge (~0u on an open edge), the neighbour face is adjacency[3f+i] / 3.
+		// empty if not stored
+		std::span<const uint32_t> adjacency;
+
+		// empty if not stored
+		std::span<const uint32_t> sourceIndices;
+
+		size_t FaceCount() const { return this->indices.size() / 3; }
+
+		// copy out (planes and adjacency are dropped)
+		void CopyTo(Hull& hull) const;
+	};
+
+	// write hulls to path (replaced if it exists)
+	// return : false if the file can not be written or a hull is too large for 32 bit indices
+	bool WriteHullFile(const std::filesystem::path& path, std::span<const Hull> hulls, const HullFileOptions& options = {});
+
+	// read-only memory mapping of a hull file
+	// opening costs a few system calls and O(hull count), pages are loaded on first access and shared between processes.
+	class MappedHullFile
+	{
+	public:
+		MappedHullFile();
+
+		MappedHullFile(MappedHullFile&& other);
+		MappedHullFile& operator=(MappedHullFile&& other);
+
+		MappedHullFile(const MappedHullFile&) = delete;
+		MappedHullFile& operator=(const MappedHullFile&) = delete;
+
+		// return : false if the file is missing, truncated, of another version or malformed
+		bool Open(const std::filesystem::path& path);
+		void Close();
+
+		bool IsOpen() const { return this->file.IsOpen(); }
+
+		size_t HullCount() const { return this->hullCount; }
+		HullView GetHull(size_t index) const;
+
+		// header tag written with HullFileOptions::tag
+		uint64_t TagHigh() const;
+		uint64_t TagLow() const;
+
+		// mapped bytes
+		size_t Size() const { return this->file.Size(); }
+
+		// return : true if every index and adjacency entry is in range (reads the whole file)
+		bool Verify() const;
+
+	private:
+		MappedFile file;
+		size_t hullCount;
+	};
+}
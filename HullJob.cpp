@@ -0,0 +1,61 @@
+#include "HullJob.hpp"
+
+namespace hull
+{
+
+HullJob::HullJob()
+    : state(), result()
+{}
+
+HullJob::HullJob(std::vector<Vec3> points, const BuildOptions& options, Clock::time_point deadline, ThreadPool& pool)
+    : state(std::make_shared<State>()), result()
+{
+    this->result = this->state->promise.get_future();
+
+    pool.Submit([state = this->state, points = std::move(points), options, deadline]()
+    {
+        BuildControl control;
+        control.stopToken = state->stopSource.get_token();
+        control.deadline = deadline;
+        control.progress = &state->progress;
+
+        HullJobResult output;
+        output.succeeded = CreateConvexHull(points, output.hull, options, &output.stats, &control);
+
+        state->promise.set_value(std::move(output));
+        state->done.store(true, std::memory_order_release);
+    });
+}
+
+HullJob::~HullJob()
+{
+    this->Cancel();
+}
+
+HullJob& HullJob::operator=(HullJob&& other)
+{
+    if (this != &other)
+    {
+        this->Cancel();
+        this->state = std::move(other.state);
+        this->result = std::move(other.result);
+    }
+    return *this;
+}
+
+void HullJob::Cancel()
+{
+    if (this->state) this->state->stopSource.request_stop();
+}
+
+bool HullJob::IsDone() const
+{
+    return this->state && this->state->done.load(std::memory_order_acquire);
+}
+
+const BuildProgress& HullJob::Progress() const
+{
+    return this->state->progress;
+}
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stop_token>
+#include <vector>
+
+#include "HullCore.hpp"
+#include "ThreadPool.hpp"
+
+namespace hull
+{
+	// output of an asynchronous build
+	struct HullJobResult
+	{
+		Hull hull;
+		BuildStats stats;
+		bool succeeded = false;
+	};
+
+	// hull build running as a task of a thread pool
+	//
+	// Cancel() signals the build's std::stop_token, the build also stops by itself at the deadline (steady clock).
+	// both are checked coarsely, see BuildControl. the result is delivered through a std::future.
+	// destroying a running job cancels it, the task owns its points and finishes on its own.
+	class HullJob
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		// empty job (IsValid() == false)
+		HullJob();
+
+		// start building points (the job owns its copy)
+		explicit HullJob(std::vector<Vec3> points, const BuildOptions& options = {}, Clock::time_point deadline = Clock::time_point::max(), ThreadPool& pool = SharedHullPool());
+
+		~HullJob();
+
+		HullJob(HullJob&&) = default;
+		HullJob& operator=(HullJob&& other);
+
+		bool IsValid() const { return this->state != nullptr; }
+
+		// request a stop, the result then reports BuildStatus::Cancelled
+		void Cancel();
+
+		// build finished (succeeded or not), Result() will not block
+		bool IsDone() const;
+
+		// live counters (points remaining, faces)
+		const BuildProgress& Progress() const;
+
+		// single-use future of the result
+		std::future<HullJobResult>& Result() { return this->result; }
+
+	private:
+		struct State
+		{
+			BuildProgress progress;
+			std::stop_source stopSource;
+			std::promise<HullJobResult> promise;
+			std::atomic<bool> done = false;
+		};
+
+		std::shared_ptr<State> state;
+		std::future<HullJobResult> result;
+	};
+}
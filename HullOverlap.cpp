@@ -0,0 +1,313 @@
+#include "HullOverlap.hpp"
+
+#include "HalfEdgeMesh.hpp"
+#include "PlaneKernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace hull
+{
+
+namespace
+{
+    constexpr uint32_t NONE = ~0u;
+
+    // neighbouring faces whose normals are this close share one plane axis, their common edge is no edge axis
+    constexpr float COPLANAR_COS = 1 - 1e-6f;
+    constexpr float MIN_ARC_LENGTH_SQ = 1e-10f;
+
+    // edges of b per crossing arc pass (stack buffer)
+    constexpr size_t ARC_BLOCK = 256;
+
+    // face axes scan the vertices of the other shape up to this many vertices (support climbs above), planes per scan
+    constexpr size_t MAX_SCAN_VERTICES = 256;
+    constexpr size_t PLANE_BLOCK = 64;
+
+    // pairs per batch task
+    constexpr size_t PAIRS_PER_TASK = 64;
+}
+
+void SatShape::Build(const Hull& hull)
+{
+    this->Clear();
+    if (hull.vertices.empty() || hull.FaceCount() == 0) return;
+
+    this->support.Build(hull);
+
+    for (const Vec3& vertex : hull.vertices) this->center += vertex;
+    this->center = this->center / static_cast<float>(hull.vertices.size());
+    for (const Vec3& vertex : hull.vertices) this->radius = std::max(this->radius, Length(vertex - this->center));
+
+    if (hull.vertices.size() <= MAX_SCAN_VERTICES)
+    {
+        for (const Vec3& vertex : hull.vertices)
+        {
+            this->vx.push_back(vertex.x);
+            this->vy.push_back(vertex.y);
+            this->vz.push_back(vertex.z);
+        }
+        this->vw.assign(hull.vertices.size(), 0.0f);
+    }
+
+    // twin of every half-edge (HalfEdgeMesh::INVALID = NONE on an open edge)
+    std::vector<uint32_t> twins;
+    BuildTwins(hull, twins);
+
+    // breadth first over the faces : neighbouring planes come one after another, so the support queries of successive face axes
+    // start next to their answer. a face coplanar with the face it was reached from adds no axis.
+    std::vector<Plane> facePlanes(hull.FaceCount());
+    for (size_t face = 0; face < facePlanes.size(); ++face) facePlanes[face] = hull.FacePlane(face);
+
+    float innerRadius = INFINITY;
+    std::vector<uint32_t> parent(hull.FaceCount(), NONE);
+    std::vector<uint8_t> visited(hull.FaceCount(), 0);
+    std::vector<uint32_t> queue;
+    queue.reserve(hull.FaceCount());
+    for (uint32_t seed = 0; seed < hull.FaceCount(); ++seed)
+    {
+        if (visited[seed]) continue;
+        visited[seed] = 1;
+        queue.push_back(seed);
+
+        for (size_t next = queue.size() - 1; next < queue.size(); ++next)
+        {
+            uint32_t face = queue[next];
+            const Plane& plane = facePlanes[face];
+            bool degenerate = !(LengthSq(plane.normal) > 0.5f);
+            bool coplanar = parent[face] != NONE && Dot(plane.normal, facePlanes[parent[face]].normal) >= COPLANAR_COS;
+            if (!degenerate && !coplanar) this->planes.push_back(plane);
+            if (!degenerate) innerRadius = std::min(innerRadius, -plane.Distance(this->center));
+
+            for (uint32_t edge = 3 * face; edge < 3 * face + 3; ++edge)
+            {
+                if (twins[edge] == NONE) continue;
+                uint32_t neighbour = twins[edge] / 3;
+                if (visited[neighbour]) continue;
+                visited[neighbour] = 1;
+                parent[neighbour] = face;
+                queue.push_back(neighbour);
+            }
+        }
+    }
+
+    // shrunk against rounding, none for flat hulls
+    this->innerRadius = innerRadius > 0 && innerRadius < INFINITY ? innerRadius * (1 - 1e-4f) : 0;
+
+    // each edge once (from its lower half-edge), arcs of (nearly) parallel normals dropped
+    for (uint32_t edge = 0; edge < hull.indices.size(); ++edge)
+    {
+        if (twins[edge] == NONE || twins[edge] < edge) continue;
+
+        const Vec3& n1 = facePlanes[edge / 3].normal;
+        const Vec3& n2 = facePlanes[twins[edge] / 3].normal;
+        Vec3 cross = Cross(n2, n1);
+        if (!(LengthSq(cross) > MIN_ARC_LENGTH_SQ)) continue;
+
+        const Vec3& start = hull.vertices[hull.indices[edge]];
+        this->edgeStarts.push_back(start);
+        this->edgeDirections.push_back(hull.vertices[hull.indices[HalfEdgeMesh::Next(edge)]] - start);
+        this->x1.push_back(n1.x);
+        this->y1.push_back(n1.y);
+        this->z1.push_back(n1.z);
+        this->x2.push_back(n2.x);
+        this->y2.push_back(n2.y);
+        this->z2.push_back(n2.z);
+        this->cx.push_back(cross.x);
+        this->cy.push_back(cross.y);
+        this->cz.push_back(cross.z);
+    }
+}
+
+void SatShape::Clear()
+{
+    this->support.Clear();
+    this->planes.clear();
+    this->edgeStarts.clear();
+    this->edgeDirections.clear();
+    for (std::vector<float>* values : { &this->x1, &this->y1, &this->z1, &this->x2, &this->y2, &this->z2, &this->cx, &this->cy, &this->cz }) values->clear();
+    for (std::vector<float>* values : { &this->vx, &this->vy, &this->vz, &this->vw }) values->clear();
+    this->center = {};
+    this->radius = 0;
+    this->innerRadius = 0;
+}
+
+// return : index of the first plane of shape that other (mapped into the frame of shape by relative) lies in front of, NONE if none
+uint32_t SeparatingPlane(const SatShape& shape, const SatShape& other, const Transform& relative, uint32_t& otherSupport)
+{
+    if (other.vx.empty())
+    {
+        // support climbs : planes in adjacency order keep them short
+        for (size_t i = 0; i < shape.planes.size(); ++i)
+        {
+            const Plane& plane = shape.planes[i];
+            Vec3 deepest = relative.Apply(other.support.SupportPoint(relative.InverseRotate(-plane.normal), otherSupport));
+            if (plane.Distance(deepest) > 0) return static_cast<uint32_t>(i);
+        }
+        return NONE;
+    }
+
+    // in the frame of other the plane is (m, offset - Dot(normal, position)) with m = R^T normal, and the smallest distance of its vertices
+    // is minus the largest Dot(-m, v) : MaxDistances with the vertices as planes and the -m as points
+    PlanesSoA vertices = { other.vx.data(), other.vy.data(), other.vz.data(), other.vw.data(), other.vx.size() };
+    float mx[PLANE_BLOCK], my[PLANE_BLOCK], mz[PLANE_BLOCK], deepest[PLANE_BLOCK];
+    for (size_t begin = 0; begin < shape.planes.size(); begin += PLANE_BLOCK)
+    {
+        size_t count = std::min(PLANE_BLOCK, shape.planes.size() - begin);
+        for (size_t k = 0; k < count; ++k)
+        {
+            Vec3 m = relative.InverseRotate(-shape.planes[begin + k].normal);
+            mx[k] = m.x;
+            my[k] = m.y;
+            mz[k] = m.z;
+        }
+
+        MaxDistances(vertices, mx, my, mz, count, deepest);
+        for (size_t k = 0; k < count; ++k)
+        {
+            const Plane& plane = shape.planes[begin + k];
+            if (-deepest[k] - (plane.offset - Dot(plane.normal, relative.position)) > 0) return static_cast<uint32_t>(begin + k);
+        }
+    }
+    return NONE;
+}
+
+bool TestOverlap(const SatShape& a, const Transform& transformA, const SatShape& b, const Transform& transformB, SatCache& cache)
+{
+    if (a.planes.empty() || b.planes.empty()) return false;
+
+    // everything below runs in the frame of a : relative maps b into it
+    Transform relative =
+    {
+        transformA.InverseRotate(transformB.column0),
+        transformA.InverseRotate(transformB.column1),
+        transformA.InverseRotate(transformB.column2),
+        transformA.InverseApply(transformB.position),
+    };
+
+    Vec3 centerOffset = relative.Apply(b.center) - a.center;
+    float centerDistanceSq = LengthSq(centerOffset);
+    float reach = a.radius + b.radius;
+    if (centerDistanceSq > reach * reach)
+    {
+        // the line between the centers separates the bounding spheres
+        cache.axis = Normalize(centerOffset);
+        return false;
+    }
+    float innerReach = a.innerRadius + b.innerRadius;
+    if (centerDistanceSq < innerReach * innerReach) return true;
+
+    // axis pointing from a towards b : gap between the support of a along it and the support of b against it
+    auto Separation = [&](const Vec3& axis)
+    {
+        Vec3 pointA = a.support.SupportPoint(axis, cache.supportA);
+        Vec3 pointB = relative.Apply(b.support.SupportPoint(relative.InverseRotate(-axis), cache.supportB));
+        return Dot(axis, pointB - pointA);
+    };
+    if (cache.axis != Vec3{ 0, 0, 0 } && Separation(cache.axis) > 0) return false;
+
+    // face axes : the vertex of the other shape deepest along -normal lies in front of the plane
+    uint32_t plane = SeparatingPlane(a, b, relative, cache.supportB);
+    if (plane != NONE)
+    {
+        cache.axis = a.planes[plane].normal;
+        return false;
+    }
+    plane = SeparatingPlane(b, a, relative.Inverse(), cache.supportA);
+    if (plane != NONE)
+    {
+        cache.axis = -relative.Rotate(b.planes[plane].normal);
+        return false;
+    }
+
+    // edge axes : only pairs whose gauss map arcs cross (faces of the minkowski difference), the tests run in the frame of b.
+    // a separating axis l points from a to b, so Dot(l, centerOffset) > 0 : l lies on the arc of the edge of a, which needs a normal
+    // facing along centerOffset, and -l on the arc of the edge of b, which needs a normal facing against it. the edges of b passing
+    // are gathered per block.
+    Vec3 offsetB = relative.InverseRotate(centerOffset);
+    uint32_t crossing[ARC_BLOCK], facing[ARC_BLOCK];
+    float x1[ARC_BLOCK], y1[ARC_BLOCK], z1[ARC_BLOCK], x2[ARC_BLOCK], y2[ARC_BLOCK], z2[ARC_BLOCK], cx[ARC_BLOCK], cy[ARC_BLOCK], cz[ARC_BLOCK];
+    for (size_t begin = 0; begin < b.edgeStarts.size(); begin += ARC_BLOCK)
+    {
+        size_t facingCount = 0;
+        for (size_t j = begin; j < std::min(begin + ARC_BLOCK, b.edgeStarts.size()); ++j)
+        {
+            Vec3 m1 = { b.x1[j], b.y1[j], b.z1[j] };
+            Vec3 m2 = { b.x2[j], b.y2[j], b.z2[j] };
+            if (Dot(m1, offsetB) >= 0 && Dot(m2, offsetB) >= 0) continue;
+
+            facing[facingCount] = static_cast<uint32_t>(j);
+            x1[facingCount] = m1.x;
+            y1[facingCount] = m1.y;
+            z1[facingCount] = m1.z;
+            x2[facingCount] = m2.x;
+            y2[facingCount] = m2.y;
+            z2[facingCount] = m2.z;
+            cx[facingCount] = b.cx[j];
+            cy[facingCount] = b.cy[j];
+            cz[facingCount] = b.cz[j];
+            ++facingCount;
+        }
+        if (facingCount == 0) continue;
+        ArcsSoA arcs = { x1, y1, z1, x2, y2, z2, cx, cy, cz, facingCount };
+
+        for (size_t i = 0; i < a.edgeStarts.size(); ++i)
+        {
+            Vec3 n1 = { a.x1[i], a.y1[i], a.z1[i] };
+            Vec3 n2 = { a.x2[i], a.y2[i], a.z2[i] };
+            if (Dot(n1, centerOffset) <= 0 && Dot(n2, centerOffset) <= 0) continue;
+
+            size_t count = CrossingArcs(relative.InverseRotate(n1), relative.InverseRotate(n2), relative.InverseRotate({ a.cx[i], a.cy[i], a.cz[i] }), arcs, crossing);
+            const Vec3& startA = a.edgeStarts[i];
+            const Vec3& directionA = a.edgeDirections[i];
+            for (size_t k = 0; k < count; ++k)
+            {
+                size_t j = facing[crossing[k]];
+                Vec3 directionB = relative.Rotate(b.edgeDirections[j]);
+                Vec3 axis = Cross(directionA, directionB);
+
+                // parallel edges : their axis is a face axis already tested
+                float lengthSq = LengthSq(axis);
+                if (!(lengthSq > MIN_ARC_LENGTH_SQ * LengthSq(directionA) * LengthSq(directionB))) continue;
+
+                axis = axis / std::sqrt(lengthSq);
+                if (Dot(axis, startA - a.center) < 0) axis = -axis;
+                if (Dot(axis, relative.Apply(b.edgeStarts[j]) - startA) > 0)
+                {
+                    cache.axis = axis;
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+void TestOverlaps(const SatShape* const* shapes, const Transform* transforms, const OverlapPair* pairs, size_t pairCount, SatCache* caches, uint8_t* overlaps,
+    ThreadPool& pool)
+{
+    auto TestRange = [=](size_t first, size_t last)
+    {
+        for (size_t i = first; i < last; ++i)
+        {
+            const OverlapPair& pair = pairs[i];
+            overlaps[i] = TestOverlap(*shapes[pair.a], transforms[pair.a], *shapes[pair.b], transforms[pair.b], caches[i]) ? 1 : 0;
+        }
+    };
+
+    if (pairCount <= PAIRS_PER_TASK)
+    {
+        TestRange(0, pairCount);
+        return;
+    }
+
+    TaskGroup group(pool);
+    for (size_t first = 0; first < pairCount; first += PAIRS_PER_TASK)
+    {
+        size_t last = std::min(pairCount, first + PAIRS_PER_TASK);
+        group.Run([=]() { TestRange(first, last); });
+    }
+    group.Wait();
+}
+
+}
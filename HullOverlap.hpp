@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "HullCore.hpp"
+#include "HullJob.hpp"
+#include "SupportMap.hpp"
+#include "ThreadPool.hpp"
+#include "Vec3.hpp"
+
+namespace hull
+{
+	// rigid transform : p' = rotation * p + position, rotation given by its orthonormal columns
+	struct Transform
+	{
+		Vec3 column0 = { 1, 0, 0 };
+		Vec3 column1 = { 0, 1, 0 };
+		Vec3 column2 = { 0, 0, 1 };
+		Vec3 position = {};
+
+		Vec3 Rotate(const Vec3& v) const { return this->column0 * v.x + this->column1 * v.y + this->column2 * v.z; }
+		Vec3 InverseRotate(const Vec3& v) const { return { Dot(this->column0, v), Dot(this->column1, v), Dot(this->column2, v) }; }
+		Vec3 Apply(const Vec3& p) const { return this->Rotate(p) + this->position; }
+		Vec3 InverseApply(const Vec3& p) const { return this->InverseRotate(p - this->position); }
+
+		Transform Inverse() const
+		{
+			return
+			{
+				{ this->column0.x, this->column1.x, this->column2.x },
+				{ this->column0.y, this->column1.y, this->column2.y },
+				{ this->column0.z, this->column1.z, this->column2.z },
+				-this->InverseRotate(this->position),
+			};
+		}
+
+		static Transform Translation(const Vec3& position) { return { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 }, position }; }
+	};
+
+	// state of a shape pair kept between tests (one per pair, frame to frame coherence)
+	struct SatCache
+	{
+		// last separating axis in the frame of shape a, tested first (zero : none)
+		Vec3 axis = {};
+
+		// support map starts of both shapes
+		uint32_t supportA = SupportMap::NO_START;
+		uint32_t supportB = SupportMap::NO_START;
+	};
+
+	// hull prepared for separating axis tests : face planes, edges with their gauss map arcs, support map and bounding sphere
+	class SatShape
+	{
+	public:
+		SatShape() = default;
+		explicit SatShape(const Hull& hull) { this->Build(hull); }
+
+		// planes in face adjacency order (coplanar neighbours once), edges between faces of different planes
+		void Build(const Hull& hull);
+
+		void Clear();
+
+		size_t PlaneCount() const { return this->planes.size(); }
+		size_t EdgeCount() const { return this->edgeStarts.size(); }
+
+	private:
+		friend bool TestOverlap(const SatShape& a, const Transform& transformA, const SatShape& b, const Transform& transformB, SatCache& cache);
+		friend uint32_t SeparatingPlane(const SatShape& shape, const SatShape& other, const Transform& relative, uint32_t& otherSupport);
+
+		SupportMap support;
+		std::vector<Plane> planes;
+
+		// edge i runs from edgeStarts[i] along edgeDirections[i], arc i joins the normals of its two faces (see ArcsSoA)
+		std::vector<Vec3> edgeStarts;
+		std::vector<Vec3> edgeDirections;
+		std::vector<float> x1, y1, z1, x2, y2, z2, cx, cy, cz;
+
+		// vertices as planes through the origin for MaxDistances (small hulls only : face axes scan them instead of climbing)
+		std::vector<float> vx, vy, vz, vw;
+
+		// vertex centroid (inside the hull), radius of the sphere around it holding every vertex and of the one inside every plane
+		Vec3 center = {};
+		float radius = 0;
+		float innerRadius = 0;
+	};
+
+	// return : true if the shapes overlap (touching counts), on false cache.axis receives the separating axis
+	// order : bounding spheres (inscribed ones overlapping : overlap), cached axis, face normals of a then b, edge-edge axes of the crossing gauss map arcs only
+	bool TestOverlap(const SatShape& a, const Transform& transformA, const SatShape& b, const Transform& transformB, SatCache& cache);
+
+	// candidate pair of a broadphase : indices into the shape and transform lists
+	struct OverlapPair
+	{
+		uint32_t a;
+		uint32_t b;
+	};
+
+	// overlaps[i] = TestOverlap of pairs[i] with caches[i] (1 : overlap), pairs are split into tasks of pool and the calling thread helps
+	void TestOverlaps(const SatShape* const* shapes, const Transform* transforms, const OverlapPair* pairs, size_t pairCount, SatCache* caches, uint8_t* overlaps,
+		ThreadPool& pool = SharedHullPool());
+}
@@ -0,0 +1,112 @@
+#include "HullStream.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <limits>
+
+#include "PointLoader.hpp"
+
+namespace hull
+{
+
+PointFileReader::Format PointFileReader::FormatOf(const std::filesystem::path& path)
+{
+    std::filesystem::path extension = path.extension();
+    return extension == ".txt" || extension == ".xyz" ? Format::Text : Format::Raw;
+}
+
+PointFileReader::PointFileReader()
+    : file(), format(Format::Raw), failed(false), skippedLines(0), line()
+{}
+
+bool PointFileReader::Open(const std::filesystem::path& path, Format format_)
+{
+    this->format = format_;
+    this->failed = false;
+    this->skippedLines = 0;
+    this->file.open(path, format_ == Format::Raw ? std::ios::binary : std::ios::in);
+    return this->file.is_open();
+}
+
+bool PointFileReader::Read(std::vector<Vec3>& points, size_t maxCount)
+{
+    points.clear();
+    if (!this->file.is_open() || this->failed) return false;
+
+    if (this->format == Format::Raw)
+    {
+        points.resize(maxCount);
+        this->file.read(reinterpret_cast<char*>(points.data()), maxCount * sizeof(Vec3));
+
+        size_t bytes = static_cast<size_t>(this->file.gcount());
+        points.resize(bytes / sizeof(Vec3));
+        if (bytes % sizeof(Vec3) != 0 || (this->file.bad())) this->failed = true;
+    }
+    else
+    {
+        Vec3 point = {};
+        while (points.size() < maxCount && std::getline(this->file, this->line))
+        {
+            if (this->line.empty() || this->line[0] == '#') continue;
+            if (ParsePoint(this->line.data(), this->line.data() + this->line.size(), point)) points.push_back(point);
+            else ++this->skippedLines;
+        }
+        if (this->file.bad()) this->failed = true;
+    }
+
+    if (this->failed) points.clear();
+    return !points.empty();
+}
+
+bool CreateConvexHullFromFile(const std::filesystem::path& path, Hull& hull, const StreamOptions& options, StreamStats* stats)
+{
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+
+    StreamStats localStats;
+    if (!stats) stats = &localStats;
+    *stats = {};
+
+    hull.Clear();
+
+    PointFileReader reader;
+    if (!reader.Open(path, PointFileReader::FormatOf(path))) return false;
+
+    const size_t chunkPoints = std::max<size_t>(options.chunkPoints, 4);
+    IncrementalHull incremental(options.threadCount);
+
+    // the next chunk is read while the current one is inserted
+    std::vector<Vec3> chunk;
+    std::vector<Vec3> next;
+    bool more = reader.Read(chunk, chunkPoints);
+    bool fits = true;
+    while (more && fits)
+    {
+        std::future<bool> read = std::async(std::launch::async, [&]() { return reader.Read(next, chunkPoints); });
+
+        stats->pointCount += chunk.size();
+        ++stats->chunkCount;
+        fits = stats->pointCount <= std::numeric_limits<uint32_t>::max();
+        if (fits)
+        {
+            incremental.Insert(chunk);
+            stats->peakStoredPoints = std::max(stats->peakStoredPoints, incremental.StoredPointCount());
+        }
+
+        auto wait = Clock::now();
+        more = read.get();
+        stats->readSeconds += std::chrono::duration<double>(Clock::now() - wait).count();
+
+        std::swap(chunk, next);
+    }
+
+    stats->seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    stats->skippedLines = reader.SkippedLines();
+    if (!fits || reader.Failed()) return false;
+
+    incremental.GetHull(hull);
+    return incremental.IsValid();
+}
+
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "HullCore.hpp"
+
+namespace hull
+{
+	// point file read a chunk at a time
+	class PointFileReader
+	{
+	public:
+		enum class Format
+		{
+			// little endian float x, y, z triples, no header (e.g. a dump of a vertex array)
+			Raw,
+
+			// one "x y z" per line, '#' starts a comment line
+			Text,
+		};
+
+		// format from the extension : .txt / .xyz are text, anything else raw
+		static Format FormatOf(const std::filesystem::path& path);
+
+		PointFileReader();
+
+		bool Open(const std::filesystem::path& path, Format format);
+
+		// points receives the next (at most maxCount) points
+		// return : false at the end of the file or on an error (points is then empty)
+		bool Read(std::vector<Vec3>& points, size_t maxCount);
+
+		// read error, or a raw file whose size is not a multiple of 12 bytes
+		bool Failed() const { return this->failed; }
+
+		// text lines that are neither a point nor a comment, skipped so far
+		size_t SkippedLines() const { return this->skippedLines; }
+
+	private:
+		std::ifstream file;
+		Format format;
+		bool failed;
+		size_t skippedLines;
+		std::string line;
+	};
+
+	// streaming build settings
+	struct StreamOptions
+	{
+		// worker threads for the insert passes (0 : one per hardware thread)
+		unsigned threadCount = 1;
+
+		// points per chunk (larger chunks cost memory and are not faster : most points of a chunk fall inside the hull)
+		size_t chunkPoints = size_t(1) << 18;
+	};
+
+	// streaming report
+	struct StreamStats
+	{
+		size_t pointCount = 0;
+		size_t chunkCount = 0;
+
+		// most points held by the running hull at once (hull vertices + candidates of a chunk)
+		size_t peakStoredPoints = 0;
+
+		// text lines that did not parse as a point (not counted in pointCount)
+		size_t skippedLines = 0;
+
+		// time spent waiting for the reader
+		double readSeconds = 0;
+		double seconds = 0;
+
+		double PointsPerSecond() const { return this->seconds > 0 ? this->pointCount / this->seconds : 0; }
+	};
+
+	// hull of a point file larger than memory
+	//
+	// chunks are folded one by one into an IncrementalHull that only keeps its vertices, the next chunk is read
+	// while the current one is inserted. memory : 2 chunks + the running hull (until the points leave a plane : their convex polygon).
+	// hull.sourceIndices are point indices in the file (at most 2^32 points).
+	// return : false on a read error, too many points or degenerate points
+	bool CreateConvexHullFromFile(const std::filesystem::path& path, Hull& hull, const StreamOptions& options = {}, StreamStats* stats = nullptr);
+}
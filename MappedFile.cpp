@@ -0,0 +1,111 @@
+#include "MappedFile.hpp"
+
+#include <utility>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace hull
+{
+
+MappedFile::MappedFile()
+    : data(nullptr), size(0), mapping(nullptr)
+{}
+
+MappedFile::~MappedFile()
+{
+    this->Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other)
+    : data(other.data), size(other.size), mapping(other.mapping)
+{
+    other.data = nullptr;
+    other.size = 0;
+    other.mapping = nullptr;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other)
+{
+    if (this != &other)
+    {
+        this->Close();
+        std::swap(this->data, other.data);
+        std::swap(this->size, other.size);
+        std::swap(this->mapping, other.mapping);
+    }
+    return *this;
+}
+
+bool MappedFile::Open(const std::filesystem::path& path)
+{
+    this->Close();
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+    {
+        mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    CloseHandle(file);
+    if (!mapping) return false;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    this->data = static_cast<const unsigned char*>(view);
+    this->size = static_cast<size_t>(fileSize.QuadPart);
+    this->mapping = mapping;
+#else
+    int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0) return false;
+
+    struct stat status;
+    void* view = MAP_FAILED;
+    if (::fstat(file, &status) == 0 && status.st_size > 0)
+    {
+        view = ::mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, file, 0);
+    }
+    ::close(file);
+    if (view == MAP_FAILED) return false;
+
+    this->data = static_cast<const unsigned char*>(view);
+    this->size = static_cast<size_t>(status.st_size);
+#endif
+
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (!this->data) return;
+
+#if defined(_WIN32)
+    UnmapViewOfFile(this->data);
+    CloseHandle(static_cast<HANDLE>(this->mapping));
+#else
+    ::munmap(const_cast<unsigned char*>(this->data), this->size);
+#endif
+
+    this->data = nullptr;
+    this->size = 0;
+    this->mapping = nullptr;
+}
+
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+namespace hull
+{
+	// whole file mapped read-only (mmap / windows file mapping), pages are loaded on first access
+	class MappedFile
+	{
+	public:
+		MappedFile();
+		~MappedFile();
+
+		MappedFile(MappedFile&& other);
+		MappedFile& operator=(MappedFile&& other);
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		// return : false if the file can not be opened or is empty
+		bool Open(const std::filesystem::path& path);
+		void Close();
+
+		bool IsOpen() const { return this->data != nullptr; }
+
+		// page aligned
+		const unsigned char* Data() const { return this->data; }
+		size_t Size() const { return this->size; }
+
+	private:
+		const unsigned char* data;
+		size_t size;
+
+		// platform handle of the mapping (windows)
+		void* mapping;
+	};
+}
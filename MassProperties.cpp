@@ -0,0 +1,105 @@
+#include "MassProperties.hpp"
+
+#include "Parallel.hpp"
+#include "PlaneKernels.hpp"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace hull
+{
+
+namespace
+{
+    // faces per soa block
+    constexpr size_t FACE_BLOCK_SIZE = 256;
+
+    using Moments = std::array<double, MOMENT_COUNT>;
+}
+
+bool ComputeMassProperties(const Hull& hull, MassProperties& properties, float density, unsigned threadCount)
+{
+    properties = {};
+
+    const size_t faceCount = hull.FaceCount();
+    if (faceCount == 0) return false;
+
+    // tetrahedra from a point inside : small corner coordinates keep the float terms accurate
+    double sum[3] = {};
+    for (const Vec3& vertex : hull.vertices)
+    {
+        sum[0] += vertex.x;
+        sum[1] += vertex.y;
+        sum[2] += vertex.z;
+    }
+    const double vertexCount = static_cast<double>(hull.vertices.size());
+    const Vec3 reference = { static_cast<float>(sum[0] / vertexCount), static_cast<float>(sum[1] / vertexCount), static_cast<float>(sum[2] / vertexCount) };
+
+    // one moment sum per block, the chunks of blocks run in parallel
+    const size_t blockCount = (faceCount + FACE_BLOCK_SIZE - 1) / FACE_BLOCK_SIZE;
+    std::vector<Moments> blockMoments(blockCount);
+    const size_t chunkCount = ChunkCount(blockCount, ResolveThreadCount(threadCount), MIN_PARALLEL_POINTS / FACE_BLOCK_SIZE);
+    ParallelChunks(blockCount, chunkCount, [&](size_t, size_t begin, size_t end)
+    {
+        float ax[FACE_BLOCK_SIZE], ay[FACE_BLOCK_SIZE], az[FACE_BLOCK_SIZE];
+        float bx[FACE_BLOCK_SIZE], by[FACE_BLOCK_SIZE], bz[FACE_BLOCK_SIZE];
+        float cx[FACE_BLOCK_SIZE], cy[FACE_BLOCK_SIZE], cz[FACE_BLOCK_SIZE];
+        for (size_t block = begin; block < end; ++block)
+        {
+            size_t first = block * FACE_BLOCK_SIZE;
+            size_t count = std::min(FACE_BLOCK_SIZE, faceCount - first);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const uint32_t* corner = &hull.indices[3 * (first + i)];
+                Vec3 a = hull.vertices[corner[0]] - reference;
+                Vec3 b = hull.vertices[corner[1]] - reference;
+                Vec3 c = hull.vertices[corner[2]] - reference;
+                ax[i] = a.x;
+                ay[i] = a.y;
+                az[i] = a.z;
+                bx[i] = b.x;
+                by[i] = b.y;
+                bz[i] = b.z;
+                cx[i] = c.x;
+                cy[i] = c.y;
+                cz[i] = c.z;
+            }
+
+            blockMoments[block] = {};
+            TetrahedronMoments({ ax, ay, az, bx, by, bz, cx, cy, cz, count }, blockMoments[block].data());
+        }
+    });
+
+    Moments moments = {};
+    for (const Moments& block : blockMoments)
+    {
+        for (size_t k = 0; k < MOMENT_COUNT; ++k) moments[k] += block[k];
+    }
+
+    // see TetrahedronMoments for the scale of each sum
+    const double volume = moments[0] / 6;
+    if (!(volume > 0)) return false;
+
+    // centroid relative to reference, then the second moments about it
+    const double x = moments[1] / 24 / volume;
+    const double y = moments[2] / 24 / volume;
+    const double z = moments[3] / 24 / volume;
+    const double xx = moments[4] / 120 - volume * x * x;
+    const double yy = moments[5] / 120 - volume * y * y;
+    const double zz = moments[6] / 120 - volume * z * z;
+    const double xy = moments[7] / 120 - volume * x * y;
+    const double yz = moments[8] / 120 - volume * y * z;
+    const double zx = moments[9] / 120 - volume * z * x;
+
+    const double scale = density;
+    properties.volume = static_cast<float>(volume);
+    properties.mass = static_cast<float>(volume * scale);
+    properties.centroid = { static_cast<float>(reference.x + x), static_cast<float>(reference.y + y), static_cast<float>(reference.z + z) };
+    properties.inertia[0] = { static_cast<float>(scale * (yy + zz)), static_cast<float>(-scale * xy), static_cast<float>(-scale * zx) };
+    properties.inertia[1] = { static_cast<float>(-scale * xy), static_cast<float>(scale * (xx + zz)), static_cast<float>(-scale * yz) };
+    properties.inertia[2] = { static_cast<float>(-scale * zx), static_cast<float>(-scale * yz), static_cast<float>(scale * (xx + yy)) };
+    return true;
+}
+
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "HullCore.hpp"
+#include "Vec3.hpp"
+
+namespace hull
+{
+	// mass properties of a hull filled with a uniform density
+	struct MassProperties
+	{
+		float volume = 0;
+		float mass = 0;
+
+		// center of mass
+		Vec3 centroid = {};
+
+		// inertia tensor about the centroid in the hull axes, by rows (symmetric : also the columns)
+		// diagonal : moments of inertia, off the diagonal : minus the products of inertia
+		Vec3 inertia[3] = {};
+	};
+
+	// volume, centroid and inertia tensor of hull, in one pass over the faces : the tetrahedra joining each face to a point inside
+	// (the vertex centroid) go through TetrahedronMoments in soa blocks, spread over threadCount threads for large hulls
+	// (0 : one per hardware thread). block sums are added in face order, so the result does not depend on threadCount
+	// return : false if hull encloses no volume (properties are then zero)
+	bool ComputeMassProperties(const Hull& hull, MassProperties& properties, float density = 1, unsigned threadCount = 1);
+}
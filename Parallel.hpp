@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "ThreadPool.hpp"
+
+namespace hull
+{
+	// points per soa block of the point passes (fits in L1 with its distances)
+	constexpr size_t BLOCK_SIZE = 1024;
+
+	// smallest point (or face) range worth a worker thread
+	constexpr size_t MIN_PARALLEL_POINTS = 32768;
+
+	// worker count for a thread count option (0 : one per hardware thread)
+	inline unsigned ResolveThreadCount(unsigned threadCount)
+	{
+		if (threadCount > 0) return threadCount;
+		return std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	// number of chunks to split count items into : at most workerCount, each at least minChunk items
+	inline size_t ChunkCount(size_t count, unsigned workerCount, size_t minChunk)
+	{
+		return std::max<size_t>(1, std::min<size_t>(workerCount, count / std::max<size_t>(minChunk, 1)));
+	}
+
+	// split [0, count) into chunkCount contiguous chunks in index order and run func(chunk, begin, end) on each.
+	// chunk 0 runs on the calling thread, returns when all chunks are done.
+	// the other chunks become tasks of the pool of the calling worker, or of SharedHullPool() off the pools,
+	// so no thread is created per call (the caller helps while it waits).
+	template <typename Func>
+	void ParallelChunks(size_t count, size_t chunkCount, Func&& func)
+	{
+		if (chunkCount <= 1)
+		{
+			func(size_t(0), size_t(0), count);
+			return;
+		}
+
+		ThreadPool* pool = ThreadPool::Current();
+		TaskGroup group(pool ? *pool : SharedHullPool());
+		for (size_t chunk = 1; chunk < chunkCount; ++chunk)
+		{
+			group.Run([&func, count, chunkCount, chunk]()
+			{
+				func(chunk, count * chunk / chunkCount, count * (chunk + 1) / chunkCount);
+			});
+		}
+
+		func(size_t(0), size_t(0), count / chunkCount);
+		group.Wait();
+	}
+
+	// map(begin, end) -> Partial on each chunk, then fold(result, partial) in chunk order.
+	// with an order-aware fold (e.g. first max on ties) the result does not depend on chunkCount.
+	template <typename Partial, typename Map, typename Fold>
+	Partial ParallelReduce(size_t count, size_t chunkCount, Map&& map, Fold&& fold)
+	{
+		std::vector<Partial> partials(chunkCount);
+		ParallelChunks(count, chunkCount, [&partials, &map](size_t chunk, size_t begin, size_t end)
+		{
+			partials[chunk] = map(begin, end);
+		});
+
+		Partial result = partials[0];
+		for (size_t chunk = 1; chunk < chunkCount; ++chunk) fold(result, partials[chunk]);
+		return result;
+	}
+}
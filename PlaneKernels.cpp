@@ -0,0 +1,1518 @@
+#include "PlaneKernels.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define HULL_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(HULL_X86) && (defined(__GNUC__) || defined(__clang__))
+#define HULL_TARGET(isa) __attribute__((target(isa)))
+#else
+#define HULL_TARGET(isa)
+#endif
+
+namespace hull
+{
+
+namespace
+{
+    // int32 lane indices : process at most this many points per block
+    constexpr size_t MAX_BLOCK = size_t(1) << 30;
+
+    ///////////////////////////////////////////////////////////
+    // scalar
+
+    void CalcDistancesScalar(const Plane& plane, const float* x, const float* y, const float* z, size_t count, float* distances)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            distances[i] = plane.Distance({ x[i], y[i], z[i] });
+        }
+    }
+
+    size_t ArgMaxDistanceScalar(const Plane& plane, const float* x, const float* y, const float* z, size_t count, float* maxDistance)
+    {
+        size_t best = 0;
+        float bestDistance = plane.Distance({ x[0], y[0], z[0] });
+        for (size_t i = 1; i < count; ++i)
+        {
+            float distance = plane.Distance({ x[i], y[i], z[i] });
+            if (distance > bestDistance)
+            {
+                bestDistance = distance;
+                best = i;
+            }
+        }
+        *maxDistance = bestDistance;
+        return best;
+    }
+
+    size_t PartitionAboveScalar(const Plane& plane, float tolerance, float* x, float* y, float* z, uint32_t* index, size_t count,
+        uint32_t* aboveIndices, float* aboveDistances, size_t* belowCount)
+    {
+        size_t above = 0;
+        size_t below = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            float distance = plane.Distance({ x[i], y[i], z[i] });
+            if (distance > tolerance)
+            {
+                aboveIndices[above] = index[i];
+                aboveDistances[above] = distance;
+                ++above;
+            }
+            else
+            {
+                x[below] = x[i];
+                y[below] = y[i];
+                z[below] = z[i];
+                index[below] = index[i];
+                ++below;
+            }
+        }
+        *belowCount = below;
+        return above;
+    }
+
+    void MaxDistancesScalar(const PlanesSoA& planes, const float* x, const float* y, const float* z, size_t count, float* distances)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            Vec3 point = { x[i], y[i], z[i] };
+            float best = -INFINITY;
+            for (size_t p = 0; p < planes.count; ++p)
+            {
+                float distance = Plane{ { planes.nx[p], planes.ny[p], planes.nz[p] }, planes.offset[p] }.Distance(point);
+                best = distance > best ? distance : best;
+            }
+            distances[i] = best;
+        }
+    }
+
+    void ContainPointsScalar(const PlanesSoA& planes, float tolerance, const float* x, const float* y, const float* z, size_t count, uint8_t* inside)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            Vec3 point = { x[i], y[i], z[i] };
+            inside[i] = 1;
+            for (size_t p = 0; p < planes.count; ++p)
+            {
+                float distance = Plane{ { planes.nx[p], planes.ny[p], planes.nz[p] }, planes.offset[p] }.Distance(point);
+                if (!(distance <= tolerance))
+                {
+                    inside[i] = 0;
+                    break;
+                }
+            }
+        }
+    }
+
+    size_t ArgMaxPlaneDistanceScalar(const PlanesSoA& planes, const Vec3& point, float* maxDistance)
+    {
+        size_t best = 0;
+        float bestDistance = -INFINITY;
+        for (size_t p = 0; p < planes.count; ++p)
+        {
+            float distance = Plane{ { planes.nx[p], planes.ny[p], planes.nz[p] }, planes.offset[p] }.Distance(point);
+            if (distance > bestDistance)
+            {
+                bestDistance = distance;
+                best = p;
+            }
+        }
+        *maxDistance = bestDistance;
+        return best;
+    }
+
+    // squared distance of point to triangle i, with the operations of the simd lanes :
+    // the first matching voronoi region (a, b, ab, c, ac, bc, face) sets the weights v, w of ab and ac, edges share one division
+    float TriangleDistanceSq(const TrianglesSoA& triangles, size_t i, const Vec3& point)
+    {
+        float apx = point.x - triangles.ax[i];
+        float apy = point.y - triangles.ay[i];
+        float apz = point.z - triangles.az[i];
+        float d1 = (triangles.abx[i] * apx + triangles.aby[i] * apy) + triangles.abz[i] * apz;
+        float d2 = (triangles.acx[i] * apx + triangles.acy[i] * apy) + triangles.acz[i] * apz;
+        float d3 = d1 - triangles.abab[i];
+        float d4 = d2 - triangles.abac[i];
+        float d5 = d1 - triangles.abac[i];
+        float d6 = d2 - triangles.acac[i];
+        float vc = d1 * d4 - d3 * d2;
+        float vb = d5 * d2 - d1 * d6;
+        float va = d3 * d6 - d5 * d4;
+
+        float v, w;
+        if (d1 <= 0 && d2 <= 0) v = 0, w = 0;
+        else if (d3 >= 0 && d4 <= d3) v = 1, w = 0;
+        else if (vc <= 0 && d1 >= 0 && d3 <= 0) v = d1 / (d1 - d3), w = 0;
+        else if (d6 >= 0 && d5 <= d6) v = 0, w = 1;
+        else if (vb <= 0 && d2 >= 0 && d6 <= 0) v = 0, w = d2 / (d2 - d6);
+        else if (va <= 0 && d4 - d3 >= 0 && d5 - d6 >= 0)
+        {
+            w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+            v = 1 - w;
+        }
+        else
+        {
+            float inverse = 1 / ((va + vb) + vc);
+            v = vb * inverse;
+            w = vc * inverse;
+        }
+
+        float dx = (triangles.abx[i] * v + triangles.acx[i] * w) - apx;
+        float dy = (triangles.aby[i] * v + triangles.acy[i] * w) - apy;
+        float dz = (triangles.abz[i] * v + triangles.acz[i] * w) - apz;
+        return (dx * dx + dy * dy) + dz * dz;
+    }
+
+    size_t NearestTriangleScalar(const TrianglesSoA& triangles, const Vec3& point, float* distanceSq)
+    {
+        size_t best = 0;
+        float bestDistanceSq = INFINITY;
+        for (size_t i = 0; i < triangles.count; ++i)
+        {
+            float d = TriangleDistanceSq(triangles, i, point);
+            if (d < bestDistanceSq)
+            {
+                bestDistanceSq = d;
+                best = i;
+            }
+        }
+        *distanceSq = bestDistanceSq;
+        return best;
+    }
+
+    // signs of the arc endpoints against the great circle of the other arc : p = Dot(m1, cA), q = Dot(m2, cA), r = Dot(a1, cB), s = Dot(a2, cB),
+    // the arcs cross (with b mirrored) when p * q < 0, r * s < 0 and p * s < 0
+    size_t CrossingArcsScalar(const Vec3& n1, const Vec3& n2, const Vec3& cross, const ArcsSoA& arcs, uint32_t* crossing)
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < arcs.count; ++i)
+        {
+            float p = (arcs.x1[i] * cross.x + arcs.y1[i] * cross.y) + arcs.z1[i] * cross.z;
+            float q = (arcs.x2[i] * cross.x + arcs.y2[i] * cross.y) + arcs.z2[i] * cross.z;
+            float r = (arcs.cx[i] * n1.x + arcs.cy[i] * n1.y) + arcs.cz[i] * n1.z;
+            float s = (arcs.cx[i] * n2.x + arcs.cy[i] * n2.y) + arcs.cz[i] * n2.z;
+            if (p * q < 0 && r * s < 0 && p * s < 0) crossing[count++] = static_cast<uint32_t>(i);
+        }
+        return count;
+    }
+
+    void SetMiss(size_t i, float* tEnter, float* tExit, uint32_t* enterPlane, uint32_t* exitPlane)
+    {
+        tEnter[i] = INFINITY;
+        tExit[i] = -INFINITY;
+        enterPlane[i] = NO_PLANE;
+        exitPlane[i] = NO_PLANE;
+    }
+
+    void ClipRaysScalar(const PlanesSoA& planes, const RaysSoA& rays, float* tEnter, float* tExit, uint32_t* enterPlane, uint32_t* exitPlane)
+    {
+        for (size_t i = 0; i < rays.count; ++i)
+        {
+            Vec3 origin = { rays.ox[i], rays.oy[i], rays.oz[i] };
+            Vec3 direction = { rays.dx[i], rays.dy[i], rays.dz[i] };
+            float enter = rays.tMin[i];
+            float exit = rays.tMax[i];
+            uint32_t enterIndex = NO_PLANE;
+            uint32_t exitIndex = NO_PLANE;
+
+            bool miss = !(enter <= exit);
+            for (size_t p = 0; p < planes.count && !miss; ++p)
+            {
+                Plane plane = { { planes.nx[p], planes.ny[p], planes.nz[p] }, planes.offset[p] };
+                float facing = Dot(plane.normal, direction);
+                float distance = plane.Distance(origin);
+                float t = -distance / facing;
+                if (facing < 0)
+                {
+                    if (t > enter) { enter = t; enterIndex = static_cast<uint32_t>(p); }
+                }
+                else if (facing > 0)
+                {
+                    if (t < exit) { exit = t; exitIndex = static_cast<uint32_t>(p); }
+                }
+                // parallel : outside the plane for every t
+                else if (!(distance <= 0)) miss = true;
+
+                miss = miss || enter > exit;
+            }
+
+            if (miss)
+            {
+                SetMiss(i, tEnter, tExit, enterPlane, exitPlane);
+                continue;
+            }
+            tEnter[i] = enter;
+            tExit[i] = exit;
+            enterPlane[i] = enterIndex;
+            exitPlane[i] = exitIndex;
+        }
+    }
+
+    // sums of TetrahedronMoments by lane : triangle i adds to lane i % 4 on every level, the lanes are added last
+    using MomentLanes = double[MOMENT_COUNT][4];
+
+    void AddMomentLanes(const MomentLanes& lanes, double* moments)
+    {
+        for (size_t k = 0; k < MOMENT_COUNT; ++k) moments[k] += (lanes[k][0] + lanes[k][1]) + (lanes[k][2] + lanes[k][3]);
+    }
+
+    // triangles start at a multiple of 4 (lane 0)
+    void AccumulateMomentsScalar(const CornersSoA& triangles, MomentLanes& lanes)
+    {
+        for (size_t i = 0; i < triangles.count; ++i)
+        {
+            float ax = triangles.ax[i], ay = triangles.ay[i], az = triangles.az[i];
+            float bx = triangles.bx[i], by = triangles.by[i], bz = triangles.bz[i];
+            float cx = triangles.cx[i], cy = triangles.cy[i], cz = triangles.cz[i];
+
+            float det = ax * (by * cz - bz * cy) + ay * (bz * cx - bx * cz) + az * (bx * cy - by * cx);
+            float sx = ax + bx + cx, sy = ay + by + cy, sz = az + bz + cz;
+
+            const float terms[MOMENT_COUNT] =
+            {
+                det,
+                det * sx,
+                det * sy,
+                det * sz,
+                det * (ax * ax + bx * bx + cx * cx + sx * sx),
+                det * (ay * ay + by * by + cy * cy + sy * sy),
+                det * (az * az + bz * bz + cz * cz + sz * sz),
+                det * (ax * ay + bx * by + cx * cy + sx * sy),
+                det * (ay * az + by * bz + cy * cz + sy * sz),
+                det * (az * ax + bz * bx + cz * cx + sz * sx),
+            };
+            for (size_t k = 0; k < MOMENT_COUNT; ++k) lanes[k][i % 4] += terms[k];
+        }
+    }
+
+    void TetrahedronMomentsScalar(const CornersSoA& triangles, double* moments)
+    {
+        MomentLanes lanes = {};
+        AccumulateMomentsScalar(triangles, lanes);
+        AddMomentLanes(lanes, moments);
+    }
+
+#if defined(HULL_X86)
+
+    // pick lane with the largest value (smallest index on ties)
+    size_t ReduceArgMax(const float* values, const int32_t* indices, int lanes, float* maxDistance)
+    {
+        int best = 0;
+        for (int i = 1; i < lanes; ++i)
+        {
+            if (values[i] > values[best] || (values[i] == values[best] && indices[i] < indices[best])) best = i;
+        }
+        *maxDistance = values[best];
+        return static_cast<size_t>(indices[best]);
+    }
+
+    // pick lane with the smallest value (smallest index on ties)
+    size_t ReduceArgMin(const float* values, const int32_t* indices, int lanes, float* minDistance)
+    {
+        int best = 0;
+        for (int i = 1; i < lanes; ++i)
+        {
+            if (values[i] < values[best] || (values[i] == values[best] && indices[i] < indices[best])) best = i;
+        }
+        *minDistance = values[best];
+        return static_cast<size_t>(indices[best]);
+    }
+
+    ///////////////////////////////////////////////////////////
+    // sse4.1
+
+    HULL_TARGET("sse4.1")
+    void CalcDistancesSSE41(const Plane& plane, const float* x, const float* y, const float* z, size_t count, float* distances)
+    {
+        const __m128 nx = _mm_set1_ps(plane.normal.x);
+        const __m128 ny = _mm_set1_ps(plane.normal.y);
+        const __m128 nz = _mm_set1_ps(plane.normal.z);
+        const __m128 offset = _mm_set1_ps(plane.offset);
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 d = _mm_add_ps(_mm_mul_ps(nx, _mm_loadu_ps(x + i)), _mm_mul_ps(ny, _mm_loadu_ps(y + i)));
+            d = _mm_add_ps(d, _mm_mul_ps(nz, _mm_loadu_ps(z + i)));
+            _mm_storeu_ps(distances + i, _mm_sub_ps(d, offset));
+        }
+        CalcDistancesScalar(plane, x + i, y + i, z + i, count - i, distances + i);
+    }
+
+    HULL_TARGET("sse4.1")
+    size_t ArgMaxDistanceSSE41(const Plane& plane, const float* x, const float* y, const float* z, size_t count, float* maxDistance)
+    {
+        if (count < 8) return ArgMaxDistanceScalar(plane, x, y, z, count, maxDistance);
+
+        const __m128 nx = _mm_set1_ps(plane.normal.x);
+        const __m128 ny = _mm_set1_ps(plane.normal.y);
+        const __m128 nz = _mm_set1_ps(plane.normal.z);
+        const __m128 offset = _mm_set1_ps(plane.offset);
+        const __m128i step = _mm_set1_epi32(4);
+
+        __m128 bestValue = _mm_set1_ps(-INFINITY);
+        __m128i bestIndex = _mm_set1_epi32(0);
+        __m128i index = _mm_setr_epi32(0, 1, 2, 3);
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 d = _mm_add_ps(_mm_mul_ps(nx, _mm_loadu_ps(x + i)), _mm_mul_ps(ny, _mm_loadu_ps(y + i)));
+            d = _mm_sub_ps(_mm_add_ps(d, _mm_mul_ps(nz, _mm_loadu_ps(z + i))), offset);
+
+            __m128 greater = _mm_cmpgt_ps(d, bestValue);
+            bestValue = _mm_blendv_ps(bestValue, d, greater);
+            bestIndex = _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(bestIndex), _mm_castsi128_ps(index), greater));
+            index = _mm_add_epi32(index, step);
+        }
+
+        alignas(16) float values[4];
+        alignas(16) int32_t indices[4];
+        _mm_store_ps(values, bestValue);
+        _mm_store_si128(reinterpret_cast<__m128i*>(indices), bestIndex);
+        size_t best = ReduceArgMax(values, indices, 4, maxDistance);
+
+        for (; i < count; ++i)
+        {
+            float distance = plane.Distance({ x[i], y[i], z[i] });
+            if (distance > *maxDistance)
+            {
+                *maxDistance = distance;
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    // pshufb masks moving the 32bit lanes set in a 4bit mask to the front
+    constexpr auto LEFT_PACK_4 = []
+    {
+        std::array<std::array<uint8_t, 16>, 16> table = {};
+        for (int mask = 0; mask < 16; ++mask)
+        {
+            int lane = 0;
+            for (int j = 0; j < 4; ++j)
+            {
+                if (!(mask & (1 << j))) continue;
+                for (int b = 0; b < 4; ++b) table[mask][lane * 4 + b] = static_cast<uint8_t>(j * 4 + b);
+                ++lane;
+            }
+            for (; lane < 4; ++lane)
+            {
+                for (int b = 0; b < 4; ++b) table[mask][lane * 4 + b] = 0x80;
+            }
+        }
+        return table;
+    }();
+
+    HULL_TARGET("sse4.1")
+    size_t PartitionAboveSSE41(const Plane& plane, float tolerance, float* x, float* y, float* z, uint32_t* index, size_t count,
+        uint32_t* aboveIndices, float* aboveDistances, size_t* belowCount)
+    {
+        const __m128 nx = _mm_set1_ps(plane.normal.x);
+        const __m128 ny = _mm_set1_ps(plane.normal.y);
+        const __m128 nz = _mm_set1_ps(plane.normal.z);
+        const __m128 offset = _mm_set1_ps(plane.offset);
+        const __m128 limit = _mm_set1_ps(tolerance);
+
+        size_t above = 0;
+        size_t below = 0;
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 px = _mm_loadu_ps(x + i);
+            __m128 py = _mm_loadu_ps(y + i);
+            __m128 pz = _mm_loadu_ps(z + i);
+            __m128i pi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(index + i));
+
+            __m128 d = _mm_add_ps(_mm_mul_ps(nx, px), _mm_mul_ps(ny, py));
+            d = _mm_sub_ps(_mm_add_ps(d, _mm_mul_ps(nz, pz)), offset);
+
+            int mask = _mm_movemask_ps(_mm_cmpgt_ps(d, limit));
+            int belowMask = ~mask & 0xf;
+
+            __m128i packAbove = _mm_loadu_si128(reinterpret_cast<const __m128i*>(LEFT_PACK_4[mask].data()));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(aboveIndices + above), _mm_shuffle_epi8(pi, packAbove));
+            _mm_storeu_ps(aboveDistances + above, _mm_castsi128_ps(_mm_shuffle_epi8(_mm_castps_si128(d), packAbove)));
+            above += std::popcount(static_cast<unsigned>(mask));
+
+            // below writes land on lanes already loaded (below <= i)
+            __m128i packBelow = _mm_loadu_si128(reinterpret_cast<const __m128i*>(LEFT_PACK_4[belowMask].data()));
+            _mm_storeu_ps(x + below, _mm_castsi128_ps(_mm_shuffle_epi8(_mm_castps_si128(px), packBelow)));
+            _mm_storeu_ps(y + below, _mm_castsi128_ps(_mm_shuffle_epi8(_mm_castps_si128(py), packBelow)));
+            _mm_storeu_ps(z + below, _mm_castsi128_ps(_mm_shuffle_epi8(_mm_castps_si128(pz), packBelow)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(index + below), _mm_shuffle_epi8(pi, packBelow));
+            below += std::popcount(static_cast<unsigned>(belowMask));
+        }
+
+        size_t tailBelow = 0;
+        size_t tailAbove = PartitionAboveScalar(plane, tolerance, x + i, y + i, z + i, index + i, count - i, aboveIndices + above, aboveDistances + above, &tailBelow);
+        std::copy_n(x + i, tailBelow, x + below);
+        std::copy_n(y + i, tailBelow, y + below);
+        std::copy_n(z + i, tailBelow, z + below);
+        std::copy_n(index + i, tailBelow, index + below);
+
+        *belowCount = below + tailBelow;
+        return above + tailAbove;
+    }
+
+    // max_ps(d, best) : d > best ? d : best, as the scalar kernel
+    HULL_TARGET("sse4.1")
+    void MaxDistancesSSE41(const PlanesSoA& planes, const float* x, const float* y, const float* z, size_t count, float* distances)
+    {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 px = _mm_loadu_ps(x + i);
+            __m128 py = _mm_loadu_ps(y + i);
+            __m128 pz = _mm_loadu_ps(z + i);
+
+            __m128 best = _mm_set1_ps(-INFINITY);
+            for (size_t p = 0; p < planes.count; ++p)
+            {
+                __m128 d = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes.nx[p]), px), _mm_mul_ps(_mm_set1_ps(planes.ny[p]), py));
+                d = _mm_sub_ps(_mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(planes.nz[p]), pz)), _mm_set1_ps(planes.offset[p]));
+                best = _mm_max_ps(d, best);
+            }
+            _mm_storeu_ps(distances + i, best);
+        }
+        MaxDistancesScalar(planes, x + i, y + i, z + i, count - i, distances + i);
+    }
+
+    HULL_TARGET("sse4.1")
+    void ContainPointsSSE41(const PlanesSoA& planes, float tolerance, const float* x, const float* y, const float* z, size_t count, uint8_t* inside)
+    {
+        const __m128 limit = _mm_set1_ps(tolerance);
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 px = _mm_loadu_ps(x + i);
+            __m128 py = _mm_loadu_ps(y + i);
+            __m128 pz = _mm_loadu_ps(z + i);
+
+            int outside = 0;
+            for (size_t p = 0; p < planes.count && outside != 0xf; ++p)
+            {
+                __m128 d = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes.nx[p]), px), _mm_mul_ps(_mm_set1_ps(planes.ny[p]), py));
+                d = _mm_sub_ps(_mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(planes.nz[p]), pz)), _mm_set1_ps(planes.offset[p]));
+                outside |= _mm_movemask_ps(_mm_cmpnle_ps(d, limit));
+            }
+            for (int lane = 0; lane < 4; ++lane) inside[i + lane] = static_cast<uint8_t>(~outside >> lane & 1);
+        }
+        ContainPointsScalar(planes, tolerance, x + i, y + i, z + i, count - i, inside + i);
+    }
+
+    HULL_TARGET("sse4.1")
+    size_t ArgMaxPlaneDistanceSSE41(const PlanesSoA& planes, const Vec3& point, float* maxDistance)
+    {
+        const __m128 px = _mm_set1_ps(point.x);
+        const __m128 py = _mm_set1_ps(point.y);
+        const __m128 pz = _mm_set1_ps(point.z);
+        const __m128i step = _mm_set1_epi32(4);
+
+        __m128 bestValue = _mm_set1_ps(-INFINITY);
+        __m128i bestIndex = _mm_set1_epi32(0);
+        __m128i index = _mm_setr_epi32(0, 1, 2, 3);
+
+        size_t p = 0;
+        for (; p + 4 <= planes.count; p += 4)
+        {
+            __m128 d = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(planes.nx + p), px), _mm_mul_ps(_mm_loadu_ps(planes.ny + p), py));
+            d = _mm_sub_ps(_mm_add_ps(d, _mm_mul_ps(_mm_loadu_ps(planes.nz + p), pz)), _mm_loadu_ps(planes.offset + p));
+
+            __m128 greater = _mm_cmpgt_ps(d, bestValue);
+            bestValue = _mm_blendv_ps(bestValue, d, greater);
+            bestIndex = _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(bestIndex), _mm_castsi128_ps(index), greater));
+            index = _mm_add_epi32(index, step);
+        }
+
+        alignas(16) float values[4];
+        alignas(16) int32_t indices[4];
+        _mm_store_ps(values, bestValue);
+        _mm_store_si128(reinterpret_cast<__m128i*>(indices), bestIndex);
+        size_t best = ReduceArgMax(values, indices, 4, maxDistance);
+
+        for (; p < planes.count; ++p)
+        {
+            float distance = Plane{ { planes.nx[p], planes.ny[p], planes.nz[p] }, planes.offset[p] }.Distance(point);
+            if (distance > *maxDistance)
+            {
+                *maxDistance = distance;
+                best = p;
+            }
+        }
+        return best;
+    }
+
+    HULL_TARGET("sse4.1")
+    size_t NearestTriangleSSE41(const TrianglesSoA& triangles, const Vec3& point, float* distanceSq)
+    {
+        const __m128 px = _mm_set1_ps(point.x);
+        const __m128 py = _mm_set1_ps(point.y);
+        const __m128 pz = _mm_set1_ps(point.z);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128i step = _mm_set1_epi32(4);
+
+        __m128 bestValue = _mm_set1_ps(INFINITY);
+        __m128i bestIndex = _mm_set1_epi32(0);
+        __m128i index = _mm_setr_epi32(0, 1, 2, 3);
+
+        size_t i = 0;
+        for (; i + 4 <= triangles.count; i += 4)
+        {
+            __m128 abx = _mm_loadu_ps(triangles.abx + i), aby = _mm_loadu_ps(triangles.aby + i), abz = _mm_loadu_ps(triangles.abz + i);
+            __m128 acx = _mm_loadu_ps(triangles.acx + i), acy = _mm_loadu_ps(triangles.acy + i), acz = _mm_loadu_ps(triangles.acz + i);
+            __m128 apx = _mm_sub_ps(px, _mm_loadu_ps(triangles.ax + i));
+            __m128 apy = _mm_sub_ps(py, _mm_loadu_ps(triangles.ay + i));
+            __m128 apz = _mm_sub_ps(pz, _mm_loadu_ps(triangles.az + i));
+            __m128 d1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(abx, apx), _mm_mul_ps(aby, apy)), _mm_mul_ps(abz, apz));
+            __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(acx, apx), _mm_mul_ps(acy, apy)), _mm_mul_ps(acz, apz));
+            __m128 abac = _mm_loadu_ps(triangles.abac + i);
+            __m128 d3 = _mm_sub_ps(d1, _mm_loadu_ps(triangles.abab + i));
+            __m128 d4 = _mm_sub_ps(d2, abac);
+            __m128 d5 = _mm_sub_ps(d1, abac);
+            __m128 d6 = _mm_sub_ps(d2, _mm_loadu_ps(triangles.acac + i));
+            __m128 vc = _mm_sub_ps(_mm_mul_ps(d1, d4), _mm_mul_ps(d3, d2));
+            __m128 vb = _mm_sub_ps(_mm_mul_ps(d5, d2), _mm_mul_ps(d1, d6));
+            __m128 va = _mm_sub_ps(_mm_mul_ps(d3, d6), _mm_mul_ps(d5, d4));
+
+            // region masks, applied from the lowest priority up
+            __m128 e = _mm_sub_ps(d4, d3);
+            __m128 f = _mm_sub_ps(d5, d6);
+            __m128 inBC = _mm_and_ps(_mm_cmple_ps(va, zero), _mm_and_ps(_mm_cmpge_ps(e, zero), _mm_cmpge_ps(f, zero)));
+            __m128 inAC = _mm_and_ps(_mm_cmple_ps(vb, zero), _mm_and_ps(_mm_cmpge_ps(d2, zero), _mm_cmple_ps(d6, zero)));
+            __m128 inC = _mm_and_ps(_mm_cmpge_ps(d6, zero), _mm_cmple_ps(d5, d6));
+            __m128 inAB = _mm_and_ps(_mm_cmple_ps(vc, zero), _mm_and_ps(_mm_cmpge_ps(d1, zero), _mm_cmple_ps(d3, zero)));
+            __m128 inB = _mm_and_ps(_mm_cmpge_ps(d3, zero), _mm_cmple_ps(d4, d3));
+            __m128 inA = _mm_and_ps(_mm_cmple_ps(d1, zero), _mm_cmple_ps(d2, zero));
+
+            __m128 numerator = _mm_blendv_ps(_mm_blendv_ps(e, d2, inAC), d1, inAB);
+            __m128 denominator = _mm_blendv_ps(_mm_blendv_ps(_mm_add_ps(e, f), _mm_sub_ps(d2, d6), inAC), _mm_sub_ps(d1, d3), inAB);
+            __m128 t = _mm_div_ps(numerator, denominator);
+            __m128 inverse = _mm_div_ps(one, _mm_add_ps(_mm_add_ps(va, vb), vc));
+
+            __m128 v = _mm_mul_ps(vb, inverse);
+            __m128 w = _mm_mul_ps(vc, inverse);
+            v = _mm_blendv_ps(v, _mm_sub_ps(one, t), inBC);
+            w = _mm_blendv_ps(w, t, inBC);
+            v = _mm_blendv_ps(v, zero, inAC);
+            w = _mm_blendv_ps(w, t, inAC);
+            v = _mm_blendv_ps(v, zero, inC);
+            w = _mm_blendv_ps(w, one, inC);
+            v = _mm_blendv_ps(v, t, inAB);
+            w = _mm_blendv_ps(w, zero, inAB);
+            v = _mm_blendv_ps(v, one, inB);
+            w = _mm_blendv_ps(w, zero, inB);
+            v = _mm_andnot_ps(inA, v);
+            w = _mm_andnot_ps(inA, w);
+
+            __m128 dx = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(abx, v), _mm_mul_ps(acx, w)), apx);
+            __m128 dy = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(aby, v), _mm_mul_ps(acy, w)), apy);
+            __m128 dz = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(abz, v), _mm_mul_ps(acz, w)), apz);
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+            __m128 less = _mm_cmplt_ps(d, bestValue);
+            bestValue = _mm_blendv_ps(bestValue, d, less);
+            bestIndex = _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(bestIndex), _mm_castsi128_ps(index), less));
+            index = _mm_add_epi32(index, step);
+        }
+
+        alignas(16) float values[4];
+        alignas(16) int32_t indices[4];
+        _mm_store_ps(values, bestValue);
+        _mm_store_si128(reinterpret_cast<__m128i*>(indices), bestIndex);
+        size_t best = ReduceArgMin(values, indices, 4, distanceSq);
+
+        for (; i < triangles.count; ++i)
+        {
+            float d = TriangleDistanceSq(triangles, i, point);
+            if (d < *distanceSq)
+            {
+                *distanceSq = d;
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    HULL_TARGET("sse4.1")
+    size_t CrossingArcsSSE41(const Vec3& n1, const Vec3& n2, const Vec3& cross, const ArcsSoA& arcs, uint32_t* crossing)
+    {
+        const __m128 ax = _mm_set1_ps(n1.x), ay = _mm_set1_ps(n1.y), az = _mm_set1_ps(n1.z);
+        const __m128 bx = _mm_set1_ps(n2.x), by = _mm_set1_ps(n2.y), bz = _mm_set1_ps(n2.z);
+        const __m128 cx = _mm_set1_ps(cross.x), cy = _mm_set1_ps(cross.y), cz = _mm_set1_ps(cross.z);
+        const __m128 zero = _mm_setzero_ps();
+
+        size_t count = 0;
+        size_t i = 0;
+        for (; i + 4 <= arcs.count; i += 4)
+        {
+            __m128 p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(arcs.x1 + i), cx), _mm_mul_ps(_mm_loadu_ps(arcs.y1 + i), cy)), _mm_mul_ps(_mm_loadu_ps(arcs.z1 + i), cz));
+            __m128 q = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(arcs.x2 + i), cx), _mm_mul_ps(_mm_loadu_ps(arcs.y2 + i), cy)), _mm_mul_ps(_mm_loadu_ps(arcs.z2 + i), cz));
+            __m128 arcX = _mm_loadu_ps(arcs.cx + i), arcY = _mm_loadu_ps(arcs.cy + i), arcZ = _mm_loadu_ps(arcs.cz + i);
+            __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(arcX, ax), _mm_mul_ps(arcY, ay)), _mm_mul_ps(arcZ, az));
+            __m128 s = _mm_add_ps(_mm_add_ps(_mm_mul_ps(arcX, bx), _mm_mul_ps(arcY, by)), _mm_mul_ps(arcZ, bz));
+
+            __m128 crosses = _mm_and_ps(_mm_cmplt_ps(_mm_mul_ps(p, q), zero), _mm_and_ps(_mm_cmplt_ps(_mm_mul_ps(r, s), zero), _mm_cmplt_ps(_mm_mul_ps(p, s), zero)));
+            for (unsigned mask = static_cast<unsigned>(_mm_movemask_ps(crosses)); mask != 0; mask &= mask - 1)
+            {
+                crossing[count++] = static_cast<uint32_t>(i + std::countr_zero(mask));
+            }
+        }
+
+        ArcsSoA rest = { arcs.x1 + i, arcs.y1 + i, arcs.z1 + i, arcs.x2 + i, arcs.y2 + i, arcs.z2 + i, arcs.cx + i, arcs.cy + i, arcs.cz + i, arcs.count - i };
+        size_t restCount = CrossingArcsScalar(n1, n2, cross, rest, crossing + count);
+        for (size_t j = count; j < count + restCount; ++j) crossing[j] += static_cast<uint32_t>(i);
+        return count + restCount;
+    }
+
+    // RaysSoA of rays [begin, begin + count)
+    RaysSoA RaysFrom(const RaysSoA& rays, size_t begin)
+    {
+        return { rays.ox + begin, rays.oy + begin, rays.oz + begin, rays.dx + begin, rays.dy + begin, rays.dz + begin, rays.tMin + begin, rays.tMax + begin, rays.count - begin };
+    }
+
+    HULL_TARGET("sse4.1")
+    void ClipRaysSSE41(const PlanesSoA& planes, const RaysSoA& rays, float* tEnter, float* tExit, uint32_t* enterPlane, uint32_t* exitPlane)
+    {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 signBit = _mm_set1_ps(-0.0f);
+
+        size_t i = 0;
+        for (; i + 4 <= rays.count; i += 4)
+        {
+            __m128 ox = _mm_loadu_ps(rays.ox + i), oy = _mm_loadu_ps(rays.oy + i), oz = _mm_loadu_ps(rays.oz + i);
+            __m128 dx = _mm_loadu_ps(rays.dx + i), dy = _mm_loadu_ps(rays.dy + i), dz = _mm_loadu_ps(rays.dz + i);
+            __m128 enter = _mm_loadu_ps(rays.tMin + i);
+            __m128 exit = _mm_loadu_ps(rays.tMax + i);
+            __m128 enterIndex = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            __m128 exitIndex = enterIndex;
+
+            __m128 miss = _mm_cmpnle_ps(enter, exit);
+            for (size_t p = 0; p < planes.count && _mm_movemask_ps(miss) != 0xf; ++p)
+            {
+                __m128 nx = _mm_set1_ps(planes.nx[p]), ny = _mm_set1_ps(planes.ny[p]), nz = _mm_set1_ps(planes.nz[p]);
+                __m128 facing = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, dx), _mm_mul_ps(ny, dy)), _mm_mul_ps(nz, dz));
+                __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, ox), _mm_mul_ps(ny, oy)), _mm_mul_ps(nz, oz));
+                distance = _mm_sub_ps(distance, _mm_set1_ps(planes.offset[p]));
+                __m128 t = _mm_div_ps(_mm_xor_ps(distance, signBit), facing);
+                __m128 index = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(p)));
+
+                __m128 entering = _mm_cmplt_ps(facing, zero);
+                __m128 leaving = _mm_cmpgt_ps(facing, zero);
+                __m128 later = _mm_and_ps(entering, _mm_cmpgt_ps(t, enter));
+                __m128 sooner = _mm_and_ps(leaving, _mm_cmplt_ps(t, exit));
+                enter = _mm_blendv_ps(enter, t, later);
+                enterIndex = _mm_blendv_ps(enterIndex, index, later);
+                exit = _mm_blendv_ps(exit, t, sooner);
+                exitIndex = _mm_blendv_ps(exitIndex, index, sooner);
+
+                __m128 parallelOutside = _mm_andnot_ps(_mm_or_ps(entering, leaving), _mm_cmpnle_ps(distance, zero));
+                miss = _mm_or_ps(miss, _mm_or_ps(parallelOutside, _mm_cmpgt_ps(enter, exit)));
+            }
+
+            _mm_storeu_ps(tEnter + i, _mm_blendv_ps(enter, _mm_set1_ps(INFINITY), miss));
+            _mm_storeu_ps(tExit + i, _mm_blendv_ps(exit, _mm_set1_ps(-INFINITY), miss));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(enterPlane + i), _mm_castps_si128(_mm_or_ps(enterIndex, miss)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(exitPlane + i), _mm_castps_si128(_mm_or_ps(exitIndex, miss)));
+        }
+        ClipRaysScalar(planes, RaysFrom(rays, i), tEnter + i, tExit + i, enterPlane + i, exitPlane + i);
+    }
+
+    // CornersSoA of triangles [begin, begin + count)
+    CornersSoA CornersFrom(const CornersSoA& triangles, size_t begin)
+    {
+        return { triangles.ax + begin, triangles.ay + begin, triangles.az + begin, triangles.bx + begin, triangles.by + begin, triangles.bz + begin,
+            triangles.cx + begin, triangles.cy + begin, triangles.cz + begin, triangles.count - begin };
+    }
+
+    // det * (au * av + bu * bv + cu * cv + su * sv)
+    HULL_TARGET("sse4.1")
+    __m128 SecondMomentSSE41(__m128 det, __m128 au, __m128 av, __m128 bu, __m128 bv, __m128 cu, __m128 cv, __m128 su, __m128 sv)
+    {
+        return _mm_mul_ps(det, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(au, av), _mm_mul_ps(bu, bv)), _mm_mul_ps(cu, cv)), _mm_mul_ps(su, sv)));
+    }
+
+    HULL_TARGET("sse4.1")
+    void AccumulateMomentsSSE41(const CornersSoA& triangles, MomentLanes& lanes)
+    {
+        __m128d sums[MOMENT_COUNT][2];
+        for (size_t k = 0; k < MOMENT_COUNT; ++k)
+        {
+            sums[k][0] = _mm_loadu_pd(lanes[k]);
+            sums[k][1] = _mm_loadu_pd(lanes[k] + 2);
+        }
+
+        size_t i = 0;
+        for (; i + 4 <= triangles.count; i += 4)
+        {
+            __m128 ax = _mm_loadu_ps(triangles.ax + i), ay = _mm_loadu_ps(triangles.ay + i), az = _mm_loadu_ps(triangles.az + i);
+            __m128 bx = _mm_loadu_ps(triangles.bx + i), by = _mm_loadu_ps(triangles.by + i), bz = _mm_loadu_ps(triangles.bz + i);
+            __m128 cx = _mm_loadu_ps(triangles.cx + i), cy = _mm_loadu_ps(triangles.cy + i), cz = _mm_loadu_ps(triangles.cz + i);
+
+            __m128 det = _mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(ax, _mm_sub_ps(_mm_mul_ps(by, cz), _mm_mul_ps(bz, cy))),
+                _mm_mul_ps(ay, _mm_sub_ps(_mm_mul_ps(bz, cx), _mm_mul_ps(bx, cz)))),
+                _mm_mul_ps(az, _mm_sub_ps(_mm_mul_ps(bx, cy), _mm_mul_ps(by, cx))));
+            __m128 sx = _mm_add_ps(_mm_add_ps(ax, bx), cx);
+            __m128 sy = _mm_add_ps(_mm_add_ps(ay, by), cy);
+            __m128 sz = _mm_add_ps(_mm_add_ps(az, bz), cz);
+
+            const __m128 terms[MOMENT_COUNT] =
+            {
+                det,
+                _mm_mul_ps(det, sx),
+                _mm_mul_ps(det, sy),
+                _mm_mul_ps(det, sz),
+                SecondMomentSSE41(det, ax, ax, bx, bx, cx, cx, sx, sx),
+                SecondMomentSSE41(det, ay, ay, by, by, cy, cy, sy, sy),
+                SecondMomentSSE41(det, az, az, bz, bz, cz, cz, sz, sz),
+                SecondMomentSSE41(det, ax, ay, bx, by, cx, cy, sx, sy),
+                SecondMomentSSE41(det, ay, az, by, bz, cy, cz, sy, sz),
+                SecondMomentSSE41(det, az, ax, bz, bx, cz, cx, sz, sx),
+            };
+            for (size_t k = 0; k < MOMENT_COUNT; ++k)
+            {
+                sums[k][0] = _mm_add_pd(sums[k][0], _mm_cvtps_pd(terms[k]));
+                sums[k][1] = _mm_add_pd(sums[k][1], _mm_cvtps_pd(_mm_movehl_ps(terms[k], terms[k])));
+            }
+        }
+
+        for (size_t k = 0; k < MOMENT_COUNT; ++k)
+        {
+            _mm_storeu_pd(lanes[k], sums[k][0]);
+            _mm_storeu_pd(lanes[k] + 2, sums[k][1]);
+        }
+        AccumulateMomentsScalar(CornersFrom(triangles, i), lanes);
+    }
+
+    HULL_TARGET("sse4.1")
+    void TetrahedronMomentsSSE41(const CornersSoA& triangles, double* moments)
+    {
+        MomentLanes lanes = {};
+        AccumulateMomentsSSE41(triangles, lanes);
+        AddMomentLanes(lanes, moments);
+    }
+
+    ///////////////////////////////////////////////////////////
+    // avx2 (no fma : keep results identical to the other levels)
+
+    HULL_TARGET("avx2")
+    void CalcDistancesAVX2(const Plane& plane, const float* x, const float* y, const float* z, size_t count, float* distances)
+    {
+        const __m256 nx = _mm256_set1_ps(plane.normal.x);
+        const __m256 ny = _mm256_set1_ps(plane.normal.y);
+        const __m256 nz = _mm256_set1_ps(plane.normal.z);
+        const __m256 offset = _mm256_set1_ps(plane.offset);
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 d = _mm256_add_ps(_mm256_mul_ps(nx, _mm256_loadu_ps(x + i)), _mm256_mul_ps(ny, _mm256_loadu_ps(y + i)));
+            d = _mm256_add_ps(d, _mm256_mul_ps(nz, _mm256_loadu_ps(z + i)));
+            _mm256_storeu_ps(distances + i, _mm256_sub_ps(d, offset));
+        }
+        CalcDistancesScalar(plane, x + i, y + i, z + i, count - i, distances + i);
+    }
+
+    HULL_TARGET("avx2")
+    size_t ArgMaxDistanceAVX2(const Plane& plane, const float* x, const float* y, const float* z, size_t count, float* maxDistance)
+    {
+        if (count < 16) return ArgMaxDistanceScalar(plane, x, y, z, count, maxDistance);
+
+        const __m256 nx = _mm256_set1_ps(plane.normal.x);
+        const __m256 ny = _mm256_set1_ps(plane.normal.y);
+        const __m256 nz = _mm256_set1_ps(plane.normal.z);
+        const __m256 offset = _mm256_set1_ps(plane.offset);
+        const __m256i step = _mm256_set1_epi32(8);
+
+        __m256 bestValue = _mm256_set1_ps(-INFINITY);
+        __m256i bestIndex = _mm256_set1_epi32(0);
+        __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 d = _mm256_add_ps(_mm256_mul_ps(nx, _mm256_loadu_ps(x + i)), _mm256_mul_ps(ny, _mm256_loadu_ps(y + i)));
+            d = _mm256_sub_ps(_mm256_add_ps(d, _mm256_mul_ps(nz, _mm256_loadu_ps(z + i))), offset);
+
+            __m256 greater = _mm256_cmp_ps(d, bestValue, _CMP_GT_OQ);
+            bestValue = _mm256_blendv_ps(bestValue, d, greater);
+            bestIndex = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(bestIndex), _mm256_castsi256_ps(index), greater));
+            index = _mm256_add_epi32(index, step);
+        }
+
+        alignas(32) float values[8];
+        alignas(32) int32_t indices[8];
+        _mm256_store_ps(values, bestValue);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(indices), bestIndex);
+        size_t best = ReduceArgMax(values, indices, 8, maxDistance);
+
+        for (; i < count; ++i)
+        {
+            float distance = plane.Distance({ x[i], y[i], z[i] });
+            if (distance > *maxDistance)
+            {
+                *maxDistance = distance;
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    // 8 packed lane numbers (one per byte) moving the lanes set in an 8bit mask to the front
+    constexpr auto LEFT_PACK_8 = []
+    {
+        std::array<uint64_t, 256> table = {};
+        for (int mask = 0; mask < 256; ++mask)
+        {
+            int lane = 0;
+            for (int j = 0; j < 8; ++j)
+            {
+                if (mask & (1 << j)) table[mask] |= static_cast<uint64_t>(j) << (8 * lane++);
+            }
+        }
+        return table;
+    }();
+
+    HULL_TARGET("avx2")
+    size_t PartitionAboveAVX2(const Plane& plane, float tolerance, float* x, float* y, float* z, uint32_t* index, size_t count,
+        uint32_t* aboveIndices, float* aboveDistances, size_t* belowCount)
+    {
+        const __m256 nx = _mm256_set1_ps(plane.normal.x);
+        const __m256 ny = _mm256_set1_ps(plane.normal.y);
+        const __m256 nz = _mm256_set1_ps(plane.normal.z);
+        const __m256 offset = _mm256_set1_ps(plane.offset);
+        const __m256 limit = _mm256_set1_ps(tolerance);
+
+        size_t above = 0;
+        size_t below = 0;
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 px = _mm256_loadu_ps(x + i);
+            __m256 py = _mm256_loadu_ps(y + i);
+            __m256 pz = _mm256_loadu_ps(z + i);
+            __m256i pi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index + i));
+
+            __m256 d = _mm256_add_ps(_mm256_mul_ps(nx, px), _mm256_mul_ps(ny, py));
+            d = _mm256_sub_ps(_mm256_add_ps(d, _mm256_mul_ps(nz, pz)), offset);
+
+            int mask = _mm256_movemask_ps(_mm256_cmp_ps(d, limit, _CMP_GT_OQ));
+            int belowMask = ~mask & 0xff;
+
+            __m256i packAbove = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(static_cast<long long>(LEFT_PACK_8[mask])));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(aboveIndices + above), _mm256_permutevar8x32_epi32(pi, packAbove));
+            _mm256_storeu_ps(aboveDistances + above, _mm256_permutevar8x32_ps(d, packAbove));
+            above += std::popcount(static_cast<unsigned>(mask));
+
+            // below writes land on lanes already loaded (below <= i)
+            __m256i packBelow = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(static_cast<long long>(LEFT_PACK_8[belowMask])));
+            _mm256_storeu_ps(x + below, _mm256_permutevar8x32_ps(px, packBelow));
+            _mm256_storeu_ps(y + below, _mm256_permutevar8x32_ps(py, packBelow));
+            _mm256_storeu_ps(z + below, _mm256_permutevar8x32_ps(pz, packBelow));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(index + below), _mm256_permutevar8x32_epi32(pi, packBelow));
+            below += std::popcount(static_cast<unsigned>(belowMask));
+        }
+
+        size_t tailBelow = 0;
+        size_t tailAbove = PartitionAboveScalar(plane, tolerance, x + i, y + i, z + i, index + i, count - i, aboveIndices + above, aboveDistances + above, &tailBelow);
+        std::copy_n(x + i, tailBelow, x + below);
+        std::copy_n(y + i, tailBelow, y + below);
+        std::copy_n(z + i, tailBelow, z + below);
+        std::copy_n(index + i, tailBelow, index + below);
+
+        *belowCount = below + tailBelow;
+        return above + tailAbove;
+    }
+
+    HULL_TARGET("avx2")
+    void MaxDistancesAVX2(const PlanesSoA& planes, const float* x, const float* y, const float* z, size_t count, float* distances)
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 px = _mm256_loadu_ps(x + i);
+            __m256 py = _mm256_loadu_ps(y + i);
+            __m256 pz = _mm256_loadu_ps(z + i);
+
+            __m256 best = _mm256_set1_ps(-INFINITY);
+            for (size_t p = 0; p < planes.count; ++p)
+            {
+                __m256 d = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(planes.nx[p]), px), _mm256_mul_ps(_mm256_set1_ps(planes.ny[p]), py));
+                d = _mm256_sub_ps(_mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(planes.nz[p]), pz)), _mm256_set1_ps(planes.offset[p]));
+                best = _mm256_max_ps(d, best);
+            }
+            _mm256_storeu_ps(distances + i, best);
+        }
+        MaxDistancesSSE41(planes, x + i, y + i, z + i, count - i, distances + i);
+    }
+
+    HULL_TARGET("avx2")
+    void ContainPointsAVX2(const PlanesSoA& planes, float tolerance, const float* x, const float* y, const float* z, size_t count, uint8_t* inside)
+    {
+        const __m256 limit = _mm256_set1_ps(tolerance);
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 px = _mm256_loadu_ps(x + i);
+            __m256 py = _mm256_loadu_ps(y + i);
+            __m256 pz = _mm256_loadu_ps(z + i);
+
+            int outside = 0;
+            for (size_t p = 0; p < planes.count && outside != 0xff; ++p)
+            {
+                __m256 d = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(planes.nx[p]), px), _mm256_mul_ps(_mm256_set1_ps(planes.ny[p]), py));
+                d = _mm256_sub_ps(_mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(planes.nz[p]), pz)), _mm256_set1_ps(planes.offset[p]));
+                outside |= _mm256_movemask_ps(_mm256_cmp_ps(d, limit, _CMP_NLE_UQ));
+            }
+            for (int lane = 0; lane < 8; ++lane) inside[i + lane] = static_cast<uint8_t>(~outside >> lane & 1);
+        }
+        ContainPointsSSE41(planes, tolerance, x + i, y + i, z + i, count - i, inside + i);
+    }
+
+    HULL_TARGET("avx2")
+    size_t ArgMaxPlaneDistanceAVX2(const PlanesSoA& planes, const Vec3& point, float* maxDistance)
+    {
+        const __m256 px = _mm256_set1_ps(point.x);
+        const __m256 py = _mm256_set1_ps(point.y);
+        const __m256 pz = _mm256_set1_ps(point.z);
+        const __m256i step = _mm256_set1_epi32(8);
+
+        __m256 bestValue = _mm256_set1_ps(-INFINITY);
+        __m256i bestIndex = _mm256_set1_epi32(0);
+        __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+        size_t p = 0;
+        for (; p + 8 <= planes.count; p += 8)
+        {
+            __m256 d = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(planes.nx + p), px), _mm256_mul_ps(_mm256_loadu_ps(planes.ny + p), py));
+            d = _mm256_sub_ps(_mm256_add_ps(d, _mm256_mul_ps(_mm256_loadu_ps(planes.nz + p), pz)), _mm256_loadu_ps(planes.offset + p));
+
+            __m256 greater = _mm256_cmp_ps(d, bestValue, _CMP_GT_OQ);
+            bestValue = _mm256_blendv_ps(bestValue, d, greater);
+            bestIndex = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(bestIndex), _mm256_castsi256_ps(index), greater));
+            index = _mm256_add_epi32(index, step);
+        }
+
+        alignas(32) float values[8];
+        alignas(32) int32_t indices[8];
+        _mm256_store_ps(values, bestValue);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(indices), bestIndex);
+        size_t best = ReduceArgMax(values, indices, 8, maxDistance);
+
+        for (; p < planes.count; ++p)
+        {
+            float distance = Plane{ { planes.nx[p], planes.ny[p], planes.nz[p] }, planes.offset[p] }.Distance(point);
+            if (distance > *maxDistance)
+            {
+                *maxDistance = distance;
+                best = p;
+            }
+        }
+        return best;
+    }
+
+    HULL_TARGET("avx2")
+    size_t NearestTriangleAVX2(const TrianglesSoA& triangles, const Vec3& point, float* distanceSq)
+    {
+        const __m256 px = _mm256_set1_ps(point.x);
+        const __m256 py = _mm256_set1_ps(point.y);
+        const __m256 pz = _mm256_set1_ps(point.z);
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256i step = _mm256_set1_epi32(8);
+
+        __m256 bestValue = _mm256_set1_ps(INFINITY);
+        __m256i bestIndex = _mm256_set1_epi32(0);
+        __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+        size_t i = 0;
+        for (; i + 8 <= triangles.count; i += 8)
+        {
+            __m256 abx = _mm256_loadu_ps(triangles.abx + i), aby = _mm256_loadu_ps(triangles.aby + i), abz = _mm256_loadu_ps(triangles.abz + i);
+            __m256 acx = _mm256_loadu_ps(triangles.acx + i), acy = _mm256_loadu_ps(triangles.acy + i), acz = _mm256_loadu_ps(triangles.acz + i);
+            __m256 apx = _mm256_sub_ps(px, _mm256_loadu_ps(triangles.ax + i));
+            __m256 apy = _mm256_sub_ps(py, _mm256_loadu_ps(triangles.ay + i));
+            __m256 apz = _mm256_sub_ps(pz, _mm256_loadu_ps(triangles.az + i));
+            __m256 d1 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(abx, apx), _mm256_mul_ps(aby, apy)), _mm256_mul_ps(abz, apz));
+            __m256 d2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(acx, apx), _mm256_mul_ps(acy, apy)), _mm256_mul_ps(acz, apz));
+            __m256 abac = _mm256_loadu_ps(triangles.abac + i);
+            __m256 d3 = _mm256_sub_ps(d1, _mm256_loadu_ps(triangles.abab + i));
+            __m256 d4 = _mm256_sub_ps(d2, abac);
+            __m256 d5 = _mm256_sub_ps(d1, abac);
+            __m256 d6 = _mm256_sub_ps(d2, _mm256_loadu_ps(triangles.acac + i));
+            __m256 vc = _mm256_sub_ps(_mm256_mul_ps(d1, d4), _mm256_mul_ps(d3, d2));
+            __m256 vb = _mm256_sub_ps(_mm256_mul_ps(d5, d2), _mm256_mul_ps(d1, d6));
+            __m256 va = _mm256_sub_ps(_mm256_mul_ps(d3, d6), _mm256_mul_ps(d5, d4));
+
+            // region masks, applied from the lowest priority up
+            __m256 e = _mm256_sub_ps(d4, d3);
+            __m256 f = _mm256_sub_ps(d5, d6);
+            __m256 inBC = _mm256_and_ps(_mm256_cmp_ps(va, zero, _CMP_LE_OQ), _mm256_and_ps(_mm256_cmp_ps(e, zero, _CMP_GE_OQ), _mm256_cmp_ps(f, zero, _CMP_GE_OQ)));
+            __m256 inAC = _mm256_and_ps(_mm256_cmp_ps(vb, zero, _CMP_LE_OQ), _mm256_and_ps(_mm256_cmp_ps(d2, zero, _CMP_GE_OQ), _mm256_cmp_ps(d6, zero, _CMP_LE_OQ)));
+            __m256 inC = _mm256_and_ps(_mm256_cmp_ps(d6, zero, _CMP_GE_OQ), _mm256_cmp_ps(d5, d6, _CMP_LE_OQ));
+            __m256 inAB = _mm256_and_ps(_mm256_cmp_ps(vc, zero, _CMP_LE_OQ), _mm256_and_ps(_mm256_cmp_ps(d1, zero, _CMP_GE_OQ), _mm256_cmp_ps(d3, zero, _CMP_LE_OQ)));
+            __m256 inB = _mm256_and_ps(_mm256_cmp_ps(d3, zero, _CMP_GE_OQ), _mm256_cmp_ps(d4, d3, _CMP_LE_OQ));
+            __m256 inA = _mm256_and_ps(_mm256_cmp_ps(d1, zero, _CMP_LE_OQ), _mm256_cmp_ps(d2, zero, _CMP_LE_OQ));
+
+            __m256 numerator = _mm256_blendv_ps(_mm256_blendv_ps(e, d2, inAC), d1, inAB);
+            __m256 denominator = _mm256_blendv_ps(_mm256_blendv_ps(_mm256_add_ps(e, f), _mm256_sub_ps(d2, d6), inAC), _mm256_sub_ps(d1, d3), inAB);
+            __m256 t = _mm256_div_ps(numerator, denominator);
+            __m256 inverse = _mm256_div_ps(one, _mm256_add_ps(_mm256_add_ps(va, vb), vc));
+
+            __m256 v = _mm256_mul_ps(vb, inverse);
+            __m256 w = _mm256_mul_ps(vc, inverse);
+            v = _mm256_blendv_ps(v, _mm256_sub_ps(one, t), inBC);
+            w = _mm256_blendv_ps(w, t, inBC);
+            v = _mm256_blendv_ps(v, zero, inAC);
+            w = _mm256_blendv_ps(w, t, inAC);
+            v = _mm256_blendv_ps(v, zero, inC);
+            w = _mm256_blendv_ps(w, one, inC);
+            v = _mm256_blendv_ps(v, t, inAB);
+            w = _mm256_blendv_ps(w, zero, inAB);
+            v = _mm256_blendv_ps(v, one, inB);
+            w = _mm256_blendv_ps(w, zero, inB);
+            v = _mm256_andnot_ps(inA, v);
+            w = _mm256_andnot_ps(inA, w);
+
+            __m256 dx = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(abx, v), _mm256_mul_ps(acx, w)), apx);
+            __m256 dy = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(aby, v), _mm256_mul_ps(acy, w)), apy);
+            __m256 dz = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(abz, v), _mm256_mul_ps(acz, w)), apz);
+            __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+
+            __m256 less = _mm256_cmp_ps(d, bestValue, _CMP_LT_OQ);
+            bestValue = _mm256_blendv_ps(bestValue, d, less);
+            bestIndex = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(bestIndex), _mm256_castsi256_ps(index), less));
+            index = _mm256_add_epi32(index, step);
+        }
+
+        alignas(32) float values[8];
+        alignas(32) int32_t indices[8];
+        _mm256_store_ps(values, bestValue);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(indices), bestIndex);
+        size_t best = ReduceArgMin(values, indices, 8, distanceSq);
+
+        for (; i < triangles.count; ++i)
+        {
+            float d = TriangleDistanceSq(triangles, i, point);
+            if (d < *distanceSq)
+            {
+                *distanceSq = d;
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    HULL_TARGET("avx2")
+    size_t CrossingArcsAVX2(const Vec3& n1, const Vec3& n2, const Vec3& cross, const ArcsSoA& arcs, uint32_t* crossing)
+    {
+        const __m256 ax = _mm256_set1_ps(n1.x), ay = _mm256_set1_ps(n1.y), az = _mm256_set1_ps(n1.z);
+        const __m256 bx = _mm256_set1_ps(n2.x), by = _mm256_set1_ps(n2.y), bz = _mm256_set1_ps(n2.z);
+        const __m256 cx = _mm256_set1_ps(cross.x), cy = _mm256_set1_ps(cross.y), cz = _mm256_set1_ps(cross.z);
+        const __m256 zero = _mm256_setzero_ps();
+
+        size_t count = 0;
+        size_t i = 0;
+        for (; i + 8 <= arcs.count; i += 8)
+        {
+            __m256 p = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(arcs.x1 + i), cx), _mm256_mul_ps(_mm256_loadu_ps(arcs.y1 + i), cy)), _mm256_mul_ps(_mm256_loadu_ps(arcs.z1 + i), cz));
+            __m256 q = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(arcs.x2 + i), cx), _mm256_mul_ps(_mm256_loadu_ps(arcs.y2 + i), cy)), _mm256_mul_ps(_mm256_loadu_ps(arcs.z2 + i), cz));
+            __m256 arcX = _mm256_loadu_ps(arcs.cx + i), arcY = _mm256_loadu_ps(arcs.cy + i), arcZ = _mm256_loadu_ps(arcs.cz + i);
+            __m256 r = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(arcX, ax), _mm256_mul_ps(arcY, ay)), _mm256_mul_ps(arcZ, az));
+            __m256 s = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(arcX, bx), _mm256_mul_ps(arcY, by)), _mm256_mul_ps(arcZ, bz));
+
+            __m256 crosses = _mm256_and_ps(_mm256_cmp_ps(_mm256_mul_ps(p, q), zero, _CMP_LT_OQ), _mm256_and_ps(_mm256_cmp_ps(_mm256_mul_ps(r, s), zero, _CMP_LT_OQ), _mm256_cmp_ps(_mm256_mul_ps(p, s), zero, _CMP_LT_OQ)));
+            for (unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(crosses)); mask != 0; mask &= mask - 1)
+            {
+                crossing[count++] = static_cast<uint32_t>(i + std::countr_zero(mask));
+            }
+        }
+
+        ArcsSoA rest = { arcs.x1 + i, arcs.y1 + i, arcs.z1 + i, arcs.x2 + i, arcs.y2 + i, arcs.z2 + i, arcs.cx + i, arcs.cy + i, arcs.cz + i, arcs.count - i };
+        size_t restCount = CrossingArcsSSE41(n1, n2, cross, rest, crossing + count);
+        for (size_t j = count; j < count + restCount; ++j) crossing[j] += static_cast<uint32_t>(i);
+        return count + restCount;
+    }
+
+    HULL_TARGET("avx2")
+    void ClipRaysAVX2(const PlanesSoA& planes, const RaysSoA& rays, float* tEnter, float* tExit, uint32_t* enterPlane, uint32_t* exitPlane)
+    {
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 signBit = _mm256_set1_ps(-0.0f);
+
+        size_t i = 0;
+        for (; i + 8 <= rays.count; i += 8)
+        {
+            __m256 ox = _mm256_loadu_ps(rays.ox + i), oy = _mm256_loadu_ps(rays.oy + i), oz = _mm256_loadu_ps(rays.oz + i);
+            __m256 dx = _mm256_loadu_ps(rays.dx + i), dy = _mm256_loadu_ps(rays.dy + i), dz = _mm256_loadu_ps(rays.dz + i);
+            __m256 enter = _mm256_loadu_ps(rays.tMin + i);
+            __m256 exit = _mm256_loadu_ps(rays.tMax + i);
+            __m256 enterIndex = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            __m256 exitIndex = enterIndex;
+
+            __m256 miss = _mm256_cmp_ps(enter, exit, _CMP_NLE_UQ);
+            for (size_t p = 0; p < planes.count && _mm256_movemask_ps(miss) != 0xff; ++p)
+            {
+                __m256 nx = _mm256_set1_ps(planes.nx[p]), ny = _mm256_set1_ps(planes.ny[p]), nz = _mm256_set1_ps(planes.nz[p]);
+                __m256 facing = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx, dx), _mm256_mul_ps(ny, dy)), _mm256_mul_ps(nz, dz));
+                __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx, ox), _mm256_mul_ps(ny, oy)), _mm256_mul_ps(nz, oz));
+                distance = _mm256_sub_ps(distance, _mm256_set1_ps(planes.offset[p]));
+                __m256 t = _mm256_div_ps(_mm256_xor_ps(distance, signBit), facing);
+                __m256 index = _mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int>(p)));
+
+                __m256 entering = _mm256_cmp_ps(facing, zero, _CMP_LT_OQ);
+                __m256 leaving = _mm256_cmp_ps(facing, zero, _CMP_GT_OQ);
+                __m256 later = _mm256_and_ps(entering, _mm256_cmp_ps(t, enter, _CMP_GT_OQ));
+                __m256 sooner = _mm256_and_ps(leaving, _mm256_cmp_ps(t, exit, _CMP_LT_OQ));
+                enter = _mm256_blendv_ps(enter, t, later);
+                enterIndex = _mm256_blendv_ps(enterIndex, index, later);
+                exit = _mm256_blendv_ps(exit, t, sooner);
+                exitIndex = _mm256_blendv_ps(exitIndex, index, sooner);
+
+                __m256 parallelOutside = _mm256_andnot_ps(_mm256_or_ps(entering, leaving), _mm256_cmp_ps(distance, zero, _CMP_NLE_UQ));
+                miss = _mm256_or_ps(miss, _mm256_or_ps(parallelOutside, _mm256_cmp_ps(enter, exit, _CMP_GT_OQ)));
+            }
+
+            _mm256_storeu_ps(tEnter + i, _mm256_blendv_ps(enter, _mm256_set1_ps(INFINITY), miss));
+            _mm256_storeu_ps(tExit + i, _mm256_blendv_ps(exit, _mm256_set1_ps(-INFINITY), miss));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(enterPlane + i), _mm256_castps_si256(_mm256_or_ps(enterIndex, miss)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(exitPlane + i), _mm256_castps_si256(_mm256_or_ps(exitIndex, miss)));
+        }
+        ClipRaysSSE41(planes, RaysFrom(rays, i), tEnter + i, tExit + i, enterPlane + i, exitPlane + i);
+    }
+
+    // det * (au * av + bu * bv + cu * cv + su * sv)
+    HULL_TARGET("avx2")
+    __m256 SecondMomentAVX2(__m256 det, __m256 au, __m256 av, __m256 bu, __m256 bv, __m256 cu, __m256 cv, __m256 su, __m256 sv)
+    {
+        return _mm256_mul_ps(det, _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(au, av), _mm256_mul_ps(bu, bv)), _mm256_mul_ps(cu, cv)), _mm256_mul_ps(su, sv)));
+    }
+
+    HULL_TARGET("avx2")
+    void TetrahedronMomentsAVX2(const CornersSoA& triangles, double* moments)
+    {
+        __m256d sums[MOMENT_COUNT];
+        for (size_t k = 0; k < MOMENT_COUNT; ++k) sums[k] = _mm256_setzero_pd();
+
+        size_t i = 0;
+        for (; i + 8 <= triangles.count; i += 8)
+        {
+            __m256 ax = _mm256_loadu_ps(triangles.ax + i), ay = _mm256_loadu_ps(triangles.ay + i), az = _mm256_loadu_ps(triangles.az + i);
+            __m256 bx = _mm256_loadu_ps(triangles.bx + i), by = _mm256_loadu_ps(triangles.by + i), bz = _mm256_loadu_ps(triangles.bz + i);
+            __m256 cx = _mm256_loadu_ps(triangles.cx + i), cy = _mm256_loadu_ps(triangles.cy + i), cz = _mm256_loadu_ps(triangles.cz + i);
+
+            __m256 det = _mm256_add_ps(_mm256_add_ps(
+                _mm256_mul_ps(ax, _mm256_sub_ps(_mm256_mul_ps(by, cz), _mm256_mul_ps(bz, cy))),
+                _mm256_mul_ps(ay, _mm256_sub_ps(_mm256_mul_ps(bz, cx), _mm256_mul_ps(bx, cz)))),
+                _mm256_mul_ps(az, _mm256_sub_ps(_mm256_mul_ps(bx, cy), _mm256_mul_ps(by, cx))));
+            __m256 sx = _mm256_add_ps(_mm256_add_ps(ax, bx), cx);
+            __m256 sy = _mm256_add_ps(_mm256_add_ps(ay, by), cy);
+            __m256 sz = _mm256_add_ps(_mm256_add_ps(az, bz), cz);
+
+            const __m256 terms[MOMENT_COUNT] =
+            {
+                det,
+                _mm256_mul_ps(det, sx),
+                _mm256_mul_ps(det, sy),
+                _mm256_mul_ps(det, sz),
+                SecondMomentAVX2(det, ax, ax, bx, bx, cx, cx, sx, sx),
+                SecondMomentAVX2(det, ay, ay, by, by, cy, cy, sy, sy),
+                SecondMomentAVX2(det, az, az, bz, bz, cz, cz, sz, sz),
+                SecondMomentAVX2(det, ax, ay, bx, by, cx, cy, sx, sy),
+                SecondMomentAVX2(det, ay, az, by, bz, cy, cz, sy, sz),
+                SecondMomentAVX2(det, az, ax, bz, bx, cz, cx, sz, sx),
+            };
+
+            // triangles i .. i + 3, then i + 4 .. i + 7 into lanes 0 .. 3
+            for (size_t k = 0; k < MOMENT_COUNT; ++k)
+            {
+                sums[k] = _mm256_add_pd(sums[k], _mm256_cvtps_pd(_mm256_castps256_ps128(terms[k])));
+                sums[k] = _mm256_add_pd(sums[k], _mm256_cvtps_pd(_mm256_extractf128_ps(terms[k], 1)));
+            }
+        }
+
+        MomentLanes lanes;
+        for (size_t k = 0; k < MOMENT_COUNT; ++k) _mm256_storeu_pd(lanes[k], sums[k]);
+        AccumulateMomentsSSE41(CornersFrom(triangles, i), lanes);
+        AddMomentLanes(lanes, moments);
+    }
+
+#endif
+
+    ///////////////////////////////////////////////////////////
+    // dispatch
+
+    using CalcDistancesFunc = void (*)(const Plane&, const float*, const float*, const float*, size_t, float*);
+    using ArgMaxDistanceFunc = size_t (*)(const Plane&, const float*, const float*, const float*, size_t, float*);
+    using PartitionAboveFunc = size_t (*)(const Plane&, float, float*, float*, float*, uint32_t*, size_t, uint32_t*, float*, size_t*);
+    using MaxDistancesFunc = void (*)(const PlanesSoA&, const float*, const float*, const float*, size_t, float*);
+    using ContainPointsFunc = void (*)(const PlanesSoA&, float, const float*, const float*, const float*, size_t, uint8_t*);
+    using ArgMaxPlaneDistanceFunc = size_t (*)(const PlanesSoA&, const Vec3&, float*);
+    using NearestTriangleFunc = size_t (*)(const TrianglesSoA&, const Vec3&, float*);
+    using CrossingArcsFunc = size_t (*)(const Vec3&, const Vec3&, const Vec3&, const ArcsSoA&, uint32_t*);
+    using ClipRaysFunc = void (*)(const PlanesSoA&, const RaysSoA&, float*, float*, uint32_t*, uint32_t*);
+    using TetrahedronMomentsFunc = void (*)(const CornersSoA&, double*);
+
+    // -1 : not selected yet
+    std::atomic<int> selectedLevel(-1);
+
+    SimdLevel Selected()
+    {
+        int level = selectedLevel.load(std::memory_order_relaxed);
+        if (level < 0)
+        {
+            level = static_cast<int>(DetectSimdLevel());
+            selectedLevel.store(level, std::memory_order_relaxed);
+        }
+        return static_cast<SimdLevel>(level);
+    }
+
+    CalcDistancesFunc GetCalcDistances()
+    {
+        switch (Selected())
+        {
+#if defined(HULL_X86)
+        case SimdLevel::AVX2:  return CalcDistancesAVX2;
+        case SimdLevel::SSE41: return CalcDistancesSSE41;
+#endif
+        default: return CalcDistancesScalar;
+        }
+    }
+
+    ArgMaxDistanceFunc GetArgMaxDistance()
+    {
+        switch (Selected())
+        {
+#if defined(HULL_X86)
+        case SimdLevel::AVX2:  return ArgMaxDistanceAVX2;
+        case SimdLevel::SSE41: return ArgMaxDistanceSSE41;
+#endif
+        default: return ArgMaxDistanceScalar;
+        }
+    }
+
+    PartitionAboveFunc GetPartitionAbove()
+    {
+        switch (Selected())
+        {
+#if defined(HULL_X86)
+        case SimdLevel::AVX2:  return PartitionAboveAVX2;
+        case SimdLevel::SSE41: return PartitionAboveSSE41;
+#endif
+        default: return PartitionAboveScalar;
+        }
+    }
+
+    MaxDistancesFunc GetMaxDistances()
+    {
+        switch (Selected())
+        {
+#if defined(HULL_X86)
+        case SimdLevel::AVX2:  return MaxDistancesAVX2;
+        case SimdLevel::SSE41: return MaxDistancesSSE41;
+#endif
+        default: return MaxDistancesScalar;
+        }
+    }
+
+    ContainPointsFunc GetContainPoints()
+    {
+        switch (Selected())
+        {
+#if defined(HULL_X86)
+        case SimdLevel::AVX2:  return ContainPointsAVX2;
+        case SimdLevel::SSE41: return ContainPointsSSE41;
+#endif
+        default: return ContainPointsScalar;
+        }
+    }
+
+    ArgMaxPlaneDistanceFunc GetArgMaxPlaneDistance()
+    {
+        switch (Selected())
+        {
+#if defined(HULL_X86)
+        case SimdLevel::AVX2:  return ArgMaxPlaneDistanceAVX2;
+        case SimdLevel::SSE41: return ArgMaxPlaneDistanceSSE41;
+#endif
+        default: return ArgMaxPlaneDistanceScalar;
+        }
+    }
+
+    NearestTriangleFunc GetNearestTriangle()
+    {
+        switch (Selected())
+        {
+#if defined(HULL_X86)
+        case SimdLevel::AVX2:  return NearestTriangleAVX2;
+        case SimdLevel::SSE41: return NearestTriangleSSE41;
+#endif
+        default: return NearestTriangleScalar;
+        }
+    }
+
+    CrossingArcsFunc GetCrossingArcs()
+    {
+        switch (Selected())
+        {
+#if defined(HULL_X86)
+        case SimdLevel::AVX2:  return CrossingArcsAVX2;
+        case SimdLevel::SSE41: return CrossingArcsSSE41;
+#endif
+        default: return CrossingArcsScalar;
+        }
+    }
+
+    ClipRaysFunc GetClipRays()
+    {
+        switch (Selected())
+        {
+#if defined(HULL_X86)
+        case SimdLevel::AVX2:  return ClipRaysAVX2;
+        case SimdLevel::SSE41: return ClipRaysSSE41;
+#endif
+        default: return ClipRaysScalar;
+        }
+    }
+
+    TetrahedronMomentsFunc GetTetrahedronMoments()
+    {
+        switch (Selected())
+        {
+#if defined(HULL_X86)
+        case SimdLevel::AVX2:  return TetrahedronMomentsAVX2;
+        case SimdLevel::SSE41: return TetrahedronMomentsSSE41;
+#endif
+        default: return TetrahedronMomentsScalar;
+        }
+    }
+}
+
+SimdLevel DetectSimdLevel()
+{
+#if defined(HULL_X86) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse4.1")) return SimdLevel::SSE41;
+#elif defined(HULL_X86) && defined(_MSC_VER)
+    int info[4] = {};
+    __cpuid(info, 1);
+    bool sse41 = (info[2] & (1 << 19)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+
+    // ymm state enabled by the os
+    bool ymm = osxsave && avx && (_xgetbv(0) & 0x6) == 0x6;
+
+    __cpuidex(info, 7, 0);
+    bool avx2 = (info[1] & (1 << 5)) != 0;
+
+    if (ymm && avx2) return SimdLevel::AVX2;
+    if (sse41) return SimdLevel::SSE41;
+#endif
+    return SimdLevel::Scalar;
+}
+
+SimdLevel GetSimdLevel()
+{
+    return Selected();
+}
+
+void SetSimdLevel(SimdLevel level)
+{
+    level = std::min(level, DetectSimdLevel());
+    selectedLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+const char* ToString(SimdLevel level)
+{
+    switch (level)
+    {
+    case SimdLevel::AVX2:  return "avx2";
+    case SimdLevel::SSE41: return "sse4.1";
+    default:               return "scalar";
+    }
+}
+
+void CalcDistances(const Plane& plane, const float* x, const float* y, const float* z, size_t count, float* distances)
+{
+    GetCalcDistances()(plane, x, y, z, count, distances);
+}
+
+size_t ArgMaxDistance(const Plane& plane, const float* x, const float* y, const float* z, size_t count, float* maxDistance)
+{
+    ArgMaxDistanceFunc func = GetArgMaxDistance();
+
+    size_t best = func(plane, x, y, z, std::min(count, MAX_BLOCK), maxDistance);
+    for (size_t base = MAX_BLOCK; base < count; base += MAX_BLOCK)
+    {
+        float blockMax;
+        size_t blockBest = base + func(plane, x + base, y + base, z + base, std::min(count - base, MAX_BLOCK), &blockMax);
+        if (blockMax > *maxDistance)
+        {
+            *maxDistance = blockMax;
+            best = blockBest;
+        }
+    }
+    return best;
+}
+
+size_t PartitionAbove(const Plane& plane, float tolerance, float* x, float* y, float* z, uint32_t* index, size_t count,
+    uint32_t* aboveIndices, float* aboveDistances, size_t* belowCount)
+{
+    return GetPartitionAbove()(plane, tolerance, x, y, z, index, count, aboveIndices, aboveDistances, belowCount);
+}
+
+void MaxDistances(const PlanesSoA& planes, const float* x, const float* y, const float* z, size_t count, float* distances)
+{
+    GetMaxDistances()(planes, x, y, z, count, distances);
+}
+
+void ContainPoints(const PlanesSoA& planes, float tolerance, const float* x, const float* y, const float* z, size_t count, uint8_t* inside)
+{
+    GetContainPoints()(planes, tolerance, x, y, z, count, inside);
+}
+
+size_t ArgMaxPlaneDistance(const PlanesSoA& planes, const Vec3& point, float* maxDistance)
+{
+    return GetArgMaxPlaneDistance()(planes, point, maxDistance);
+}
+
+size_t NearestTriangle(const TrianglesSoA& triangles, const Vec3& point, float* distanceSq)
+{
+    return GetNearestTriangle()(triangles, point, distanceSq);
+}
+
+size_t CrossingArcs(const Vec3& n1, const Vec3& n2, const Vec3& cross, const ArcsSoA& arcs, uint32_t* crossing)
+{
+    return GetCrossingArcs()(n1, n2, cross, arcs, crossing);
+}
+
+void ClipRays(const PlanesSoA& planes, const RaysSoA& rays, float* tEnter, float* tExit, uint32_t* enterPlane, uint32_t* exitPlane)
+{
+    GetClipRays()(planes, rays, tEnter, tExit, enterPlane, exitPlane);
+}
+
+void TetrahedronMoments(const CornersSoA& triangles, double* moments)
+{
+    GetTetrahedronMoments()(triangles, moments);
+}
+
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Vec3.hpp"
+
+namespace hull
+{
+	// instruction set used by the batch kernels
+	enum class SimdLevel
+	{
+		Scalar,
+		SSE41,
+		AVX2,
+	};
+
+	// best level supported by this cpu
+	SimdLevel DetectSimdLevel();
+
+	// level in use (detected on first call unless set)
+	SimdLevel GetSimdLevel();
+
+	// force a level (clamped to the detected one), for benchmarks
+	void SetSimdLevel(SimdLevel level);
+
+	const char* ToString(SimdLevel level);
+
+	// distances[i] = plane.Distance(p_i)
+	// all levels evaluate ((nx * x + ny * y) + nz * z) - offset without fma, so results are bit-identical to Plane::Distance.
+	void CalcDistances(const Plane& plane, const float* x, const float* y, const float* z, size_t count, float* distances);
+
+	// return : index of the largest plane.Distance(p_i) (first one on ties), count must be > 0
+	size_t ArgMaxDistance(const Plane& plane, const float* x, const float* y, const float* z, size_t count, float* maxDistance);
+
+	// planes in soa form : plane i = { { nx[i], ny[i], nz[i] }, offset[i] }
+	struct PlanesSoA
+	{
+		const float* nx;
+		const float* ny;
+		const float* nz;
+		const float* offset;
+		size_t count;
+	};
+
+	// distances[i] = largest plane.Distance(p_i) over planes (-inf without planes), bit-identical on all levels
+	void MaxDistances(const PlanesSoA& planes, const float* x, const float* y, const float* z, size_t count, float* distances);
+
+	// inside[i] = 1 if plane.Distance(p_i) <= tolerance for every plane, else 0 (nan points : 0)
+	// a group of points (1, 4 or 8 by level) stops at the first plane all of them are outside of
+	void ContainPoints(const PlanesSoA& planes, float tolerance, const float* x, const float* y, const float* z, size_t count, uint8_t* inside);
+
+	// return : index of the plane point is furthest in front of (first one on ties), maxDistance receives its distance, planes.count must be > 0
+	// vectorized over the planes (one point : MaxDistances would run its scalar tail)
+	size_t ArgMaxPlaneDistance(const PlanesSoA& planes, const Vec3& point, float* maxDistance);
+
+	// triangles in soa form : corner a, edges ab = b - a and ac = c - a, and the edge dot products Dot(ab, ab), Dot(ab, ac), Dot(ac, ac)
+	struct TrianglesSoA
+	{
+		const float* ax;
+		const float* ay;
+		const float* az;
+		const float* abx;
+		const float* aby;
+		const float* abz;
+		const float* acx;
+		const float* acy;
+		const float* acz;
+		const float* abab;
+		const float* abac;
+		const float* acac;
+		size_t count;
+	};
+
+	// return : index of the triangle closest to point (first one on ties), distanceSq receives the squared distance, triangles.count must be > 0
+	// the voronoi regions of ClosestPointOnTriangle are resolved with selects over 4 or 8 triangles at once, identically on all levels
+	size_t NearestTriangle(const TrianglesSoA& triangles, const Vec3& point, float* distanceSq);
+
+	// gauss map arcs in soa form : arc i joins the normals n1 = (x1, y1, z1), n2 = (x2, y2, z2) of the two faces of edge i, cross = Cross(n2, n1) = (cx, cy, cz)
+	struct ArcsSoA
+	{
+		const float* x1;
+		const float* y1;
+		const float* z1;
+		const float* x2;
+		const float* y2;
+		const float* z2;
+		const float* cx;
+		const float* cy;
+		const float* cz;
+		size_t count;
+	};
+
+	// return : number of arcs crossing the arc (n1, n2) of the other hull mirrored through the origin (the edge pairs forming a face of the
+	// minkowski difference, the only edge-edge axes sat needs), their indices in ascending order in crossing (room for arcs.count)
+	size_t CrossingArcs(const Vec3& n1, const Vec3& n2, const Vec3& cross, const ArcsSoA& arcs, uint32_t* crossing);
+
+	// rays in soa form : ray i = origin + t * direction for t in [tMin[i], tMax[i]]
+	struct RaysSoA
+	{
+		const float* ox;
+		const float* oy;
+		const float* oz;
+		const float* dx;
+		const float* dy;
+		const float* dz;
+		const float* tMin;
+		const float* tMax;
+		size_t count;
+	};
+
+	// plane index of a ray that starts or ends inside every plane
+	constexpr uint32_t NO_PLANE = ~0u;
+
+	// clip each ray against the planes (cyrus-beck) : tEnter[i] / tExit[i] bound the part of ray i behind every plane,
+	// enterPlane[i] / exitPlane[i] are the planes that bound it (NO_PLANE where tMin / tMax does).
+	// a ray missing the planes gets tEnter = inf, tExit = -inf and NO_PLANE twice, so results are identical on all levels.
+	// rays go through in packets of 4 or 8 (by level), a packet stops at the first plane all of its rays miss by
+	void ClipRays(const PlanesSoA& planes, const RaysSoA& rays, float* tEnter, float* tExit, uint32_t* enterPlane, uint32_t* exitPlane);
+
+	// triangles in soa form by corner : triangle i = (a, b, c) with a = (ax[i], ay[i], az[i]), b = (bx[i], ...), c = (cx[i], ...)
+	struct CornersSoA
+	{
+		const float* ax;
+		const float* ay;
+		const float* az;
+		const float* bx;
+		const float* by;
+		const float* bz;
+		const float* cx;
+		const float* cy;
+		const float* cz;
+		size_t count;
+	};
+
+	// sums added by TetrahedronMoments
+	constexpr size_t MOMENT_COUNT = 10;
+
+	// add the moments of the tetrahedra (origin, a, b, c) to moments : with d = Dot(a, Cross(b, c)) and s = a + b + c,
+	// d (6 * volume), d * s.x, d * s.y, d * s.z (24 * first moments), then for xx, yy, zz, xy, yz, zx
+	// d * (a.x * a.y + b.x * b.y + c.x * c.y + s.x * s.y) (120 * second moments, for xy).
+	// volumes are signed (> 0 : the origin is behind the plane of Cross(b - a, c - a), as for hull faces and a point inside).
+	// the terms are evaluated 4 or 8 triangles at once in float and summed in double, triangle i into lane i % 4 in triangle order and the 4 lanes
+	// last, so sums are identical on all levels
+	void TetrahedronMoments(const CornersSoA& triangles, double* moments);
+
+	// split points by plane.Distance(p) > tolerance, order is kept on both sides.
+	// above : index and distance of each point are appended to aboveIndices / aboveDistances
+	// below : x, y, z, index are compacted in place to the front, *belowCount receives their count
+	// return : above count
+	// output buffers need count + PARTITION_PADDING entries
+	constexpr size_t PARTITION_PADDING = 8;
+	size_t PartitionAbove(const Plane& plane, float tolerance, float* x, float* y, float* z, uint32_t* index, size_t count,
+		uint32_t* aboveIndices, float* aboveDistances, size_t* belowCount);
+}
@@ -0,0 +1,238 @@
+#include "PlaneSet.hpp"
+
+#include "CubeMap.hpp"
+#include "Parallel.hpp"
+#include "PointSoA.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace hull
+{
+
+namespace
+{
+    // rays per soa packet block
+    constexpr size_t RAY_BLOCK_SIZE = 256;
+
+    // smallest ray range worth a worker thread
+    constexpr size_t MIN_PARALLEL_RAYS = 8192;
+
+    // exit plane pretest : only for sets this large (smaller ones are scanned about as fast by the kernels)
+    constexpr size_t MIN_EXIT_PLANES = 256;
+
+    // cells per cube map side of the exit planes, fewer for large sets (build cost : cells * planes)
+    constexpr int MAX_CELL_RESOLUTION = 16;
+    constexpr double MAX_EXIT_TESTS = 1 << 24;
+}
+
+void PlaneSet::Build(const Hull& hull)
+{
+    std::vector<Plane> planes(hull.FaceCount());
+    for (size_t face = 0; face < planes.size(); ++face) planes[face] = hull.FacePlane(face);
+    this->SetPlanes(planes, hull.vertices);
+}
+
+void PlaneSet::Build(const PolygonHull& polygons)
+{
+    this->SetPlanes(polygons.planes, polygons.vertices);
+}
+
+void PlaneSet::Clear()
+{
+    this->nx.clear();
+    this->ny.clear();
+    this->nz.clear();
+    this->offset.clear();
+    this->center = {};
+    this->innerRadius = 0;
+    this->cellPlanes.clear();
+    this->cellResolution = 0;
+}
+
+void PlaneSet::SetPlanes(const std::vector<Plane>& planes, const std::vector<Vec3>& vertices)
+{
+    this->Clear();
+
+    this->nx.reserve(planes.size());
+    this->ny.reserve(planes.size());
+    this->nz.reserve(planes.size());
+    this->offset.reserve(planes.size());
+    for (const Plane& plane : planes)
+    {
+        this->nx.push_back(plane.normal.x);
+        this->ny.push_back(plane.normal.y);
+        this->nz.push_back(plane.normal.z);
+        this->offset.push_back(plane.offset);
+    }
+    if (planes.empty() || vertices.empty()) return;
+
+    // ball around the vertex centroid touching the nearest plane, shrunk against rounding
+    for (const Vec3& vertex : vertices) this->center += vertex;
+    this->center = this->center / static_cast<float>(vertices.size());
+
+    float radius = FLT_MAX;
+    for (const Plane& plane : planes) radius = std::min(radius, -plane.Distance(this->center));
+    this->innerRadius = radius > 0 ? radius * (1 - 1e-4f) : 0;
+    if (radius <= 0 || planes.size() < MIN_EXIT_PLANES) return;
+
+    // exit plane : smallest ray parameter (offset - n.c) / (n.d) over the planes facing d
+    double resolution = std::sqrt(MAX_EXIT_TESTS / (6.0 * static_cast<double>(planes.size())));
+    this->cellResolution = std::clamp(static_cast<int>(resolution), 4, MAX_CELL_RESOLUTION);
+    this->cellPlanes.resize(6 * size_t(this->cellResolution) * this->cellResolution);
+    for (size_t cell = 0; cell < this->cellPlanes.size(); ++cell)
+    {
+        Vec3 direction = CubeMapDirection(cell, this->cellResolution);
+        uint32_t exit = 0;
+        float exitT = FLT_MAX;
+        for (uint32_t i = 0; i < planes.size(); ++i)
+        {
+            float facing = Dot(planes[i].normal, direction);
+            if (facing <= 0) continue;
+            float t = -planes[i].Distance(this->center) / facing;
+            if (t < exitT)
+            {
+                exitT = t;
+                exit = i;
+            }
+        }
+        this->cellPlanes[cell] = exit;
+    }
+}
+
+bool PlaneSet::Contains(const Vec3& point, float tolerance) const
+{
+    if (this->offset.empty()) return false;
+
+    uint8_t inside;
+    ContainPoints(this->Planes(), tolerance, &point.x, &point.y, &point.z, 1, &inside);
+    return inside != 0;
+}
+
+float PlaneSet::SignedDistance(const Vec3& point) const
+{
+    float distance;
+    MaxDistances(this->Planes(), &point.x, &point.y, &point.z, 1, &distance);
+    return distance;
+}
+
+void PlaneSet::Contains(const PointsView& points, float tolerance, unsigned threadCount, uint8_t* inside) const
+{
+    if (this->offset.empty())
+    {
+        std::fill_n(inside, points.count, uint8_t(0));
+        return;
+    }
+
+    // within radius + tolerance of the center : no plane is further than tolerance
+    float ballRadius = this->innerRadius > 0 ? this->innerRadius + tolerance : 0;
+    float ballRadiusSq = ballRadius > 0 ? ballRadius * ballRadius : -1;
+
+    PlanesSoA planes = this->Planes();
+    const size_t chunkCount = ChunkCount(points.count, ResolveThreadCount(threadCount), MIN_PARALLEL_POINTS);
+    ParallelChunks(points.count, chunkCount, [&](size_t, size_t begin, size_t end)
+    {
+        PointSoA block;
+        uint8_t candidateInside[BLOCK_SIZE];
+        for (size_t blockBegin = begin; blockBegin < end; blockBegin += BLOCK_SIZE)
+        {
+            size_t blockCount = std::min(BLOCK_SIZE, end - blockBegin);
+            block.AssignRange(points, blockBegin, blockCount);
+
+            float* x = block.x.data();
+            float* y = block.y.data();
+            float* z = block.z.data();
+            uint32_t* index = block.index.data();
+
+            // points in the ball are inside, points outside the exit plane of their direction are outside, the rest are compacted as candidates
+            size_t count = 0;
+            for (size_t i = 0; i < blockCount; ++i)
+            {
+                Vec3 point = { x[i], y[i], z[i] };
+                Vec3 d = point - this->center;
+                bool inBall = LengthSq(d) < ballRadiusSq;
+                inside[blockBegin + i] = inBall ? 1 : 0;
+                if (inBall) continue;
+
+                if (!this->cellPlanes.empty())
+                {
+                    size_t exit = this->cellPlanes[CubeMapCell(d, this->cellResolution)];
+                    if (this->GetPlane(exit).Distance(point) > tolerance) continue;
+                }
+
+                x[count] = x[i];
+                y[count] = y[i];
+                z[count] = z[i];
+                index[count] = index[i];
+                ++count;
+            }
+
+            ContainPoints(planes, tolerance, x, y, z, count, candidateInside);
+            for (size_t i = 0; i < count; ++i) inside[index[i]] = candidateInside[i];
+        }
+    });
+}
+
+void PlaneSet::SignedDistances(const PointsView& points, unsigned threadCount, float* distances) const
+{
+    PlanesSoA planes = this->Planes();
+    const size_t chunkCount = ChunkCount(points.count, ResolveThreadCount(threadCount), MIN_PARALLEL_POINTS);
+    ParallelChunks(points.count, chunkCount, [&](size_t, size_t begin, size_t end)
+    {
+        PointSoA block;
+        for (size_t blockBegin = begin; blockBegin < end; blockBegin += BLOCK_SIZE)
+        {
+            size_t blockCount = std::min(BLOCK_SIZE, end - blockBegin);
+            block.AssignRange(points, blockBegin, blockCount);
+            MaxDistances(planes, block.x.data(), block.y.data(), block.z.data(), blockCount, distances + blockBegin);
+        }
+    });
+}
+
+bool PlaneSet::Intersect(const Ray& ray, RayHit& hit) const
+{
+    this->Intersect(&ray, 1, 1, &hit);
+    return hit.Hit();
+}
+
+void PlaneSet::Intersect(const Ray* rays, size_t count, unsigned threadCount, RayHit* hits) const
+{
+    if (this->offset.empty())
+    {
+        std::fill_n(hits, count, RayHit{ INFINITY, -INFINITY, NO_PLANE, NO_PLANE });
+        return;
+    }
+
+    PlanesSoA planes = this->Planes();
+    const size_t chunkCount = ChunkCount(count, ResolveThreadCount(threadCount), MIN_PARALLEL_RAYS);
+    ParallelChunks(count, chunkCount, [&](size_t, size_t begin, size_t end)
+    {
+        float ox[RAY_BLOCK_SIZE], oy[RAY_BLOCK_SIZE], oz[RAY_BLOCK_SIZE];
+        float dx[RAY_BLOCK_SIZE], dy[RAY_BLOCK_SIZE], dz[RAY_BLOCK_SIZE];
+        float tMin[RAY_BLOCK_SIZE], tMax[RAY_BLOCK_SIZE];
+        float tEnter[RAY_BLOCK_SIZE], tExit[RAY_BLOCK_SIZE];
+        uint32_t enterPlane[RAY_BLOCK_SIZE], exitPlane[RAY_BLOCK_SIZE];
+        for (size_t blockBegin = begin; blockBegin < end; blockBegin += RAY_BLOCK_SIZE)
+        {
+            size_t blockCount = std::min(RAY_BLOCK_SIZE, end - blockBegin);
+            for (size_t i = 0; i < blockCount; ++i)
+            {
+                const Ray& ray = rays[blockBegin + i];
+                ox[i] = ray.origin.x;
+                oy[i] = ray.origin.y;
+                oz[i] = ray.origin.z;
+                dx[i] = ray.direction.x;
+                dy[i] = ray.direction.y;
+                dz[i] = ray.direction.z;
+                tMin[i] = ray.tMin;
+                tMax[i] = ray.tMax;
+            }
+
+            ClipRays(planes, { ox, oy, oz, dx, dy, dz, tMin, tMax, blockCount }, tEnter, tExit, enterPlane, exitPlane);
+            for (size_t i = 0; i < blockCount; ++i) hits[blockBegin + i] = { tEnter[i], tExit[i], enterPlane[i], exitPlane[i] };
+        }
+    });
+}
+
+}
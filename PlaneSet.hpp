@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "HullCore.hpp"
+#include "PlaneKernels.hpp"
+#include "PointsView.hpp"
+#include "PolygonHull.hpp"
+#include "Vec3.hpp"
+
+namespace hull
+{
+	// ray origin + t * direction for t in [tMin, tMax]
+	struct Ray
+	{
+		Vec3 origin;
+		Vec3 direction;
+		float tMin = 0;
+		float tMax = INFINITY;
+	};
+
+	// part of a ray inside the hull : [tEnter, tExit], entering through plane enterPlane and leaving through exitPlane
+	// (NO_PLANE : the ray starts / ends inside), tEnter > tExit on a miss
+	struct RayHit
+	{
+		float tEnter;
+		float tExit;
+		uint32_t enterPlane;
+		uint32_t exitPlane;
+
+		bool Hit() const { return this->tEnter <= this->tExit; }
+	};
+
+	// hull as normalized plane equations in soa form, for point-in-hull queries over many points
+	class PlaneSet
+	{
+	public:
+		PlaneSet() = default;
+		explicit PlaneSet(const Hull& hull) { this->Build(hull); }
+		explicit PlaneSet(const PolygonHull& polygons) { this->Build(polygons); }
+
+		// one plane per face (plane i = hull.FacePlane(i))
+		void Build(const Hull& hull);
+
+		// one plane per polygon (coplanar faces merged : fewer planes per query)
+		void Build(const PolygonHull& polygons);
+
+		void Clear();
+
+		size_t PlaneCount() const { return this->offset.size(); }
+
+		Plane GetPlane(size_t i) const { return { { this->nx[i], this->ny[i], this->nz[i] }, this->offset[i] }; }
+
+		PlanesSoA Planes() const { return { this->nx.data(), this->ny.data(), this->nz.data(), this->offset.data(), this->PlaneCount() }; }
+
+		// return : true if point is within tolerance of every plane (an empty set contains nothing)
+		bool Contains(const Vec3& point, float tolerance = 0) const;
+
+		// return : largest plane distance of point (< 0 inside : minus the distance to the boundary, > 0 outside : at most the distance to the hull)
+		float SignedDistance(const Vec3& point) const;
+
+		// inside[i] = Contains(points[i], tolerance)
+		// points inside the inscribed ball skip the planes, the others stop at the first plane they are outside of
+		// (large sets first test the plane the ray from the center towards the point exits through)
+		void Contains(const PointsView& points, float tolerance, unsigned threadCount, uint8_t* inside) const;
+
+		// distances[i] = SignedDistance(points[i])
+		void SignedDistances(const PointsView& points, unsigned threadCount, float* distances) const;
+
+		// clip ray against every plane (plane indices are face indices when built from a hull), an empty set is missed
+		// return : hit.Hit()
+		bool Intersect(const Ray& ray, RayHit& hit) const;
+
+		// hits[i] = Intersect(rays[i]), rays go through the kernel in soa packets (ClipRays takes soa rays directly)
+		void Intersect(const Ray* rays, size_t count, unsigned threadCount, RayHit* hits) const;
+
+	private:
+		void SetPlanes(const std::vector<Plane>& planes, const std::vector<Vec3>& vertices);
+
+		std::vector<float> nx, ny, nz, offset;
+
+		// ball inside every plane (radius 0 : none)
+		Vec3 center = {};
+		float innerRadius = 0;
+
+		// plane the ray from center through each direction cell center exits through (cube map, empty for small sets)
+		std::vector<uint32_t> cellPlanes;
+		int cellResolution = 0;
+	};
+}
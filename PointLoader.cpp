@@ -0,0 +1,518 @@
+#include "PointLoader.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "Parallel.hpp"
+
+namespace hull
+{
+
+namespace
+{
+    // smallest text range worth a parser thread
+    constexpr size_t MIN_PARALLEL_BYTES = size_t(1) << 20;
+
+    bool IsBlank(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    const char* SkipBlanks(const char* first, const char* last)
+    {
+        while (first != last && IsBlank(*first)) ++first;
+        return first;
+    }
+
+    // return : start of the line after the one containing first (last if none)
+    const char* NextLine(const char* first, const char* last)
+    {
+        const char* newline = static_cast<const char*>(std::memchr(first, '\n', last - first));
+        return newline ? newline + 1 : last;
+    }
+
+    // return : false unless first starts with a number, stored in value (leading blanks and '+' are skipped)
+    bool ParseNumber(const char*& first, const char* last, float& value)
+    {
+        first = SkipBlanks(first, last);
+        if (first != last && *first == '+') ++first;
+
+        auto [end, error] = std::from_chars(first, last, value);
+        if (error != std::errc()) return false;
+        first = end;
+        return true;
+    }
+
+    // lines of text are split into chunks of about equal size, a line belongs to the chunk its first byte is in.
+    // parseLine(first, last, point) returns true for a line with a point, chunks are concatenated in order.
+    template <typename LineParser>
+    void ParseLines(const char* text, size_t size, unsigned threadCount, std::vector<Vec3>& points, LineParser&& parseLine)
+    {
+        const char* last = text + size;
+        const size_t chunkCount = ChunkCount(size, ResolveThreadCount(threadCount), MIN_PARALLEL_BYTES);
+
+        std::vector<std::vector<Vec3>> chunks(chunkCount);
+        ParallelChunks(size, chunkCount, [&](size_t chunk, size_t begin, size_t end)
+        {
+            const char* line = text + begin;
+            if (begin > 0 && line[-1] != '\n') line = NextLine(line, last);
+
+            std::vector<Vec3>& output = chunks[chunk];
+            output.reserve((end - begin) / 32);
+
+            Vec3 point;
+            while (line < text + end)
+            {
+                const char* lineEnd = static_cast<const char*>(std::memchr(line, '\n', last - line));
+                if (!lineEnd) lineEnd = last;
+
+                if (parseLine(line, lineEnd, point)) output.push_back(point);
+                line = lineEnd == last ? last : lineEnd + 1;
+            }
+        });
+
+        size_t count = 0;
+        for (const std::vector<Vec3>& chunk : chunks) count += chunk.size();
+        points.clear();
+        points.reserve(count);
+        for (const std::vector<Vec3>& chunk : chunks) points.insert(points.end(), chunk.begin(), chunk.end());
+    }
+
+    ///////////////////////////////////////////////////////////
+    // ply
+
+    enum class PlyType
+    {
+        Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64, Invalid,
+    };
+
+    PlyType PlyTypeOf(std::string_view name)
+    {
+        if (name == "char" || name == "int8") return PlyType::Int8;
+        if (name == "uchar" || name == "uint8") return PlyType::UInt8;
+        if (name == "short" || name == "int16") return PlyType::Int16;
+        if (name == "ushort" || name == "uint16") return PlyType::UInt16;
+        if (name == "int" || name == "int32") return PlyType::Int32;
+        if (name == "uint" || name == "uint32") return PlyType::UInt32;
+        if (name == "float" || name == "float32") return PlyType::Float32;
+        if (name == "double" || name == "float64") return PlyType::Float64;
+        return PlyType::Invalid;
+    }
+
+    size_t SizeOf(PlyType type)
+    {
+        switch (type)
+        {
+        case PlyType::Int8: case PlyType::UInt8:      return 1;
+        case PlyType::Int16: case PlyType::UInt16:    return 2;
+        case PlyType::Float64:                        return 8;
+        default:                                      return 4;
+        }
+    }
+
+    // binary value at data, bytes reversed when swap
+    float ReadPlyValue(const unsigned char* data, PlyType type, bool swap)
+    {
+        unsigned char bytes[8];
+        size_t size = SizeOf(type);
+        for (size_t i = 0; i < size; ++i) bytes[i] = data[swap ? size - 1 - i : i];
+
+        switch (type)
+        {
+        case PlyType::Int8:    { int8_t v; std::memcpy(&v, bytes, 1); return v; }
+        case PlyType::UInt8:   { uint8_t v; std::memcpy(&v, bytes, 1); return v; }
+        case PlyType::Int16:   { int16_t v; std::memcpy(&v, bytes, 2); return v; }
+        case PlyType::UInt16:  { uint16_t v; std::memcpy(&v, bytes, 2); return v; }
+        case PlyType::Int32:   { int32_t v; std::memcpy(&v, bytes, 4); return static_cast<float>(v); }
+        case PlyType::UInt32:  { uint32_t v; std::memcpy(&v, bytes, 4); return static_cast<float>(v); }
+        case PlyType::Float32: { float v; std::memcpy(&v, bytes, 4); return v; }
+        default:               { double v; std::memcpy(&v, bytes, 8); return static_cast<float>(v); }
+        }
+    }
+
+    // binary list length at data (integer type), bytes reversed when swap
+    // return : false if negative
+    bool ReadPlyCount(const unsigned char* data, PlyType type, bool swap, size_t& count)
+    {
+        unsigned char bytes[4];
+        size_t size = SizeOf(type);
+        for (size_t i = 0; i < size; ++i) bytes[i] = data[swap ? size - 1 - i : i];
+
+        int64_t value;
+        switch (type)
+        {
+        case PlyType::Int8:    { int8_t v; std::memcpy(&v, bytes, 1); value = v; break; }
+        case PlyType::UInt8:   { uint8_t v; std::memcpy(&v, bytes, 1); value = v; break; }
+        case PlyType::Int16:   { int16_t v; std::memcpy(&v, bytes, 2); value = v; break; }
+        case PlyType::UInt16:  { uint16_t v; std::memcpy(&v, bytes, 2); value = v; break; }
+        case PlyType::Int32:   { int32_t v; std::memcpy(&v, bytes, 4); value = v; break; }
+        default:               { uint32_t v; std::memcpy(&v, bytes, 4); value = v; break; }
+        }
+        count = static_cast<size_t>(value);
+        return value >= 0;
+    }
+
+    struct PlyProperty
+    {
+        std::string name;
+        PlyType type;
+        bool isList;
+
+        // type of the list length (lists only)
+        PlyType countType;
+    };
+
+    struct PlyElement
+    {
+        std::string name;
+        size_t count;
+        std::vector<PlyProperty> properties;
+    };
+
+    enum class PlyEncoding
+    {
+        Ascii, LittleEndian, BigEndian,
+    };
+
+    struct PlyHeader
+    {
+        PlyEncoding encoding = PlyEncoding::Ascii;
+        std::vector<PlyElement> elements;
+
+        // first byte after end_header
+        size_t dataOffset = 0;
+    };
+
+    // return : false if the header is not a ply header
+    bool ParsePlyHeader(const char* text, size_t size, PlyHeader& header)
+    {
+        const char* last = text + size;
+        const char* line = text;
+        bool hasFormat = false;
+        bool first = true;
+
+        while (line < last)
+        {
+            const char* next = NextLine(line, last);
+            if (next == last && (next == line || next[-1] != '\n')) return false;
+
+            std::string_view view(line, next - line);
+            while (!view.empty() && (view.back() == '\n' || view.back() == '\r')) view.remove_suffix(1);
+            line = next;
+
+            // whitespace separated words
+            std::vector<std::string_view> words;
+            for (size_t i = 0; i < view.size();)
+            {
+                while (i < view.size() && IsBlank(view[i])) ++i;
+                size_t start = i;
+                while (i < view.size() && !IsBlank(view[i])) ++i;
+                if (i > start) words.push_back(view.substr(start, i - start));
+            }
+
+            if (first)
+            {
+                if (words.size() != 1 || words[0] != "ply") return false;
+                first = false;
+            }
+            else if (words.empty() || words[0] == "comment" || words[0] == "obj_info")
+            {
+                continue;
+            }
+            else if (words[0] == "format" && words.size() >= 2)
+            {
+                if (words[1] == "ascii") header.encoding = PlyEncoding::Ascii;
+                else if (words[1] == "binary_little_endian") header.encoding = PlyEncoding::LittleEndian;
+                else if (words[1] == "binary_big_endian") header.encoding = PlyEncoding::BigEndian;
+                else return false;
+                hasFormat = true;
+            }
+            else if (words[0] == "element" && words.size() == 3)
+            {
+                size_t count = 0;
+                auto [end, error] = std::from_chars(words[2].data(), words[2].data() + words[2].size(), count);
+                if (error != std::errc()) return false;
+                header.elements.push_back({ std::string(words[1]), count, {} });
+            }
+            else if (words[0] == "property" && !header.elements.empty())
+            {
+                PlyProperty property;
+                property.isList = words.size() == 5 && words[1] == "list";
+                if (!property.isList && words.size() != 3) return false;
+
+                property.type = PlyTypeOf(words[property.isList ? 3 : 1]);
+                if (property.type == PlyType::Invalid) return false;
+
+                property.countType = property.isList ? PlyTypeOf(words[2]) : PlyType::Invalid;
+                if (property.isList && (property.countType == PlyType::Invalid || property.countType == PlyType::Float32 || property.countType == PlyType::Float64)) return false;
+
+                property.name = std::string(words.back());
+                header.elements.back().properties.push_back(property);
+            }
+            else if (words[0] == "end_header")
+            {
+                header.dataOffset = line - text;
+                return hasFormat;
+            }
+            else return false;
+        }
+        return false;
+    }
+
+    // size of a record of element when it has no lists
+    // return : false if it has lists
+    bool FixedRecordSize(const PlyElement& element, size_t& recordSize)
+    {
+        recordSize = 0;
+        for (const PlyProperty& property : element.properties)
+        {
+            if (property.isList) return false;
+            recordSize += SizeOf(property.type);
+        }
+        return true;
+    }
+
+    // size of the binary record of element at data, list lengths read from the record, and the offset of each property in it
+    // (a list : its length) if propertyOffsets is not null
+    // return : false if the record runs past last or a list length is negative
+    bool WalkRecord(const PlyElement& element, const unsigned char* data, const unsigned char* last, bool swap, size_t& recordSize, size_t* propertyOffsets)
+    {
+        const size_t available = static_cast<size_t>(last - data);
+        recordSize = 0;
+        for (size_t i = 0; i < element.properties.size(); ++i)
+        {
+            const PlyProperty& property = element.properties[i];
+            if (propertyOffsets) propertyOffsets[i] = recordSize;
+            if (!property.isList)
+            {
+                recordSize += SizeOf(property.type);
+                continue;
+            }
+
+            size_t count;
+            size_t countSize = SizeOf(property.countType);
+            if (recordSize + countSize > available || !ReadPlyCount(data + recordSize, property.countType, swap, count)) return false;
+            recordSize += countSize + count * SizeOf(property.type);
+        }
+        return recordSize <= available;
+    }
+
+    // return : index of the property named name, or -1
+    int FindProperty(const PlyElement& element, std::string_view name)
+    {
+        for (size_t i = 0; i < element.properties.size(); ++i)
+        {
+            if (element.properties[i].name == name) return static_cast<int>(i);
+        }
+        return -1;
+    }
+}
+
+bool ParsePoint(const char* first, const char* last, Vec3& point)
+{
+    return ParseNumber(first, last, point.x) && ParseNumber(first, last, point.y) && ParseNumber(first, last, point.z);
+}
+
+PointCloudFile::Format PointCloudFile::FormatOf(const std::filesystem::path& path)
+{
+    std::filesystem::path extension = path.extension();
+    if (extension == ".ply") return Format::Ply;
+    if (extension == ".obj") return Format::Obj;
+    if (extension == ".txt" || extension == ".xyz") return Format::Text;
+    return Format::Raw;
+}
+
+PointCloudFile::PointCloudFile()
+    : file(), parsed(), points()
+{}
+
+bool PointCloudFile::Open(const std::filesystem::path& path, unsigned threadCount)
+{
+    return this->Open(path, FormatOf(path), threadCount);
+}
+
+bool PointCloudFile::Open(const std::filesystem::path& path, Format format, unsigned threadCount)
+{
+    this->Close();
+    if (!this->file.Open(path)) return false;
+
+    const char* text = reinterpret_cast<const char*>(this->file.Data());
+    const size_t size = this->file.Size();
+
+    bool succeeded = true;
+    switch (format)
+    {
+    case Format::Raw:
+        succeeded = size % sizeof(Vec3) == 0;
+        this->points = PointsView(this->file.Data(), size / sizeof(Vec3));
+        break;
+
+    case Format::Ply:
+        succeeded = this->OpenPly(threadCount);
+        break;
+
+    case Format::Obj:
+        ParseLines(text, size, threadCount, this->parsed, [](const char* first, const char* last, Vec3& point)
+        {
+            first = SkipBlanks(first, last);
+            if (last - first < 2 || first[0] != 'v' || !IsBlank(first[1])) return false;
+            return ParsePoint(first + 2, last, point);
+        });
+        this->points = this->parsed;
+        break;
+
+    case Format::Text:
+        ParseLines(text, size, threadCount, this->parsed, [](const char* first, const char* last, Vec3& point)
+        {
+            if (first == last || *first == '#') return false;
+            return ParsePoint(first, last, point);
+        });
+        this->points = this->parsed;
+        break;
+    }
+
+    if (!succeeded) this->Close();
+    return succeeded;
+}
+
+void PointCloudFile::Close()
+{
+    this->file.Close();
+    this->parsed = {};
+    this->points = {};
+}
+
+bool PointCloudFile::OpenPly(unsigned threadCount)
+{
+    const unsigned char* data = this->file.Data();
+    const size_t size = this->file.Size();
+
+    PlyHeader header;
+    if (!ParsePlyHeader(reinterpret_cast<const char*>(data), size, header)) return false;
+
+    size_t vertexElement = 0;
+    while (vertexElement < header.elements.size() && header.elements[vertexElement].name != "vertex") ++vertexElement;
+    if (vertexElement == header.elements.size()) return false;
+
+    const PlyElement& vertex = header.elements[vertexElement];
+    int axes[3] = { FindProperty(vertex, "x"), FindProperty(vertex, "y"), FindProperty(vertex, "z") };
+    for (int axis : axes)
+    {
+        if (axis < 0 || vertex.properties[axis].isList) return false;
+    }
+
+    if (header.encoding == PlyEncoding::Ascii)
+    {
+        // skip the lines of the elements before the vertices, then parse vertex.count lines
+        const char* text = reinterpret_cast<const char*>(data);
+        const char* last = text + size;
+        const char* begin = text + header.dataOffset;
+        for (size_t e = 0; e < vertexElement; ++e)
+        {
+            for (size_t i = 0; i < header.elements[e].count && begin < last; ++i) begin = NextLine(begin, last);
+        }
+        const char* end = begin;
+        for (size_t i = 0; i < vertex.count && end < last; ++i) end = NextLine(end, last);
+
+        const int maxAxis = std::max(axes[0], std::max(axes[1], axes[2]));
+        ParseLines(begin, end - begin, threadCount, this->parsed, [&](const char* first, const char* lineLast, Vec3& point)
+        {
+            float values[3] = {};
+            for (int property = 0; property <= maxAxis; ++property)
+            {
+                float value;
+                if (!ParseNumber(first, lineLast, value)) return false;
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    if (axes[axis] == property) values[axis] = value;
+                }
+            }
+            point = { values[0], values[1], values[2] };
+            return true;
+        });
+        this->points = this->parsed;
+        return this->parsed.size() == vertex.count;
+    }
+
+    // binary : offset of the vertex block, elements without lists are skipped whole, the others record by record
+    bool native = (header.encoding == PlyEncoding::LittleEndian) == (std::endian::native == std::endian::little);
+    size_t offset = header.dataOffset;
+    for (size_t e = 0; e < vertexElement; ++e)
+    {
+        const PlyElement& element = header.elements[e];
+        size_t recordSize;
+        if (FixedRecordSize(element, recordSize))
+        {
+            if (recordSize != 0 && element.count > (size - offset) / recordSize) return false;
+            offset += element.count * recordSize;
+            continue;
+        }
+        for (size_t i = 0; i < element.count; ++i)
+        {
+            if (!WalkRecord(element, data + offset, data + size, !native, recordSize, nullptr)) return false;
+            offset += recordSize;
+        }
+    }
+
+    // lists in the vertex records : the axes move from record to record, so they are read while walking
+    size_t recordSize;
+    if (!FixedRecordSize(vertex, recordSize))
+    {
+        std::vector<size_t> propertyOffsets(vertex.properties.size());
+        this->parsed.resize(vertex.count);
+        for (size_t i = 0; i < vertex.count; ++i)
+        {
+            if (!WalkRecord(vertex, data + offset, data + size, !native, recordSize, propertyOffsets.data())) return false;
+
+            float values[3];
+            for (int axis = 0; axis < 3; ++axis) values[axis] = ReadPlyValue(data + offset + propertyOffsets[axes[axis]], vertex.properties[axes[axis]].type, !native);
+            this->parsed[i] = { values[0], values[1], values[2] };
+            offset += recordSize;
+        }
+        this->points = this->parsed;
+        return true;
+    }
+
+    size_t stride = 0;
+    size_t axisOffsets[3] = {};
+    for (size_t i = 0; i < vertex.properties.size(); ++i)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            if (axes[axis] == static_cast<int>(i)) axisOffsets[axis] = stride;
+        }
+        stride += SizeOf(vertex.properties[i].type);
+    }
+    if (offset > size || vertex.count > (size - offset) / stride) return false;
+
+    // float x, y, z next to each other in the byte order of this machine : used in place
+    bool packed = axisOffsets[1] == axisOffsets[0] + 4 && axisOffsets[2] == axisOffsets[0] + 8;
+    bool floats = vertex.properties[axes[0]].type == PlyType::Float32 && vertex.properties[axes[1]].type == PlyType::Float32 && vertex.properties[axes[2]].type == PlyType::Float32;
+    if (native && packed && floats)
+    {
+        this->points = PointsView(data + offset, vertex.count, stride, axisOffsets[0]);
+        return true;
+    }
+
+    this->parsed.resize(vertex.count);
+    const size_t chunkCount = ChunkCount(vertex.count, ResolveThreadCount(threadCount), MIN_PARALLEL_BYTES / 16);
+    ParallelChunks(vertex.count, chunkCount, [&](size_t, size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const unsigned char* element = data + offset + i * stride;
+            float values[3];
+            for (int axis = 0; axis < 3; ++axis) values[axis] = ReadPlyValue(element + axisOffsets[axis], vertex.properties[axes[axis]].type, !native);
+            this->parsed[i] = { values[0], values[1], values[2] };
+        }
+    });
+    this->points = this->parsed;
+    return true;
+}
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+#include "MappedFile.hpp"
+#include "PointsView.hpp"
+#include "Vec3.hpp"
+
+namespace hull
+{
+	// return : true if text starts with 3 numbers (leading blanks are skipped), they are stored in point
+	bool ParsePoint(const char* first, const char* last, Vec3& point);
+
+	// point cloud file, memory mapped
+	//
+	// raw float3 files and binary ply files with float x, y, z next to each other are used in place (no copy),
+	// other ply layouts are converted, text formats are parsed by line chunks on worker threads.
+	class PointCloudFile
+	{
+	public:
+		enum class Format
+		{
+			// little endian float x, y, z triples, no header
+			Raw,
+
+			// ply, ascii or binary, positions from the x, y, z properties of the vertex element
+			Ply,
+
+			// wavefront obj, positions from the "v x y z" lines
+			Obj,
+
+			// one "x y z" per line, '#' starts a comment line
+			Text,
+		};
+
+		// format from the extension : .ply, .obj, .txt / .xyz, anything else raw
+		static Format FormatOf(const std::filesystem::path& path);
+
+		PointCloudFile();
+
+		// threadCount : parser threads for the text formats (0 : one per hardware thread)
+		// return : false if the file can not be mapped or is malformed
+		bool Open(const std::filesystem::path& path, unsigned threadCount = 1);
+		bool Open(const std::filesystem::path& path, Format format, unsigned threadCount = 1);
+		void Close();
+
+		// positions, valid until Close (into the mapping when IsInPlace)
+		const PointsView& Points() const { return this->points; }
+
+		// positions are read from the mapping without a copy
+		bool IsInPlace() const { return this->points.data != nullptr && this->points.data != this->parsed.data(); }
+
+	private:
+		bool OpenPly(unsigned threadCount);
+
+		MappedFile file;
+		std::vector<Vec3> parsed;
+		PointsView points;
+	};
+}
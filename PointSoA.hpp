@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "PointsView.hpp"
+#include "Vec3.hpp"
+
+namespace hull
+{
+	// structure-of-arrays point storage for the batch kernels
+	struct PointSoA
+	{
+		std::vector<float> x, y, z;
+
+		// input point index of each entry
+		std::vector<uint32_t> index;
+
+		size_t Size() const { return this->x.size(); }
+		bool Empty() const { return this->x.empty(); }
+
+		void Clear()
+		{
+			this->x.clear();
+			this->y.clear();
+			this->z.clear();
+			this->index.clear();
+		}
+
+		void Reserve(size_t count)
+		{
+			this->x.reserve(count);
+			this->y.reserve(count);
+			this->z.reserve(count);
+			this->index.reserve(count);
+		}
+
+		void PushBack(const Vec3& point, uint32_t pointIndex)
+		{
+			this->x.push_back(point.x);
+			this->y.push_back(point.y);
+			this->z.push_back(point.z);
+			this->index.push_back(pointIndex);
+		}
+
+		void Resize(size_t count)
+		{
+			this->x.resize(count);
+			this->y.resize(count);
+			this->z.resize(count);
+			this->index.resize(count);
+		}
+
+		Vec3 Get(size_t i) const { return { this->x[i], this->y[i], this->z[i] }; }
+
+		// points[begin, begin + count)
+		void AssignRange(const PointsView& view, size_t begin, size_t count)
+		{
+			this->Resize(count);
+			view.Dispatch([&](const auto& points)
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					Vec3 point = points[begin + i];
+					this->x[i] = point.x;
+					this->y[i] = point.y;
+					this->z[i] = point.z;
+					this->index[i] = static_cast<uint32_t>(begin + i);
+				}
+			});
+		}
+
+		// points[indices[0 .. count)]
+		void AssignGather(const PointsView& view, const uint32_t* indices, size_t count)
+		{
+			this->Resize(count);
+			view.Dispatch([&](const auto& points)
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					Vec3 point = points[indices[i]];
+					this->x[i] = point.x;
+					this->y[i] = point.y;
+					this->z[i] = point.z;
+					this->index[i] = indices[i];
+				}
+			});
+		}
+	};
+}
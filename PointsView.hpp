@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "Vec3.hpp"
+
+namespace hull
+{
+	// positions read in place : count x, y, z float triples, point i at data + offset + i * stride
+	// (e.g. a vertex buffer : stride = vertex size, offset = position offset inside the vertex)
+	// the memory must stay alive and unchanged while the view is used.
+	struct PointsView
+	{
+		const void* data = nullptr;
+		size_t count = 0;
+		size_t stride = sizeof(Vec3);
+		size_t offset = 0;
+
+		PointsView() = default;
+
+		PointsView(const void* data_, size_t count_, size_t stride_ = sizeof(Vec3), size_t offset_ = 0)
+			: data(data_), count(count_), stride(stride_), offset(offset_)
+		{}
+
+		PointsView(const std::vector<Vec3>& points)
+			: data(points.data()), count(points.size()), stride(sizeof(Vec3)), offset(0)
+		{}
+
+		// unaligned positions are fine, they are copied out
+		Vec3 operator[](size_t i) const
+		{
+			Vec3 point;
+			std::memcpy(&point, static_cast<const unsigned char*>(this->data) + this->offset + i * this->stride, sizeof(Vec3));
+			return point;
+		}
+
+		bool Empty() const { return this->count == 0; }
+
+		// tightly packed, float aligned Vec3 array
+		bool IsPacked() const
+		{
+			return this->stride == sizeof(Vec3) && (reinterpret_cast<uintptr_t>(this->data) + this->offset) % alignof(Vec3) == 0;
+		}
+
+		// return : function(points) with points a const Vec3* if packed (loops the compiler can vectorize), otherwise this view.
+		// both are indexed the same : points[i]
+		template <typename Function>
+		decltype(auto) Dispatch(Function&& function) const
+		{
+			if (this->IsPacked()) return function(reinterpret_cast<const Vec3*>(static_cast<const unsigned char*>(this->data) + this->offset));
+			return function(*this);
+		}
+
+		void CopyTo(std::vector<Vec3>& points) const
+		{
+			points.resize(this->count);
+			if (this->stride == sizeof(Vec3))
+			{
+				if (this->count > 0) std::memcpy(points.data(), static_cast<const unsigned char*>(this->data) + this->offset, this->count * sizeof(Vec3));
+				return;
+			}
+			for (size_t i = 0; i < this->count; ++i) points[i] = (*this)[i];
+		}
+	};
+}
@@ -0,0 +1,258 @@
+#include "PolygonHull.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <numeric>
+#include <unordered_map>
+
+#include "HalfEdgeMesh.hpp"
+
+namespace hull
+{
+
+namespace
+{
+    constexpr uint32_t NONE = ~0u;
+
+    // distance below which a corner counts as lying on a plane (same as the build)
+    float PlaneTolerance(const std::vector<Vec3>& vertices)
+    {
+        Vec3 maxAbs = {};
+        for (const Vec3& v : vertices)
+        {
+            maxAbs = { std::max(maxAbs.x, std::abs(v.x)), std::max(maxAbs.y, std::abs(v.y)), std::max(maxAbs.z, std::abs(v.z)) };
+        }
+        return hull::PlaneTolerance(maxAbs);
+    }
+
+    // signed turn at corner b of the boundary a -> b -> c, in distance units (< 0 : reflex)
+    float Turn(const Vec3& a, const Vec3& b, const Vec3& c, const Vec3& normal)
+    {
+        Vec3 ab = b - a;
+        float length = Length(ab);
+        return length > 0 ? Dot(Cross(ab, c - b), normal) / length : 0.0f;
+    }
+
+    // groups the faces of a closed hull into convex polygons
+    class FaceMerger
+    {
+    public:
+        FaceMerger(const Hull& hull_, const std::vector<uint32_t>& twins_, float distanceTolerance_, float minCos_)
+            : hull(hull_), twins(twins_), distanceTolerance(distanceTolerance_), minCos(minCos_),
+              facePlanes(hull_.FaceCount()), facePolygon(hull_.FaceCount(), NONE), region(hull_.FaceCount(), NONE), cornerOf(hull_.vertices.size(), NONE)
+        {
+            for (size_t face = 0; face < this->facePlanes.size(); ++face) this->facePlanes[face] = hull_.FacePlane(face);
+        }
+
+        bool IsMerged(uint32_t face) const
+        {
+            return this->facePolygon[face] != NONE;
+        }
+
+        // merge free faces around seed into polygon, its boundary half-edges are written to loop in winding order
+        // return : plane of the polygon (normal of seed, through the outermost corner of its faces)
+        Plane Merge(uint32_t seed, uint32_t polygon, std::vector<uint32_t>& loop)
+        {
+            this->GrowRegion(seed, polygon);
+            if (!this->TraceRegion(polygon, loop))
+            {
+                // the region is not a single convex loop : release it and grow a convex part of it face by face
+                for (uint32_t face : this->regionFaces) this->facePolygon[face] = NONE;
+                this->GrowConvex(seed, polygon, loop);
+            }
+
+            Plane plane = { this->facePlanes[seed].normal, -FLT_MAX };
+            for (uint32_t face : this->regionFaces)
+            {
+                if (this->facePolygon[face] != polygon) continue;
+                for (int i = 0; i < 3; ++i) plane.offset = std::max(plane.offset, Dot(plane.normal, this->Corner(face * 3 + i)));
+            }
+            return plane;
+        }
+
+    private:
+        // return : true if face can join the polygon of seed
+        bool Accepts(uint32_t face, uint32_t seed) const
+        {
+            if (Dot(this->facePlanes[face].normal, this->facePlanes[seed].normal) < this->minCos) return false;
+            for (int i = 0; i < 3; ++i)
+            {
+                if (std::abs(this->facePlanes[seed].Distance(this->Corner(face * 3 + i))) > this->distanceTolerance) return false;
+            }
+            return true;
+        }
+
+        const Vec3& Corner(uint32_t edge) const
+        {
+            return this->hull.vertices[this->hull.indices[edge]];
+        }
+
+        // flood the free faces accepted by seed, they are assigned to polygon
+        void GrowRegion(uint32_t seed, uint32_t polygon)
+        {
+            this->regionFaces = { seed };
+            this->facePolygon[seed] = polygon;
+            this->region[seed] = polygon;
+            for (size_t next = 0; next < this->regionFaces.size(); ++next)
+            {
+                uint32_t face = this->regionFaces[next];
+                for (uint32_t edge = face * 3; edge < face * 3 + 3; ++edge)
+                {
+                    uint32_t neighbour = this->twins[edge] / 3;
+                    if (this->facePolygon[neighbour] != NONE || !this->Accepts(neighbour, seed)) continue;
+                    this->facePolygon[neighbour] = polygon;
+                    this->region[neighbour] = polygon;
+                    this->regionFaces.push_back(neighbour);
+                }
+            }
+        }
+
+        // walk the boundary of the region of polygon
+        // return : false unless it is one convex loop (a region touching itself at a corner is not)
+        bool TraceRegion(uint32_t polygon, std::vector<uint32_t>& loop)
+        {
+            loop.clear();
+
+            // boundary edge leaving each corner
+            this->outgoing.clear();
+            size_t edgeCount = 0;
+            for (uint32_t face : this->regionFaces)
+            {
+                for (uint32_t edge = face * 3; edge < face * 3 + 3; ++edge)
+                {
+                    if (this->facePolygon[this->twins[edge] / 3] == polygon) continue;
+                    if (!this->outgoing.emplace(this->hull.indices[edge], edge).second) return false;
+                    ++edgeCount;
+                }
+            }
+
+            if (edgeCount == 0) return false;
+
+            uint32_t first = this->outgoing.begin()->second;
+            uint32_t edge = first;
+            do
+            {
+                loop.push_back(edge);
+                auto it = this->outgoing.find(this->hull.indices[HalfEdgeMesh::Next(edge)]);
+                if (it == this->outgoing.end()) return false;
+                edge = it->second;
+            } while (edge != first && loop.size() <= edgeCount);
+            if (loop.size() != edgeCount) return false;
+
+            const Vec3& normal = this->facePlanes[this->regionFaces[0]].normal;
+            for (size_t i = 0; i < loop.size(); ++i)
+            {
+                const Vec3& before = this->Corner(loop[i == 0 ? loop.size() - 1 : i - 1]);
+                const Vec3& after = this->Corner(loop[i + 1 == loop.size() ? 0 : i + 1]);
+                if (Turn(before, this->Corner(loop[i]), after, normal) < -this->distanceTolerance) return false;
+            }
+            return true;
+        }
+
+        // grow from seed across its boundary, one accepted face of the released region at a time, while the polygon stays convex
+        void GrowConvex(uint32_t seed, uint32_t polygon, std::vector<uint32_t>& loop)
+        {
+            const std::vector<uint32_t>& indices = this->hull.indices;
+            const Vec3& normal = this->facePlanes[seed].normal;
+
+            this->facePolygon[seed] = polygon;
+            loop = { seed * 3, seed * 3 + 1, seed * 3 + 2 };
+            for (uint32_t edge : loop) this->cornerOf[indices[edge]] = polygon;
+
+            // until a full pass adds no face
+            for (bool grown = true; grown;)
+            {
+                grown = false;
+                for (size_t i = 0; i < loop.size(); ++i)
+                {
+                    uint32_t twin = this->twins[loop[i]];
+                    uint32_t face = twin / 3;
+                    if (this->region[face] != polygon || this->facePolygon[face] != NONE) continue;
+
+                    // face across a -> b is b -> a -> c : the boundary becomes a -> c -> b
+                    uint32_t toApex = HalfEdgeMesh::Next(twin);
+                    uint32_t fromApex = HalfEdgeMesh::Next(toApex);
+                    if (this->cornerOf[indices[fromApex]] == polygon) continue;
+
+                    const Vec3& before = this->Corner(loop[i == 0 ? loop.size() - 1 : i - 1]);
+                    const Vec3& after = this->Corner(HalfEdgeMesh::Next(loop[i + 1 == loop.size() ? 0 : i + 1]));
+                    const Vec3& apex = this->Corner(fromApex);
+                    if (Turn(before, this->Corner(loop[i]), apex, normal) < -this->distanceTolerance) continue;
+                    if (Turn(apex, this->Corner(twin), after, normal) < -this->distanceTolerance) continue;
+
+                    this->facePolygon[face] = polygon;
+                    this->cornerOf[indices[fromApex]] = polygon;
+                    loop[i] = toApex;
+                    loop.insert(loop.begin() + i + 1, fromApex);
+                    grown = true;
+                }
+            }
+        }
+
+        const Hull& hull;
+        const std::vector<uint32_t>& twins;
+        float distanceTolerance;
+        float minCos;
+
+        std::vector<Plane> facePlanes;
+
+        // polygon of each face (NONE : free)
+        std::vector<uint32_t> facePolygon;
+
+        // last region each face was flooded into
+        std::vector<uint32_t> region;
+
+        // last polygon each vertex was a corner of while growing convex (corners never leave the growing polygon)
+        std::vector<uint32_t> cornerOf;
+
+        // scratch of the current region
+        std::vector<uint32_t> regionFaces;
+        std::unordered_map<uint32_t, uint32_t> outgoing;
+    };
+}
+
+bool MergeCoplanarFaces(const Hull& hull, float distanceTolerance, float angleTolerance, PolygonHull& polygons)
+{
+    polygons.Clear();
+
+    std::vector<uint32_t> twins;
+    if (!BuildTwins(hull, twins)) return false;
+
+    const std::vector<Vec3>& vertices = hull.vertices;
+    const std::vector<uint32_t>& indices = hull.indices;
+    size_t faceCount = hull.FaceCount();
+
+    distanceTolerance = std::max(distanceTolerance, PlaneTolerance(vertices));
+    float minCos = std::cos(std::clamp(angleTolerance, 0.0f, 3.14159265f));
+
+    // seeds : largest face first, so a polygon takes the normal of its best conditioned face
+    std::vector<float> areas(faceCount);
+    for (size_t face = 0; face < faceCount; ++face)
+    {
+        const Vec3& a = vertices[indices[face * 3]];
+        areas[face] = Length(Cross(vertices[indices[face * 3 + 1]] - a, vertices[indices[face * 3 + 2]] - a));
+    }
+    std::vector<uint32_t> seeds(faceCount);
+    std::iota(seeds.begin(), seeds.end(), 0u);
+    std::stable_sort(seeds.begin(), seeds.end(), [&](uint32_t a, uint32_t b) { return areas[a] > areas[b]; });
+
+    polygons.vertices = vertices;
+    polygons.polygonStarts.push_back(0);
+
+    FaceMerger merger(hull, twins, distanceTolerance, minCos);
+    std::vector<uint32_t> loop;
+    for (uint32_t seed : seeds)
+    {
+        if (merger.IsMerged(seed)) continue;
+
+        uint32_t polygon = static_cast<uint32_t>(polygons.planes.size());
+        polygons.planes.push_back(merger.Merge(seed, polygon, loop));
+        for (uint32_t edge : loop) polygons.polygonIndices.push_back(indices[edge]);
+        polygons.polygonStarts.push_back(static_cast<uint32_t>(polygons.polygonIndices.size()));
+    }
+
+    return true;
+}
+
+}
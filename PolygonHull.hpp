@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "HullCore.hpp"
+#include "Vec3.hpp"
+
+namespace hull
+{
+	// convex hull as convex polygons, one plane per polygon
+	struct PolygonHull
+	{
+		// hull vertices (same order as Hull::vertices)
+		std::vector<Vec3> vertices;
+
+		// corners of polygon p : polygonIndices[polygonStarts[p] .. polygonStarts[p + 1]), same winding as the hull faces
+		std::vector<uint32_t> polygonStarts;
+		std::vector<uint32_t> polygonIndices;
+
+		// outward plane of each polygon, no corner is in front of it
+		std::vector<Plane> planes;
+
+		size_t PolygonCount() const { return this->planes.size(); }
+
+		size_t CornerCount(size_t polygon) const { return this->polygonStarts[polygon + 1] - this->polygonStarts[polygon]; }
+
+		void Clear()
+		{
+			this->vertices.clear();
+			this->polygonStarts.clear();
+			this->polygonIndices.clear();
+			this->planes.clear();
+		}
+	};
+
+	// merge adjacent hull faces into convex polygons
+	// faces are grown from the largest one : a neighbour joins when its normal is within angleTolerance (radians) of the polygon normal,
+	// its third corner is within distanceTolerance of the polygon plane and the polygon stays convex (within distanceTolerance).
+	// distanceTolerance is raised to the build's plane tolerance, so 0 merges coplanar faces only.
+	// the polygon plane has the normal of the first face and passes through the outermost corner.
+	// return : false if the hull is not a closed triangle mesh (polygons is left empty)
+	bool MergeCoplanarFaces(const Hull& hull, float distanceTolerance, float angleTolerance, PolygonHull& polygons);
+}
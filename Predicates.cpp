@@ -0,0 +1,182 @@
+#include "Predicates.hpp"
+
+#include <atomic>
+#include <cmath>
+
+namespace hull
+{
+
+namespace
+{
+    // expansion arithmetic after Shewchuk, "Adaptive Precision Floating-Point Arithmetic and Fast Robust Geometric Predicates".
+    // needs round-to-nearest double arithmetic without fma contraction (the library is built with -ffp-contract=off).
+
+    // half ulp of 1.0
+    constexpr double EPSILON = 1.0 / 9007199254740992.0;
+
+    // 2^27 + 1 : splits a double into two 26 bit halves
+    constexpr double SPLITTER = 134217729.0;
+
+    // forward error bound of the double determinant (orient3d errboundA)
+    constexpr double ORIENT3D_BOUND = (7.0 + 56.0 * EPSILON) * EPSILON;
+
+    std::atomic<unsigned long long> exactCount = 0;
+
+    // x + y == a + b exactly, |y| <= ulp(x) / 2
+    inline void TwoSum(double a, double b, double& x, double& y)
+    {
+        x = a + b;
+        double bVirtual = x - a;
+        double aVirtual = x - bVirtual;
+        y = (a - aVirtual) + (b - bVirtual);
+    }
+
+    inline void TwoDiff(double a, double b, double& x, double& y)
+    {
+        x = a - b;
+        double bVirtual = a - x;
+        double aVirtual = x + bVirtual;
+        y = (a - aVirtual) + (bVirtual - b);
+    }
+
+    inline void Split(double a, double& high, double& low)
+    {
+        double c = SPLITTER * a;
+        double big = c - a;
+        high = c - big;
+        low = a - high;
+    }
+
+    // x + y == a * b exactly
+    inline void TwoProduct(double a, double b, double& x, double& y)
+    {
+        x = a * b;
+        double aHigh, aLow, bHigh, bLow;
+        Split(a, aHigh, aLow);
+        Split(b, bHigh, bLow);
+        double err1 = x - (aHigh * bHigh);
+        double err2 = err1 - (aLow * bHigh);
+        double err3 = err2 - (aHigh * bLow);
+        y = (aLow * bLow) - err3;
+    }
+
+    // nonoverlapping terms in increasing magnitude, zeros eliminated (a zero value keeps one 0 term)
+    // 192 terms : upper bound of the orient3d determinant (3 x 2 x (8 + 8) x 2)
+    struct Expansion
+    {
+        int length;
+        double terms[192];
+    };
+
+    Expansion Difference(double a, double b)
+    {
+        Expansion e;
+        double x, y;
+        TwoDiff(a, b, x, y);
+        e.length = 0;
+        if (y != 0) e.terms[e.length++] = y;
+        e.terms[e.length++] = x;
+        return e;
+    }
+
+    // h = e + b
+    void Grow(Expansion& e, double b)
+    {
+        double q = b;
+        int length = 0;
+        for (int i = 0; i < e.length; ++i)
+        {
+            double sum, error;
+            TwoSum(q, e.terms[i], sum, error);
+            q = sum;
+            if (error != 0) e.terms[length++] = error;
+        }
+        if (q != 0 || length == 0) e.terms[length++] = q;
+        e.length = length;
+    }
+
+    Expansion Sum(const Expansion& e, const Expansion& f)
+    {
+        Expansion h = e;
+        for (int i = 0; i < f.length; ++i) Grow(h, f.terms[i]);
+        return h;
+    }
+
+    Expansion Negate(const Expansion& e)
+    {
+        Expansion h = e;
+        for (int i = 0; i < h.length; ++i) h.terms[i] = -h.terms[i];
+        return h;
+    }
+
+    Expansion Product(const Expansion& e, const Expansion& f)
+    {
+        Expansion h;
+        h.length = 1;
+        h.terms[0] = 0;
+        for (int j = 0; j < f.length; ++j)
+        {
+            for (int i = 0; i < e.length; ++i)
+            {
+                double x, y;
+                TwoProduct(e.terms[i], f.terms[j], x, y);
+                Grow(h, y);
+                Grow(h, x);
+            }
+        }
+        return h;
+    }
+
+    // the largest term decides the sign
+    int Sign(const Expansion& e)
+    {
+        double top = e.terms[e.length - 1];
+        return top > 0 ? 1 : (top < 0 ? -1 : 0);
+    }
+
+    int Orient3DExact(const Vec3& a, const Vec3& b, const Vec3& c, const Vec3& d)
+    {
+        Expansion adx = Difference(a.x, d.x), ady = Difference(a.y, d.y), adz = Difference(a.z, d.z);
+        Expansion bdx = Difference(b.x, d.x), bdy = Difference(b.y, d.y), bdz = Difference(b.z, d.z);
+        Expansion cdx = Difference(c.x, d.x), cdy = Difference(c.y, d.y), cdz = Difference(c.z, d.z);
+
+        Expansion minorA = Sum(Product(bdx, cdy), Negate(Product(cdx, bdy)));
+        Expansion minorB = Sum(Product(cdx, ady), Negate(Product(adx, cdy)));
+        Expansion minorC = Sum(Product(adx, bdy), Negate(Product(bdx, ady)));
+
+        Expansion det = Sum(Sum(Product(adz, minorA), Product(bdz, minorB)), Product(cdz, minorC));
+        return Sign(det);
+    }
+}
+
+int Orient3D(const Vec3& a, const Vec3& b, const Vec3& c, const Vec3& d)
+{
+    double adx = double(a.x) - d.x, ady = double(a.y) - d.y, adz = double(a.z) - d.z;
+    double bdx = double(b.x) - d.x, bdy = double(b.y) - d.y, bdz = double(b.z) - d.z;
+    double cdx = double(c.x) - d.x, cdy = double(c.y) - d.y, cdz = double(c.z) - d.z;
+
+    double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    double cdxady = cdx * ady, adxcdy = adx * cdy;
+    double adxbdy = adx * bdy, bdxady = bdx * ady;
+
+    double det = adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) + cdz * (adxbdy - bdxady);
+
+    double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * std::abs(adz)
+        + (std::abs(cdxady) + std::abs(adxcdy)) * std::abs(bdz)
+        + (std::abs(adxbdy) + std::abs(bdxady)) * std::abs(cdz);
+
+    // fast path
+    double bound = ORIENT3D_BOUND * permanent;
+    if (det > bound) return 1;
+    if (-det > bound) return -1;
+
+    exactCount.fetch_add(1, std::memory_order_relaxed);
+    return Orient3DExact(a, b, c, d);
+}
+
+unsigned long long ExactOrient3DCount()
+{
+    return exactCount.load(std::memory_order_relaxed);
+}
+
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Vec3.hpp"
+
+namespace hull
+{
+	// sign of the orientation determinant | a-d ; b-d ; c-d | (Shewchuk's orient3d)
+	// > 0 : d is below the plane of a, b, c (a, b, c counterclockwise seen from above), < 0 : above, 0 : coplanar
+	// exact for any finite input : double evaluation with a forward error bound, expansion arithmetic when the bound fails
+	int Orient3D(const Vec3& a, const Vec3& b, const Vec3& c, const Vec3& d);
+
+	// return : > 0 if p is strictly outside face (a, b, c) (the side of Plane::FromTriangle(a, b, c).normal), 0 if coplanar, < 0 inside
+	inline int SideOfFace(const Vec3& a, const Vec3& b, const Vec3& c, const Vec3& p)
+	{
+		return -Orient3D(a, b, c, p);
+	}
+
+	// number of Orient3D calls that needed the exact path (for statistics)
+	unsigned long long ExactOrient3DCount();
+}
@@ -0,0 +1,200 @@
+#include "Prefilter.hpp"
+
+#include "HullCore.hpp"
+#include "Parallel.hpp"
+#include "PlaneKernels.hpp"
+#include "PointSoA.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <numbers>
+
+namespace hull
+{
+
+namespace
+{
+    // point index + distance along one direction
+    struct Extreme
+    {
+        uint32_t index;
+        float distance;
+    };
+
+    // return : furthest point along each direction in [begin, end) (first index wins ties)
+    std::vector<Extreme> FindExtremes(const PointsView& points, const std::vector<Vec3>& directions, size_t begin, size_t end)
+    {
+        std::vector<Extreme> extremes(directions.size(), { 0, -FLT_MAX });
+
+        PointSoA block;
+        for (size_t blockBegin = begin; blockBegin < end; blockBegin += BLOCK_SIZE)
+        {
+            block.AssignRange(points, blockBegin, std::min(BLOCK_SIZE, end - blockBegin));
+
+            for (size_t d = 0; d < directions.size(); ++d)
+            {
+                float distance;
+                size_t i = ArgMaxDistance({ directions[d], 0 }, block.x.data(), block.y.data(), block.z.data(), block.Size(), &distance);
+                if (distance > extremes[d].distance)
+                {
+                    extremes[d] = { block.index[i], distance };
+                }
+            }
+        }
+        return extremes;
+    }
+
+    // polytope faces + a ball inside it (cheap first test, most interior points never reach the planes)
+    struct Polytope
+    {
+        std::vector<Plane> planes;
+        Vec3 center;
+        float innerRadiusSq;
+    };
+
+    // append the points of [begin, end) that are not more than tolerance inside every plane
+    void CollectKept(const PointsView& points, const Polytope& polytope, float tolerance, size_t begin, size_t end, std::vector<uint32_t>& kept)
+    {
+        PointSoA block;
+        uint32_t aboveIndices[BLOCK_SIZE + PARTITION_PADDING];
+        float aboveDistances[BLOCK_SIZE + PARTITION_PADDING];
+        uint8_t keep[BLOCK_SIZE];
+
+        for (size_t blockBegin = begin; blockBegin < end; blockBegin += BLOCK_SIZE)
+        {
+            size_t blockCount = std::min(BLOCK_SIZE, end - blockBegin);
+            block.AssignRange(points, blockBegin, blockCount);
+            std::fill_n(keep, blockCount, uint8_t(0));
+
+            float* x = block.x.data();
+            float* y = block.y.data();
+            float* z = block.z.data();
+            uint32_t* index = block.index.data();
+
+            // points inside the ball are culled, the rest are compacted as candidates
+            size_t count = 0;
+            for (size_t i = 0; i < blockCount; ++i)
+            {
+                Vec3 d = Vec3{ x[i], y[i], z[i] } - polytope.center;
+                if (LengthSq(d) < polytope.innerRadiusSq) continue;
+
+                x[count] = x[i];
+                y[count] = y[i];
+                z[count] = z[i];
+                index[count] = index[i];
+                ++count;
+            }
+
+            // candidates outside (or on) a plane are kept, the rest goes on to the next plane
+            for (const Plane& plane : polytope.planes)
+            {
+                if (count == 0) break;
+                size_t above = PartitionAbove(plane, -tolerance, x, y, z, index, count, aboveIndices, aboveDistances, &count);
+                for (size_t j = 0; j < above; ++j) keep[aboveIndices[j] - blockBegin] = 1;
+            }
+
+            for (size_t i = 0; i < blockCount; ++i)
+            {
+                if (keep[i]) kept.push_back(static_cast<uint32_t>(blockBegin + i));
+            }
+        }
+    }
+}
+
+std::vector<Vec3> ExtremeDirections(unsigned count)
+{
+    std::vector<Vec3> directions;
+    directions.reserve(count);
+
+    // lattice directions ordered by number of non-zero components : axes, edge diagonals, corner diagonals
+    for (int nonZero = 1; nonZero <= 3; ++nonZero)
+    {
+        for (int x = -1; x <= 1; ++x)
+        {
+            for (int y = -1; y <= 1; ++y)
+            {
+                for (int z = -1; z <= 1; ++z)
+                {
+                    if ((x != 0) + (y != 0) + (z != 0) != nonZero) continue;
+                    if (directions.size() < count) directions.push_back(Normalize({ float(x), float(y), float(z) }));
+                }
+            }
+        }
+    }
+
+    // spherical fibonacci set for the rest
+    const unsigned extra = count > directions.size() ? count - static_cast<unsigned>(directions.size()) : 0;
+    const double goldenAngle = std::numbers::pi * (3 - std::sqrt(5.0));
+    for (unsigned i = 0; i < extra; ++i)
+    {
+        double z = 1 - (2 * i + 1) / double(2 * extra);
+        double r = std::sqrt(1 - z * z);
+        double phi = goldenAngle * i;
+        directions.push_back(Normalize({ float(r * std::cos(phi)), float(r * std::sin(phi)), float(z) }));
+    }
+
+    return directions;
+}
+
+bool CullInteriorPoints(const PointsView& points, unsigned directionCount, float tolerance, unsigned workerCount, std::vector<uint32_t>& keptIndices)
+{
+    keptIndices.clear();
+    if (points.Empty() || directionCount < 4) return false;
+
+    const size_t chunkCount = ChunkCount(points.count, workerCount, MIN_PARALLEL_POINTS);
+
+    // extreme points along each direction
+    std::vector<Vec3> directions = ExtremeDirections(directionCount);
+    std::vector<Extreme> extremes = ParallelReduce<std::vector<Extreme>>(points.count, chunkCount,
+        [&](size_t begin, size_t end) { return FindExtremes(points, directions, begin, end); },
+        [](std::vector<Extreme>& result, const std::vector<Extreme>& partial)
+        {
+            for (size_t d = 0; d < result.size(); ++d)
+            {
+                if (partial[d].distance > result[d].distance) result[d] = partial[d];
+            }
+        });
+
+    std::vector<uint32_t> extremeIndices;
+    for (const Extreme& extreme : extremes) extremeIndices.push_back(extreme.index);
+    std::sort(extremeIndices.begin(), extremeIndices.end());
+    extremeIndices.erase(std::unique(extremeIndices.begin(), extremeIndices.end()), extremeIndices.end());
+
+    // polytope spanned by the extreme points
+    std::vector<Vec3> extremePoints;
+    for (uint32_t index : extremeIndices) extremePoints.push_back(points[index]);
+
+    Hull polytope;
+    if (!CreateConvexHull(extremePoints, polytope)) return false;
+
+    Polytope inner;
+    inner.planes.resize(polytope.FaceCount());
+    for (size_t face = 0; face < inner.planes.size(); ++face) inner.planes[face] = polytope.FacePlane(face);
+
+    // ball around the vertex centroid touching the nearest face, shrunk by the tolerance
+    inner.center = { 0, 0, 0 };
+    for (const Vec3& vertex : polytope.vertices) inner.center += vertex;
+    inner.center = inner.center / static_cast<float>(polytope.vertices.size());
+
+    float innerRadius = FLT_MAX;
+    for (const Plane& plane : inner.planes) innerRadius = std::min(innerRadius, -plane.Distance(inner.center));
+    innerRadius = innerRadius * (1 - 1e-4f) - tolerance;
+    inner.innerRadiusSq = innerRadius > 0 ? innerRadius * innerRadius : 0;
+
+    // cull points inside every face, chunks are concatenated in order
+    std::vector<std::vector<uint32_t>> kept(chunkCount);
+    ParallelChunks(points.count, chunkCount, [&](size_t chunk, size_t begin, size_t end)
+    {
+        CollectKept(points, inner, tolerance, begin, end, kept[chunk]);
+    });
+
+    size_t keptCount = 0;
+    for (const std::vector<uint32_t>& chunk : kept) keptCount += chunk.size();
+    keptIndices.reserve(keptCount);
+    for (const std::vector<uint32_t>& chunk : kept) keptIndices.insert(keptIndices.end(), chunk.begin(), chunk.end());
+
+    return true;
+}
+
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "PointsView.hpp"
+#include "Vec3.hpp"
+
+namespace hull
+{
+	// unit directions for the extreme point search :
+	// the 26 lattice directions (axes, edge diagonals, corner diagonals) first, then a spherical fibonacci set for counts above 26
+	std::vector<Vec3> ExtremeDirections(unsigned count);
+
+	// Akl-Toussaint pre-filter
+	// the extreme points along directionCount directions span a polytope inside the hull,
+	// points more than tolerance inside every face of it can not be hull vertices and are culled.
+	// keptIndices receives the other points in input order.
+	// return : false if the polytope is degenerate (nothing is culled then)
+	bool CullInteriorPoints(const PointsView& points, unsigned directionCount, float tolerance, unsigned workerCount, std::vector<uint32_t>& keptIndices);
+}
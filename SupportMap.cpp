@@ -0,0 +1,168 @@
+#include "SupportMap.hpp"
+
+#include "CubeMap.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HULL_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace hull
+{
+
+namespace
+{
+    // cells per cube map side of the cold start vertices
+    constexpr int START_RESOLUTION = 8;
+}
+
+void SupportMap::Build(const Hull& hull)
+{
+    this->Clear();
+
+    size_t vertexCount = hull.vertices.size();
+    this->vertices = hull.vertices;
+    if (vertexCount == 0) return;
+
+    if (vertexCount <= BRUTE_FORCE_VERTICES)
+    {
+        size_t padded = (vertexCount + 3) & ~size_t(3);
+        this->x.assign(padded, hull.vertices[0].x);
+        this->y.assign(padded, hull.vertices[0].y);
+        this->z.assign(padded, hull.vertices[0].z);
+        for (size_t i = 0; i < vertexCount; ++i)
+        {
+            this->x[i] = hull.vertices[i].x;
+            this->y[i] = hull.vertices[i].y;
+            this->z[i] = hull.vertices[i].z;
+        }
+        return;
+    }
+
+    // edge a -> b of each face makes b a neighbour of a (its twin b -> a the other way round)
+    this->neighbourStarts.assign(vertexCount + 1, 0);
+    for (size_t edge = 0; edge < hull.indices.size(); ++edge) ++this->neighbourStarts[hull.indices[edge] + 1];
+    for (size_t v = 0; v < vertexCount; ++v) this->neighbourStarts[v + 1] += this->neighbourStarts[v];
+
+    this->neighbours.resize(hull.indices.size());
+    std::vector<uint32_t> fill(this->neighbourStarts.begin(), this->neighbourStarts.end() - 1);
+    for (size_t edge = 0; edge < hull.indices.size(); ++edge)
+    {
+        uint32_t to = hull.indices[edge % 3 == 2 ? edge - 2 : edge + 1];
+        this->neighbours[fill[hull.indices[edge]]++] = to;
+    }
+
+    // neighbouring cells have close support vertices : climb each from the previous one
+    this->startVertices.resize(6 * START_RESOLUTION * START_RESOLUTION);
+    uint32_t previous = 0;
+    for (size_t cell = 0; cell < this->startVertices.size(); ++cell)
+    {
+        previous = this->Climb(CubeMapDirection(cell, START_RESOLUTION), previous);
+        this->startVertices[cell] = previous;
+    }
+}
+
+void SupportMap::Clear()
+{
+    this->vertices.clear();
+    this->x.clear();
+    this->y.clear();
+    this->z.clear();
+    this->neighbourStarts.clear();
+    this->neighbours.clear();
+    this->startVertices.clear();
+}
+
+uint32_t SupportMap::Support(const Vec3& direction, uint32_t& start) const
+{
+    if (this->vertices.empty()) return start = NO_START;
+
+    if (this->vertices.size() <= BRUTE_FORCE_VERTICES) return start = this->BruteForce(direction);
+
+    if (start >= this->vertices.size()) start = this->startVertices[CubeMapCell(direction, START_RESOLUTION)];
+    return start = this->Climb(direction, start);
+}
+
+void SupportMap::Support(const Vec3* directions, size_t count, uint32_t* results, uint32_t& start) const
+{
+    for (size_t i = 0; i < count; ++i) results[i] = this->Support(directions[i], start);
+}
+
+// steepest ascent over the vertex graph : on a convex polytope a vertex no neighbour improves on is the global maximum
+uint32_t SupportMap::Climb(const Vec3& direction, uint32_t start) const
+{
+    const Vec3* vertices = this->vertices.data();
+    const uint32_t* starts = this->neighbourStarts.data();
+    const uint32_t* neighbours = this->neighbours.data();
+
+    uint32_t current = start;
+    float best = Dot(direction, vertices[current]);
+    for (;;)
+    {
+        uint32_t next = current;
+        for (uint32_t i = starts[current], end = starts[current + 1]; i < end; ++i)
+        {
+            float distance = Dot(direction, vertices[neighbours[i]]);
+            if (distance > best)
+            {
+                best = distance;
+                next = neighbours[i];
+            }
+        }
+
+        // strict increase : ends on flat regions and nan directions
+        if (next == current) return current;
+        current = next;
+    }
+}
+
+// first vertex with the largest dot product : one pass for the maximum, one for its lane (no branches on the data)
+uint32_t SupportMap::BruteForce(const Vec3& direction) const
+{
+    const float* x = this->x.data();
+    const float* y = this->y.data();
+    const float* z = this->z.data();
+    size_t count = this->x.size();
+
+#if defined(HULL_SSE2)
+    const __m128 dx = _mm_set1_ps(direction.x);
+    const __m128 dy = _mm_set1_ps(direction.y);
+    const __m128 dz = _mm_set1_ps(direction.z);
+    auto Dots = [&](size_t i)
+    {
+        __m128 d = _mm_add_ps(_mm_mul_ps(dx, _mm_loadu_ps(x + i)), _mm_mul_ps(dy, _mm_loadu_ps(y + i)));
+        return _mm_add_ps(d, _mm_mul_ps(dz, _mm_loadu_ps(z + i)));
+    };
+
+    __m128 best = Dots(0);
+    for (size_t i = 4; i < count; i += 4) best = _mm_max_ps(best, Dots(i));
+    best = _mm_max_ps(best, _mm_shuffle_ps(best, best, _MM_SHUFFLE(1, 0, 3, 2)));
+    best = _mm_max_ps(best, _mm_shuffle_ps(best, best, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    for (size_t i = 0; i < count; i += 4)
+    {
+        int mask = _mm_movemask_ps(_mm_cmpeq_ps(Dots(i), best));
+        if (mask != 0) return static_cast<uint32_t>(i + std::countr_zero(static_cast<unsigned>(mask)));
+    }
+    return 0;
+#else
+    uint32_t best = 0;
+    float bestDistance = Dot(direction, { x[0], y[0], z[0] });
+    for (size_t i = 1; i < count; ++i)
+    {
+        float distance = Dot(direction, { x[i], y[i], z[i] });
+        if (distance > bestDistance)
+        {
+            bestDistance = distance;
+            best = static_cast<uint32_t>(i);
+        }
+    }
+    return best;
+#endif
+}
+
+}
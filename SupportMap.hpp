@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "HullCore.hpp"
+#include "Vec3.hpp"
+
+namespace hull
+{
+	// support function of a built hull (gjk, mpr) : furthest vertex along a direction
+	class SupportMap
+	{
+	public:
+		// start value of a query cache : no previous result
+		static constexpr uint32_t NO_START = ~0u;
+
+		// hulls up to this many vertices are searched by the simd kernel instead of hill-climbing
+		static constexpr size_t BRUTE_FORCE_VERTICES = 32;
+
+		SupportMap() = default;
+		explicit SupportMap(const Hull& hull) { this->Build(hull); }
+
+		// copy the vertices of hull and gather the neighbours of each vertex from its edges
+		void Build(const Hull& hull);
+
+		void Clear();
+
+		size_t VertexCount() const { return this->vertices.size(); }
+		const Vec3& Vertex(uint32_t index) const { return this->vertices[index]; }
+
+		// return : index of a vertex with the largest Dot(direction, v) (within the build tolerance of the hull), NO_START if empty
+		// start : vertex the hill-climb starts from (NO_START : the support vertex of the direction cell of direction), receives the result,
+		// keep one start per caller and shape so coherent queries (successive gjk iterations, frames) take few steps
+		uint32_t Support(const Vec3& direction, uint32_t& start) const;
+
+		Vec3 SupportPoint(const Vec3& direction, uint32_t& start) const
+		{
+			return this->vertices[this->Support(direction, start)];
+		}
+
+		// results[i] = Support(directions[i], start), each query starts from the previous result
+		void Support(const Vec3* directions, size_t count, uint32_t* results, uint32_t& start) const;
+
+	private:
+		uint32_t Climb(const Vec3& direction, uint32_t start) const;
+		uint32_t BruteForce(const Vec3& direction) const;
+
+		std::vector<Vec3> vertices;
+
+		// soa copy of vertices for the brute force kernel (tiny hulls only), padded to a multiple of 4 with copies of the first vertex
+		std::vector<float> x, y, z;
+
+		// neighbours of vertex v : neighbours[neighbourStarts[v] .. neighbourStarts[v + 1])
+		std::vector<uint32_t> neighbourStarts;
+		std::vector<uint32_t> neighbours;
+
+		// support vertex of the center of each direction cell (cube map), start of cold queries
+		std::vector<uint32_t> startVertices;
+	};
+}
@@ -0,0 +1,158 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+#include "Parallel.hpp"
+
+namespace hull
+{
+
+namespace
+{
+    // pool and worker index of the calling thread
+    thread_local ThreadPool* currentPool = nullptr;
+    thread_local unsigned currentWorker = 0;
+}
+
+ThreadPool::ThreadPool(unsigned threadCount)
+    : queues(), threads(), queuedCount(0), nextQueue(0), sleepMutex(), wake(), stopping(false)
+{
+    // at least one queue so tasks can be queued without workers
+    for (unsigned i = 0; i < std::max(threadCount, 1u); ++i)
+    {
+        this->queues.push_back(std::make_unique<Queue>());
+    }
+
+    this->threads.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i)
+    {
+        this->threads.emplace_back(&ThreadPool::WorkerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->sleepMutex);
+        this->stopping = true;
+    }
+    this->wake.notify_all();
+
+    for (std::thread& thread : this->threads) thread.join();
+}
+
+void ThreadPool::Submit(Task task)
+{
+    unsigned worker = this->CurrentWorker();
+    unsigned queue = worker < this->queues.size() ? worker : this->nextQueue.fetch_add(1, std::memory_order_relaxed) % this->queues.size();
+    {
+        std::lock_guard<std::mutex> lock(this->queues[queue]->mutex);
+        this->queues[queue]->tasks.push_back(std::move(task));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->sleepMutex);
+        this->queuedCount.fetch_add(1);
+    }
+    this->wake.notify_one();
+}
+
+bool ThreadPool::RunOne()
+{
+    unsigned worker = this->CurrentWorker();
+    unsigned home = worker < this->queues.size() ? worker : 0;
+
+    Task task;
+    if (!this->TryPop(home, task) && !this->TrySteal(home, task)) return false;
+
+    task();
+    return true;
+}
+
+void ThreadPool::WorkerLoop(unsigned worker)
+{
+    currentPool = this;
+    currentWorker = worker;
+
+    Task task;
+    for (;;)
+    {
+        if (this->TryPop(worker, task) || this->TrySteal(worker, task))
+        {
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(this->sleepMutex);
+        this->wake.wait(lock, [this]() { return this->stopping || this->queuedCount.load() > 0; });
+        if (this->stopping && this->queuedCount.load() == 0) return;
+    }
+}
+
+bool ThreadPool::TryPop(unsigned queue, Task& task)
+{
+    Queue& own = *this->queues[queue];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (own.tasks.empty()) return false;
+
+    task = std::move(own.tasks.back());
+    own.tasks.pop_back();
+    this->queuedCount.fetch_sub(1);
+    return true;
+}
+
+bool ThreadPool::TrySteal(unsigned queue, Task& task)
+{
+    for (size_t i = 1; i < this->queues.size(); ++i)
+    {
+        Queue& victim = *this->queues[(queue + i) % this->queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.tasks.empty()) continue;
+
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        this->queuedCount.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+ThreadPool* ThreadPool::Current()
+{
+    return currentPool;
+}
+
+unsigned ThreadPool::CurrentWorker() const
+{
+    return currentPool == this ? currentWorker : static_cast<unsigned>(this->queues.size());
+}
+
+///////////////////////////////////////////////////////////
+
+void TaskGroup::Run(std::function<void()> func)
+{
+    this->remaining.fetch_add(1);
+    this->pool.Submit([this, func = std::move(func)]()
+    {
+        func();
+        this->remaining.fetch_sub(1, std::memory_order_release);
+    });
+}
+
+void TaskGroup::Wait()
+{
+    while (this->remaining.load(std::memory_order_acquire) > 0)
+    {
+        // help instead of blocking, so nested groups on worker threads cannot deadlock
+        if (!this->pool.RunOne()) std::this_thread::yield();
+    }
+}
+
+ThreadPool& SharedHullPool()
+{
+    static ThreadPool pool(ResolveThreadCount(0));
+    return pool;
+}
+
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hull
+{
+	// fixed-size work-stealing thread pool
+	//
+	// each worker owns a task deque : tasks submitted from a worker go to its own deque and are taken back LIFO,
+	// idle workers steal the oldest task of another deque. tasks submitted from outside are spread round-robin.
+	class ThreadPool
+	{
+	public:
+		using Task = std::function<void()>;
+
+		// threadCount workers (0 is allowed : tasks then only run in TaskGroup::Wait of the caller)
+		explicit ThreadPool(unsigned threadCount);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		unsigned ThreadCount() const { return static_cast<unsigned>(this->threads.size()); }
+
+		// pool of the calling worker thread (nullptr if not a pool worker)
+		static ThreadPool* Current();
+
+		void Submit(Task task);
+
+		// run one queued task on the calling thread (own deque first, then steal)
+		// return : false if no task was found
+		bool RunOne();
+
+	private:
+		struct Queue
+		{
+			std::mutex mutex;
+			std::deque<Task> tasks;
+		};
+
+		void WorkerLoop(unsigned worker);
+		bool TryPop(unsigned queue, Task& task);
+		bool TrySteal(unsigned queue, Task& task);
+
+		// worker index of the calling thread in this pool (queue count if not a worker)
+		unsigned CurrentWorker() const;
+
+	private:
+		std::vector<std::unique_ptr<Queue>> queues;
+		std::vector<std::thread> threads;
+
+		// queued tasks not taken yet, workers sleep while zero
+		std::atomic<size_t> queuedCount;
+		std::atomic<unsigned> nextQueue;
+
+		std::mutex sleepMutex;
+		std::condition_variable wake;
+		bool stopping;
+	};
+
+	// fork / join set of tasks on a pool
+	class TaskGroup
+	{
+	public:
+		explicit TaskGroup(ThreadPool& pool_) : pool(pool_), remaining(0) {}
+		~TaskGroup() { this->Wait(); }
+
+		TaskGroup(const TaskGroup&) = delete;
+		TaskGroup& operator=(const TaskGroup&) = delete;
+
+		void Run(std::function<void()> func);
+
+		// run queued tasks on the calling thread until every task of the group is done
+		void Wait();
+
+	private:
+		ThreadPool& pool;
+		std::atomic<size_t> remaining;
+	};
+
+	// process-wide pool for hull builds and the point passes, one worker per hardware thread (created on first use)
+	ThreadPool& SharedHullPool();
+}
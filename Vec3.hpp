@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cmath>
+
+namespace hull
+{
+	// plain float3 (layout compatible with D3DXVECTOR3)
+	struct Vec3
+	{
+		float x, y, z;
+
+		Vec3 operator + (const Vec3& v) const { return { x + v.x, y + v.y, z + v.z }; }
+		Vec3 operator - (const Vec3& v) const { return { x - v.x, y - v.y, z - v.z }; }
+		Vec3 operator * (float s) const { return { x * s, y * s, z * s }; }
+		Vec3 operator / (float s) const { return { x / s, y / s, z / s }; }
+		Vec3 operator - () const { return { -x, -y, -z }; }
+
+		Vec3& operator += (const Vec3& v) { x += v.x; y += v.y; z += v.z; return *this; }
+		Vec3& operator -= (const Vec3& v) { x -= v.x; y -= v.y; z -= v.z; return *this; }
+		Vec3& operator *= (float s) { x *= s; y *= s; z *= s; return *this; }
+
+		bool operator == (const Vec3& v) const { return x == v.x && y == v.y && z == v.z; }
+		bool operator != (const Vec3& v) const { return !(*this == v); }
+	};
+
+	inline float Dot(const Vec3& a, const Vec3& b)
+	{
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+
+	inline Vec3 Cross(const Vec3& a, const Vec3& b)
+	{
+		return
+		{
+			a.y * b.z - a.z * b.y,
+			a.z * b.x - a.x * b.z,
+			a.x * b.y - a.y * b.x
+		};
+	}
+
+	inline float LengthSq(const Vec3& v)
+	{
+		return Dot(v, v);
+	}
+
+	inline float Length(const Vec3& v)
+	{
+		return std::sqrt(LengthSq(v));
+	}
+
+	// return zero vector when length is zero
+	inline Vec3 Normalize(const Vec3& v)
+	{
+		float len = Length(v);
+		if (len == 0) return { 0, 0, 0 };
+		return v / len;
+	}
+
+	// plane : Distance(p) = Dot(normal, p) - offset (positive on the normal side)
+	struct Plane
+	{
+		Vec3 normal;
+		float offset;
+
+		float Distance(const Vec3& point) const
+		{
+			return Dot(this->normal, point) - this->offset;
+		}
+
+		// normal = normalize((b - a) x (c - a))
+		static Plane FromTriangle(const Vec3& a, const Vec3& b, const Vec3& c)
+		{
+			Vec3 normal = Normalize(Cross(b - a, c - a));
+			return { normal, Dot(normal, a) };
+		}
+	};
+
+	// return : point of triangle (a, b, c) closest to p (voronoi regions of the vertices, edges and face)
+	// corners : corners spanning the feature the point lies on (bit 0 : a, bit 1 : b, bit 2 : c, all three : the face)
+	inline Vec3 ClosestPointOnTriangle(const Vec3& p, const Vec3& a, const Vec3& b, const Vec3& c, unsigned& corners)
+	{
+		Vec3 ab = b - a;
+		Vec3 ac = c - a;
+		Vec3 ap = p - a;
+		float d1 = Dot(ab, ap);
+		float d2 = Dot(ac, ap);
+		corners = 1;
+		if (d1 <= 0 && d2 <= 0) return a;
+
+		Vec3 bp = p - b;
+		float d3 = Dot(ab, bp);
+		float d4 = Dot(ac, bp);
+		corners = 2;
+		if (d3 >= 0 && d4 <= d3) return b;
+
+		float vc = d1 * d4 - d3 * d2;
+		corners = 3;
+		if (vc <= 0 && d1 >= 0 && d3 <= 0) return a + ab * (d1 / (d1 - d3));
+
+		Vec3 cp = p - c;
+		float d5 = Dot(ab, cp);
+		float d6 = Dot(ac, cp);
+		corners = 4;
+		if (d6 >= 0 && d5 <= d6) return c;
+
+		float vb = d5 * d2 - d1 * d6;
+		corners = 5;
+		if (vb <= 0 && d2 >= 0 && d6 <= 0) return a + ac * (d2 / (d2 - d6));
+
+		float va = d3 * d6 - d5 * d4;
+		corners = 6;
+		if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+		corners = 7;
+		float denominator = 1 / (va + vb + vc);
+		return a + ab * (vb * denominator) + ac * (vc * denominator);
+	}
+
+	inline Vec3 ClosestPointOnTriangle(const Vec3& p, const Vec3& a, const Vec3& b, const Vec3& c)
+	{
+		unsigned corners;
+		return ClosestPointOnTriangle(p, a, b, c, corners);
+	}
+}
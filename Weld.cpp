@@ -0,0 +1,379 @@
+#include "Weld.hpp"
+
+#include "Parallel.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+
+namespace hull
+{
+
+namespace
+{
+    constexpr uint32_t NONE = ~0u;
+
+    struct Bounds
+    {
+        Vec3 lower;
+        Vec3 upper;
+    };
+
+    // point index + key of its grid cell, sorted by cell then input order
+    struct CellEntry
+    {
+        uint64_t key;
+        uint32_t index;
+
+        bool operator < (const CellEntry& other) const
+        {
+            return this->key != other.key ? this->key < other.key : this->index < other.index;
+        }
+    };
+
+    // uniform grid over the bounds
+    class Grid
+    {
+    public:
+        // about one point per cell, cells at least 2 * tolerance wide (the tolerance ball of a point spans at most 2 cells per axis)
+        Grid(const Bounds& bounds, size_t count, float tolerance)
+            : lower{ bounds.lower.x, bounds.lower.y, bounds.lower.z }, cellSize(1), inverseCellSize(1), dims{ 1, 1, 1 }
+        {
+            const double size[3] = { double(bounds.upper.x) - bounds.lower.x, double(bounds.upper.y) - bounds.lower.y, double(bounds.upper.z) - bounds.lower.z };
+            const double extent = std::max({ size[0], size[1], size[2] });
+
+            auto cellCount = [&size](double cell)
+            {
+                double cells = 1;
+                for (int axis = 0; axis < 3; ++axis) cells *= std::max(1.0, std::ceil(size[axis] / cell));
+                return cells;
+            };
+
+            // flat or thin clouds fill fewer cells than the cube root guess, shrink the cells until they are about as many as the points
+            if (extent > 0 && std::isfinite(extent))
+            {
+                this->cellSize = extent / std::cbrt(double(count));
+                for (int step = 0; step < 64 && cellCount(this->cellSize) > 2.0 * count; ++step) this->cellSize *= 1.25;
+                for (int step = 0; step < 64 && cellCount(this->cellSize / 1.25) <= 2.0 * count; ++step) this->cellSize /= 1.25;
+            }
+            this->cellSize = std::max(this->cellSize, 2.0 * tolerance);
+            this->inverseCellSize = 1 / this->cellSize;
+
+            // non finite bounds : a single cell
+            for (int axis = 0; axis < 3 && std::isfinite(extent); ++axis)
+            {
+                this->dims[axis] = std::max<uint64_t>(1, static_cast<uint64_t>(std::min(std::ceil(size[axis] / this->cellSize), 1e6)));
+            }
+        }
+
+        // cell coordinate along axis, clamped to the grid
+        uint64_t Coordinate(double value, int axis) const
+        {
+            double cell = std::floor((value - this->lower[axis]) * this->inverseCellSize);
+            if (!(cell > 0)) return 0;
+            return std::min(static_cast<uint64_t>(std::min(cell, 1e18)), this->dims[axis] - 1);
+        }
+
+        uint64_t Key(uint64_t x, uint64_t y, uint64_t z) const
+        {
+            return (x * this->dims[1] + y) * this->dims[2] + z;
+        }
+
+        uint64_t Key(const Vec3& point) const
+        {
+            return this->Key(this->Coordinate(point.x, 0), this->Coordinate(point.y, 1), this->Coordinate(point.z, 2));
+        }
+
+        uint64_t KeyCount() const { return this->dims[0] * this->dims[1] * this->dims[2]; }
+
+        // rows : cells of the same x, y (consecutive keys)
+        uint64_t Row(uint64_t x, uint64_t y) const { return x * this->dims[1] + y; }
+        uint64_t RowOf(uint64_t key) const { return key / this->dims[2]; }
+        uint64_t RowCount() const { return this->dims[0] * this->dims[1]; }
+
+    private:
+        double lower[3];
+        double cellSize;
+        double inverseCellSize;
+        uint64_t dims[3];
+    };
+
+    // stable lsd radix sort by key (keys below keyCount), the digit counts and the scatter of each pass on worker threads
+    void SortByKey(std::vector<CellEntry>& entries, uint64_t keyCount, size_t chunkCount)
+    {
+        constexpr int DIGIT_BITS = 11;
+        constexpr size_t DIGITS = size_t(1) << DIGIT_BITS;
+
+        const size_t count = entries.size();
+        std::vector<CellEntry> buffer(count);
+        std::vector<size_t> offsets(chunkCount * DIGITS);
+        for (int shift = 0; shift < 64 && ((keyCount - 1) >> shift) != 0; shift += DIGIT_BITS)
+        {
+            ParallelChunks(count, chunkCount, [&](size_t chunk, size_t begin, size_t end)
+            {
+                size_t* counts = &offsets[chunk * DIGITS];
+                std::fill(counts, counts + DIGITS, 0);
+                for (size_t i = begin; i < end; ++i) ++counts[(entries[i].key >> shift) & (DIGITS - 1)];
+            });
+
+            // digit major, chunk minor : equal digits keep their order
+            size_t total = 0;
+            for (size_t digit = 0; digit < DIGITS; ++digit)
+            {
+                for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+                {
+                    size_t digitCount = offsets[chunk * DIGITS + digit];
+                    offsets[chunk * DIGITS + digit] = total;
+                    total += digitCount;
+                }
+            }
+
+            ParallelChunks(count, chunkCount, [&](size_t chunk, size_t begin, size_t end)
+            {
+                size_t* offset = &offsets[chunk * DIGITS];
+                for (size_t i = begin; i < end; ++i) buffer[offset[(entries[i].key >> shift) & (DIGITS - 1)]++] = entries[i];
+            });
+            entries.swap(buffer);
+        }
+    }
+}
+
+bool WeldPoints(const PointsView& points, float tolerance, unsigned threadCount, WeldResult& result)
+{
+    result.points.clear();
+    result.sources.clear();
+    result.remap.clear();
+
+    const size_t count = points.count;
+    if (count == 0) return true;
+    if (count > std::numeric_limits<uint32_t>::max()) return false;
+
+    tolerance = std::max(tolerance, 0.0f);
+    const unsigned workerCount = ResolveThreadCount(threadCount);
+    const size_t chunkCount = ChunkCount(count, workerCount, MIN_PARALLEL_POINTS);
+
+    Bounds bounds = ParallelReduce<Bounds>(count, chunkCount,
+        [&points](size_t begin, size_t end)
+        {
+            Bounds partial = { { FLT_MAX, FLT_MAX, FLT_MAX }, { -FLT_MAX, -FLT_MAX, -FLT_MAX } };
+            for (size_t i = begin; i < end; ++i)
+            {
+                Vec3 point = points[i];
+                partial.lower = { std::min(partial.lower.x, point.x), std::min(partial.lower.y, point.y), std::min(partial.lower.z, point.z) };
+                partial.upper = { std::max(partial.upper.x, point.x), std::max(partial.upper.y, point.y), std::max(partial.upper.z, point.z) };
+            }
+            return partial;
+        },
+        [](Bounds& bounds, const Bounds& partial)
+        {
+            bounds.lower = { std::min(bounds.lower.x, partial.lower.x), std::min(bounds.lower.y, partial.lower.y), std::min(bounds.lower.z, partial.lower.z) };
+            bounds.upper = { std::max(bounds.upper.x, partial.upper.x), std::max(bounds.upper.y, partial.upper.y), std::max(bounds.upper.z, partial.upper.z) };
+        });
+    if (!(bounds.lower.x <= bounds.upper.x)) bounds = {};
+
+    const Grid grid(bounds, count, tolerance);
+
+    // points sorted by cell, input order inside a cell
+    std::vector<CellEntry> entries(count);
+    ParallelChunks(count, chunkCount, [&](size_t, size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i) entries[i] = { grid.Key(points[i]), static_cast<uint32_t>(i) };
+    });
+    SortByKey(entries, grid.KeyCount(), chunkCount);
+
+    // positions in entry order : the passes below read them sequentially
+    std::vector<Vec3> sorted(count);
+    ParallelChunks(count, chunkCount, [&](size_t, size_t begin, size_t end)
+    {
+        for (size_t e = begin; e < end; ++e) sorted[e] = points[entries[e].index];
+    });
+
+    // first entry of each row
+    const uint64_t rowCount = grid.RowCount();
+    std::vector<uint32_t> rowStart(rowCount + 1);
+    ParallelChunks(count, chunkCount, [&](size_t, size_t begin, size_t end)
+    {
+        for (size_t e = begin; e < end; ++e)
+        {
+            uint64_t row = grid.RowOf(entries[e].key);
+            for (uint64_t r = e > 0 ? grid.RowOf(entries[e - 1].key) + 1 : 0; r <= row; ++r) rowStart[r] = static_cast<uint32_t>(e);
+        }
+        if (end == count)
+        {
+            for (uint64_t r = grid.RowOf(entries[count - 1].key) + 1; r <= rowCount; ++r) rowStart[r] = static_cast<uint32_t>(count);
+        }
+    });
+
+    // return : first entry of the cell, NONE if the cell is empty
+    auto findCell = [&](uint64_t x, uint64_t y, uint64_t z)
+    {
+        const uint64_t row = grid.Row(x, y);
+        const uint64_t key = grid.Key(x, y, z);
+        auto last = entries.begin() + rowStart[row + 1];
+        auto it = std::lower_bound(entries.begin() + rowStart[row], last, CellEntry{ key, 0 });
+        return it != last && it->key == key ? static_cast<uint32_t>(it - entries.begin()) : NONE;
+    };
+
+    const float toleranceSq = tolerance * tolerance;
+    auto within = [tolerance, toleranceSq](const Vec3& a, const Vec3& b)
+    {
+        return tolerance > 0 ? LengthSq(a - b) <= toleranceSq : a == b;
+    };
+
+    // slightly wider than the tolerance : a rounding error in the cell search must not hide a neighbour
+    const double reach = tolerance > 0 ? double(tolerance) * (1 + 1e-6) : 0;
+
+    // cells covered by the tolerance ball of point along each axis
+    // return : true if that is the cell of the point only
+    auto window = [&grid, reach](const Vec3& point, uint64_t* low, uint64_t* high)
+    {
+        const double coordinates[3] = { point.x, point.y, point.z };
+        bool single = true;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            low[axis] = grid.Coordinate(coordinates[axis] - reach, axis);
+            high[axis] = grid.Coordinate(coordinates[axis] + reach, axis);
+            single = single && low[axis] == high[axis];
+        }
+        return single;
+    };
+
+    // a cell is named by its first entry, the entries of its kept points are linked from head in input order
+    std::vector<uint32_t> head(count, NONE);
+    std::vector<uint32_t> next(count, NONE);
+
+    // input index of the kept point each point joined (itself when kept)
+    std::vector<uint32_t> kept(count);
+
+    // return : input index of the first kept point of the cell within tolerance, if before best
+    auto firstKept = [&](uint32_t cell, const Vec3& point, uint32_t best)
+    {
+        for (uint32_t e = head[cell]; e != NONE && entries[e].index < best; e = next[e])
+        {
+            if (within(sorted[e], point)) return entries[e].index;
+        }
+        return best;
+    };
+
+    auto join = [&](uint32_t cell, uint32_t e, uint32_t best)
+    {
+        const uint32_t index = entries[e].index;
+        if (best != NONE)
+        {
+            kept[index] = best;
+            return;
+        }
+
+        kept[index] = index;
+        uint32_t* link = &head[cell];
+        while (*link != NONE) link = &next[*link];
+        *link = e;
+    };
+
+    // cells where every tolerance ball stays inside the cell do not interact with any other point :
+    // they are welded on the worker threads, the entries of the other cells are left for the pass in input order
+    struct Pending
+    {
+        uint32_t index;
+        uint32_t entry;
+        uint32_t cell;
+    };
+    std::vector<std::vector<Pending>> pending(chunkCount);
+    ParallelChunks(count, chunkCount, [&](size_t chunk, size_t begin, size_t end)
+    {
+        uint64_t low[3];
+        uint64_t high[3];
+
+        // cells starting in [begin, end)
+        size_t first = begin;
+        while (first < end && first > 0 && entries[first].key == entries[first - 1].key) ++first;
+        while (first < end)
+        {
+            size_t last = first;
+            bool isolated = true;
+            for (; last < count && entries[last].key == entries[first].key; ++last)
+            {
+                isolated = isolated && window(sorted[last], low, high);
+            }
+
+            const uint32_t cell = static_cast<uint32_t>(first);
+            for (size_t e = first; e < last; ++e)
+            {
+                if (isolated) join(cell, static_cast<uint32_t>(e), firstKept(cell, sorted[e], NONE));
+                else pending[chunk].push_back({ entries[e].index, static_cast<uint32_t>(e), cell });
+            }
+            first = last;
+        }
+    });
+
+    std::vector<Pending> ordered;
+    for (std::vector<Pending>& part : pending) ordered.insert(ordered.end(), part.begin(), part.end());
+    std::sort(ordered.begin(), ordered.end(), [](const Pending& a, const Pending& b) { return a.index < b.index; });
+
+    // greedy pass in input order over the points near a cell boundary (and the points sharing a cell with them)
+    for (const Pending& entry : ordered)
+    {
+        const Vec3 point = sorted[entry.entry];
+
+        uint64_t low[3];
+        uint64_t high[3];
+        uint32_t best = NONE;
+        if (window(point, low, high))
+        {
+            best = firstKept(entry.cell, point, best);
+        }
+        else
+        {
+            for (uint64_t x = low[0]; x <= high[0]; ++x)
+            {
+                for (uint64_t y = low[1]; y <= high[1]; ++y)
+                {
+                    for (uint64_t z = low[2]; z <= high[2]; ++z)
+                    {
+                        uint32_t cell = findCell(x, y, z);
+                        if (cell != NONE) best = firstKept(cell, point, best);
+                    }
+                }
+            }
+        }
+        join(entry.cell, entry.entry, best);
+    }
+
+    // welded points in input order
+    std::vector<size_t> offsets(chunkCount + 1, 0);
+    ParallelChunks(count, chunkCount, [&](size_t chunk, size_t begin, size_t end)
+    {
+        size_t keptCount = 0;
+        for (size_t i = begin; i < end; ++i) keptCount += kept[i] == i;
+        offsets[chunk + 1] = keptCount;
+    });
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk) offsets[chunk + 1] += offsets[chunk];
+
+    result.points.resize(offsets[chunkCount]);
+    result.sources.resize(offsets[chunkCount]);
+    result.remap.resize(count);
+    ParallelChunks(count, chunkCount, [&](size_t chunk, size_t begin, size_t end)
+    {
+        size_t welded = offsets[chunk];
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (kept[i] != i) continue;
+            result.points[welded] = points[i];
+            result.sources[welded] = static_cast<uint32_t>(i);
+            result.remap[i] = static_cast<uint32_t>(welded++);
+        }
+    });
+    ParallelChunks(count, chunkCount, [&](size_t, size_t begin, size_t end)
+    {
+        // kept points already hold their own index, other chunks read them
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (kept[i] != i) result.remap[i] = result.remap[kept[i]];
+        }
+    });
+
+    return true;
+}
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "PointsView.hpp"
+#include "Vec3.hpp"
+
+namespace hull
+{
+	// points left after welding, with the tables back to the input
+	struct WeldResult
+	{
+		// one point per cluster, in input order
+		std::vector<Vec3> points;
+
+		// input index of each welded point (first occurrence of its cluster)
+		std::vector<uint32_t> sources;
+
+		// welded index of each input point
+		std::vector<uint32_t> remap;
+	};
+
+	// merge near duplicate points
+	// greedy in input order : a point joins the first kept point within tolerance (|p - q| <= tolerance), otherwise it is kept.
+	// tolerance 0 merges exact duplicates only. candidates are found in a uniform grid (points radix sorted by cell) built on worker threads,
+	// cells out of reach of any other cell are welded concurrently. the result does not depend on threadCount (0 : one per hardware thread).
+	// return : false if there are more than 2^32 - 1 points (result is left empty)
+	bool WeldPoints(const PointsView& points, float tolerance, unsigned threadCount, WeldResult& result);
+}
@@ -9,6 +9,7 @@
 #include "DX9.hpp"
 #include "LineSegment.hpp"
 #include "ConvexHull.hpp"
+#include "HullCache.hpp"
 #include "Camera.hpp"
 #include "Point.hpp"
 
@@ -119,7 +120,8 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
     // create teapot mesh's convexHull
     IDirect3DVertexBuffer9* vertexBuff;
     teapotMesh->GetVertexBuffer(&vertexBuff);
-    auto convexHull = std::make_unique<ConvexHull>(vertexBuff);
+    hull::HullCache hullCache("hull_cache");
+    auto convexHull = std::make_unique<ConvexHull>(vertexBuff, &hullCache);
 
     // point
     auto point = std::make_unique<Point>();